@@ -195,6 +195,24 @@ public:
     ~xScopedStackFrame();
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// While in scope, memory operands given as an absolute address within [begin, end) are
+// emitted relative to reg instead, and the generated code must keep reg set to base.  This
+// lets a recompiler address its register file through a pinned register: base can be put
+// so the hottest fields get 8 bit displacements, and x86-64 can reach data anywhere in
+// the address space.  Scopes nest; a scope with an empty range emits absolute addresses.
+class xScopedBaseRegister
+{
+    int m_prevId;
+    uptr m_prevBase;
+    uptr m_prevBegin;
+    uptr m_prevEnd;
+
+public:
+    xScopedBaseRegister(const xAddressReg &reg, const void *base, const void *begin, const void *end);
+    ~xScopedBaseRegister();
+};
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // JMP / Jcc Instructions!
 
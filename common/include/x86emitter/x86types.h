@@ -681,12 +681,13 @@ public:
 
     xAddressVoid &Add(const xAddressReg &src);
     xAddressVoid &Add(const xAddressVoid &src);
+    xAddressVoid &Add(const void *addr);
 
     __fi xAddressVoid operator+(const xAddressReg &right) const { return xAddressVoid(*this).Add(right); }
     __fi xAddressVoid operator+(const xAddressVoid &right) const { return xAddressVoid(*this).Add(right); }
     __fi xAddressVoid operator+(s32 imm) const { return xAddressVoid(*this).Add(imm); }
     __fi xAddressVoid operator-(s32 imm) const { return xAddressVoid(*this).Add(-imm); }
-    __fi xAddressVoid operator+(const void *addr) const { return xAddressVoid(*this).Add((uptr)addr); }
+    __fi xAddressVoid operator+(const void *addr) const { return xAddressVoid(*this).Add(addr); }
 
     __fi void operator+=(const xAddressReg &right) { Add(right); }
     __fi void operator+=(s32 imm) { Add(imm); }
@@ -744,12 +745,17 @@ public:
         _parent::Add(src);
         return *this;
     }
+    xAddressInfo<BaseType> &Add(const void *addr)
+    {
+        _parent::Add(addr);
+        return *this;
+    }
 
     __fi xAddressInfo<BaseType> operator+(const xAddressReg &right) const { return xAddressInfo(*this).Add(right); }
     __fi xAddressInfo<BaseType> operator+(const xAddressInfo<BaseType> &right) const { return xAddressInfo(*this).Add(right); }
     __fi xAddressInfo<BaseType> operator+(s32 imm) const { return xAddressInfo(*this).Add(imm); }
     __fi xAddressInfo<BaseType> operator-(s32 imm) const { return xAddressInfo(*this).Add(-imm); }
-    __fi xAddressInfo<BaseType> operator+(const void *addr) const { return xAddressInfo(*this).Add((uptr)addr); }
+    __fi xAddressInfo<BaseType> operator+(const void *addr) const { return xAddressInfo(*this).Add(addr); }
 
     __fi void operator+=(const xAddressInfo<BaseType> &right) { Add(right); }
 };
@@ -988,7 +994,7 @@ public:
 
     xModSibType operator[](const void *src) const
     {
-        return xModSibType((uptr)src);
+        return (*this)[xAddressVoid(src)];
     }
 };
 
@@ -1162,7 +1168,7 @@ public:
 
 static __fi xAddressVoid operator+(const void *addr, const xAddressReg &reg)
 {
-    return reg + (sptr)addr;
+    return reg + addr;
 }
 
 static __fi xAddressVoid operator+(s32 addr, const xAddressReg &reg)
@@ -73,6 +73,12 @@ template void xWrite<u32>(u32 val);
 template void xWrite<u64>(u64 val);
 template void xWrite<u128>(u128 val);
 
+// The register and ranges of the innermost xScopedBaseRegister
+static __tls_emit int s_baseRegId = xRegId_Empty;
+static __tls_emit uptr s_baseAddr = 0;
+static __tls_emit uptr s_baseBegin = 0;
+static __tls_emit uptr s_baseEnd = 0;
+
 __fi void xWrite8(u8 val)
 {
     xWrite(val);
@@ -515,7 +521,7 @@ xAddressVoid xAddressReg::operator+(s32 right) const
 xAddressVoid xAddressReg::operator+(const void *right) const
 {
     pxAssertMsg(Id != -1, "Uninitialized x86 register.");
-    return xAddressVoid(*this, (sptr)right);
+    return xAddressVoid(*this).Add(right);
 }
 
 xAddressVoid xAddressReg::operator-(s32 right) const
@@ -576,21 +582,62 @@ xAddressVoid::xAddressVoid(s32 displacement)
     Displacement = displacement;
 }
 
+// Absolute addresses are encoded as a disp32, so on x86-64 they have to sit in the low 2GB.
+static s32 AbsoluteDisp(const void *addr)
+{
+#ifdef __M_X86_64
+    pxAssertDev((sptr)addr == (s32)(sptr)addr, "Address is too far away, needs a base register");
+#endif
+    return (s32)(sptr)addr;
+}
+
+// Swaps the pinned base register of an address for the absolute address it stands for,
+// freeing a register slot.  Returns false if the address doesn't use the base register.
+static bool DropBaseRegister(xAddressVoid &addr)
+{
+    if (s_baseBegin >= s_baseEnd)
+        return false;
+
+    if (addr.Base.Id == s_baseRegId) {
+        addr.Base = xEmptyReg;
+    } else if (addr.Index.Id == s_baseRegId && addr.Factor <= 1) {
+        addr.Index = xEmptyReg;
+        addr.Factor = 0;
+    } else
+        return false;
+
+    // Keep an unscaled index as the base, so the index slot is the free one.
+    if (addr.Base.IsEmpty() && addr.Factor <= 1) {
+        addr.Base = addr.Index;
+        addr.Index = xEmptyReg;
+        addr.Factor = 0;
+    }
+
+    addr.Displacement += AbsoluteDisp((void *)s_baseAddr);
+    return true;
+}
+
 xAddressVoid::xAddressVoid(const void *displacement)
 {
     Base = xEmptyReg;
     Index = xEmptyReg;
     Factor = 0;
-#ifdef __M_X86_64
-    pxAssert(0);
-//Displacement = (s32)displacement;
-#else
-    Displacement = (s32)displacement;
-#endif
+
+    if ((uptr)displacement >= s_baseBegin && (uptr)displacement < s_baseEnd) {
+        Base = xAddressReg(s_baseRegId);
+        Displacement = (s32)((sptr)displacement - (sptr)s_baseAddr);
+        return;
+    }
+
+    Displacement = AbsoluteDisp(displacement);
 }
 
 xAddressVoid &xAddressVoid::Add(const xAddressReg &src)
 {
+    // Both slots taken: make room by folding the pinned base register into the displacement.
+    if (!src.IsEmpty() && src != Index && !Base.IsEmpty() && !Index.IsEmpty())
+        DropBaseRegister(*this);
+
     if (src == Index) {
         Factor++;
     } else if (src == Base) {
@@ -616,9 +663,13 @@ xAddressVoid &xAddressVoid::Add(const xAddressReg &src)
 
 xAddressVoid &xAddressVoid::Add(const xAddressVoid &src)
 {
-    Add(src.Base);
+    if (!src.Base.IsEmpty())
+        Add(src.Base);
     Add(src.Displacement);
 
+    if (src.Factor > 1 && !Index.IsEmpty() && Index != src.Index)
+        DropBaseRegister(*this);
+
     // If the factor is 1, we can just treat index like a base register also.
     if (src.Factor == 1) {
         Add(src.Index);
@@ -633,6 +684,18 @@ xAddressVoid &xAddressVoid::Add(const xAddressVoid &src)
     return *this;
 }
 
+// Adds an absolute address, relative to the base register if it is in its range and
+// the address still has a free register slot for it.
+xAddressVoid &xAddressVoid::Add(const void *addr)
+{
+    const xAddressVoid target(addr);
+    if (target.Base.IsEmpty() || (!Base.IsEmpty() && !Index.IsEmpty()))
+        return Add(AbsoluteDisp(addr));
+
+    Add(target.Base);
+    return Add(target.Displacement);
+}
+
 xIndirectVoid::xIndirectVoid(const xAddressVoid &src)
 {
     Base = src.Base;
@@ -1160,4 +1223,30 @@ xScopedStackFrame::~xScopedStackFrame()
 #endif
 }
 
+xScopedBaseRegister::xScopedBaseRegister(const xAddressReg &reg, const void *base, const void *begin, const void *end)
+{
+    m_prevId = s_baseRegId;
+    m_prevBase = s_baseAddr;
+    m_prevBegin = s_baseBegin;
+    m_prevEnd = s_baseEnd;
+
+    // Every address of the range must be within a 32 bit displacement of the base
+    const sptr first = (sptr)begin - (sptr)base;
+    const sptr last = (sptr)end - (sptr)base - 1;
+    pxAssertDev(begin >= end || (first == (s32)first && last == (s32)last), "Base register range is too large");
+
+    s_baseRegId = reg.Id;
+    s_baseAddr = (uptr)base;
+    s_baseBegin = (uptr)begin;
+    s_baseEnd = (uptr)end;
+}
+
+xScopedBaseRegister::~xScopedBaseRegister()
+{
+    s_baseRegId = m_prevId;
+    s_baseAddr = m_prevBase;
+    s_baseBegin = m_prevBegin;
+    s_baseEnd = m_prevEnd;
+}
+
 } // End namespace x86Emitter
@@ -16,37 +16,183 @@
 #include "PrecompiledHeader.h"
 #include "ChunksCache.h"
 
+const u32 ChunksCache::NIL;
+
+ChunksCache::ChunksCache(uint chunkSize, uint initialLimitMb) :
+	m_bucketMask(0),
+	m_used(0),
+	m_head(NIL),
+	m_tail(NIL),
+	m_allocated(0),
+	m_chunkSize(chunkSize),
+	m_limit((PX_off_t)initialLimitMb * 1024 * 1024) {
+	ResetStats();
+}
+
+void ChunksCache::SetChunkSize(uint bytes) {
+	Clear();
+	m_chunkSize = bytes;
+}
+
 void ChunksCache::SetLimit(uint megabytes) {
+	Clear();
 	m_limit = (PX_off_t)megabytes * 1024 * 1024;
-	MatchLimit();
 }
 
-void ChunksCache::MatchLimit(bool removeAll) {
-	std::list<CacheEntry*>::reverse_iterator rit;
-	while (!m_entries.empty() && (removeAll || m_size > m_limit)) {
-		rit = m_entries.rbegin();
-		m_size -= (*rit)->size;
-		delete(*rit);
-		m_entries.pop_back();
+void ChunksCache::Clear() {
+	for (u32 i = 0; i < m_entries.size(); i++)
+		free(m_entries[i].data);
+
+	// Release the memory, the cache is usually cleared because the file is closed
+	std::vector<Entry>().swap(m_entries);
+	std::vector<u32>().swap(m_buckets);
+	m_bucketMask = 0;
+	m_used = 0;
+	m_head = m_tail = NIL;
+	m_allocated = 0;
+}
+
+// The slots and buckets are set up on the first insertion, once the geometry is final
+void ChunksCache::Allocate() {
+	u32 slots = (u32)std::max<PX_off_t>(m_limit / m_chunkSize, 1);
+	u32 buckets = 1;
+	while (buckets < slots * 2)
+		buckets <<= 1;
+
+	Entry empty = {-1, NULL, 0, 0, NIL, NIL, NIL};
+	m_entries.assign(slots, empty);
+	m_buckets.assign(buckets, NIL);
+	m_bucketMask = buckets - 1;
+}
+
+u32 ChunksCache::Find(PX_off_t chunk) const {
+	if (m_buckets.empty())
+		return NIL;
+
+	u32 i = m_buckets[Bucket(chunk)];
+	while (i != NIL && m_entries[i].chunk != chunk)
+		i = m_entries[i].hnext;
+	return i;
+}
+
+void ChunksCache::Unlink(u32 i) {
+	Entry& e = m_entries[i];
+	if (e.prev != NIL) m_entries[e.prev].next = e.next; else m_head = e.next;
+	if (e.next != NIL) m_entries[e.next].prev = e.prev; else m_tail = e.prev;
+	e.prev = e.next = NIL;
+}
+
+void ChunksCache::Unhash(u32 i) {
+	u32* link = &m_buckets[Bucket(m_entries[i].chunk)];
+	while (*link != i)
+		link = &m_entries[*link].hnext;
+	*link = m_entries[i].hnext;
+	m_entries[i].hnext = NIL;
+}
+
+void ChunksCache::PushFront(u32 i) {
+	Entry& e = m_entries[i];
+	e.prev = NIL;
+	e.next = m_head;
+	if (m_head != NIL) m_entries[m_head].prev = i; else m_tail = i;
+	m_head = i;
+}
+
+void* ChunksCache::Insert(PX_off_t offset, int length, int coverage) {
+	if (m_entries.empty())
+		Allocate();
+
+	const PX_off_t chunk = offset / m_chunkSize;
+	u32 i = Find(chunk);
+
+	if (i != NIL) {
+		// Replaced, keep the slot
+		Unlink(i);
+	} else {
+		if (m_used < m_entries.size()) {
+			i = m_used++;
+		} else {
+			i = m_tail;
+			Unlink(i);
+			Unhash(i);
+			m_stats.evictions++;
+		}
+
+		Entry& e = m_entries[i];
+		if (!e.data) {
+			e.data = (u8*)malloc(m_chunkSize);
+			m_allocated++;
+		}
+		e.chunk = chunk;
+		u32& bucket = m_buckets[Bucket(chunk)];
+		e.hnext = bucket;
+		bucket = i;
 	}
+
+	Entry& e = m_entries[i];
+	e.size = std::min(length, (int)m_chunkSize);
+	e.coverage = coverage;
+	PushFront(i);
+	return e.data;
 }
 
-void ChunksCache::Take(void* pMallocedSrc, PX_off_t offset, int length, int coverage) {
-	m_entries.push_front(new CacheEntry(pMallocedSrc, offset, length, coverage));
-	m_size += length;
-	MatchLimit();
+void ChunksCache::Take(const void* pSrc, PX_off_t offset, int length, int coverage) {
+	void* dst = Insert(offset, length, coverage);
+	if (length > 0)
+		memcpy(dst, pSrc, std::min(length, (int)m_chunkSize));
+}
+
+void ChunksCache::Remove(PX_off_t offset) {
+	u32 i = Find(offset / m_chunkSize);
+	if (i == NIL)
+		return;
+
+	Unlink(i);
+	Unhash(i);
+
+	// Move it to the end of the used slots, the buffer goes along
+	u32 last = --m_used;
+	if (i != last) {
+		bool wasHead = m_head == last, wasTail = m_tail == last;
+		u32* link = &m_buckets[Bucket(m_entries[last].chunk)];
+		while (*link != last)
+			link = &m_entries[*link].hnext;
+		*link = i;
+
+		std::swap(m_entries[i], m_entries[last]);
+		Entry& e = m_entries[i];
+		if (e.prev != NIL) m_entries[e.prev].next = i;
+		if (e.next != NIL) m_entries[e.next].prev = i;
+		if (wasHead) m_head = i;
+		if (wasTail) m_tail = i;
+	}
+	m_entries[last].chunk = -1;
 }
 
-// By design, succeed only if the entire request is in a single cached chunk
 int ChunksCache::Read(void* pDest, PX_off_t offset, int length) {
-	for (auto it = m_entries.begin(); it != m_entries.end(); it++) {
-		CacheEntry* e = *it;
-		if (e && offset >= e->offset && (offset + length) <= (e->offset + e->coverage)) {
-			if (it != m_entries.begin())
-				m_entries.splice(m_entries.begin(), m_entries, it); // Move to top (MRU)
-			return CopyAvailable(e->data, e->offset, e->size, pDest, offset, length);
-		}
+	const PX_off_t chunk = offset / m_chunkSize;
+	u32 i = Find(chunk);
+	if (i == NIL || offset + length > chunk * m_chunkSize + m_entries[i].coverage) {
+		m_stats.misses++;
+		return -1;
 	}
-	return -1;
+
+	if (i != m_head) {
+		Unlink(i);
+		PushFront(i); // Move to top (MRU)
+	}
+	m_stats.hits++;
+
+	Entry& e = m_entries[i];
+	return CopyAvailable(e.data, chunk * m_chunkSize, e.size, pDest, offset, length);
 }
 
+void ChunksCache::PrintStats(const char* name) const {
+	const u64 lookups = m_stats.hits + m_stats.misses;
+	if (!lookups)
+		return;
+
+	DevCon.WriteLn(Color_Gray, "%s cache: %u lookups, %.1f%% hits, %u evictions, %u KB in use",
+	               name, (u32)lookups, 100.0 * m_stats.hits / lookups, (u32)m_stats.evictions,
+	               (u32)(GetMemoryUsage() / 1024));
+}
@@ -15,19 +15,40 @@
 
 #pragma once
 
-#include "zlib_indexed.h"
+#include "CompressedFileReaderUtils.h"
+#include <vector>
 
 #define CLAMP(val, minval, maxval) (std::min(maxval, std::max(minval, val)))
 
+// Extracted data of a compressed ISO (gzip extraction chunks, CSO frames), stored in chunks of
+// a fixed size at 0-based multiples of it.  Chunks are found through a hash of their index and
+// the least recently used one is recycled when the limit is reached, both in constant time.
+// Chunk buffers are pooled: they're allocated on first use and only freed by Clear().
 class ChunksCache {
 public:
-	ChunksCache(uint initialLimitMb) : m_entries(0), m_size(0), m_limit(initialLimitMb * 1024 * 1024) {};
+	struct Stats {
+		u64 hits;       // Read() calls served from the cache
+		u64 misses;
+		u64 evictions;
+	};
+
+	ChunksCache(uint chunkSize, uint initialLimitMb);
 	~ChunksCache() { Clear(); };
+
+	// Both drop the cached data
+	void SetChunkSize(uint bytes);
 	void SetLimit(uint megabytes);
-	void Clear() { MatchLimit(true); };
+	void Clear();
 
-	void Take(void* pMallocedSrc, PX_off_t offset, int length, int coverage);
-	int  Read(void* pDest,        PX_off_t offset, int length);
+	// Returns the buffer of the chunk at offset, to be filled by the caller with length bytes
+	// of data covering coverage bytes of the file (length is less at the end of the file)
+	void* Insert(PX_off_t offset, int length, int coverage);
+	void  Take(const void* pSrc, PX_off_t offset, int length, int coverage);
+	void  Remove(PX_off_t offset);
+	bool  Has(PX_off_t offset) const { return Find(offset / m_chunkSize) != NIL; };
+
+	// By design, succeed only if the entire request is in a single cached chunk
+	int  Read(void* pDest, PX_off_t offset, int length);
 
 	static int CopyAvailable(void* pSrc, PX_off_t srcOffset, int srcSize,
 							 void* pDst, PX_off_t dstOffset, int maxCopySize) {
@@ -36,28 +57,42 @@ public:
 		return available;
 	};
 
+	const Stats& GetStats() const { return m_stats; };
+	void ResetStats() { memzero(m_stats); };
+	size_t GetMemoryUsage() const { return m_allocated * (size_t)m_chunkSize + m_entries.capacity() * sizeof(Entry) + m_buckets.capacity() * sizeof(u32); };
+	void PrintStats(const char* name) const;
+
 private:
-	class CacheEntry {
-	public:
-		CacheEntry(void* pMallocedSrc, PX_off_t offset, int length, int coverage) :
-			data(pMallocedSrc),
-			offset(offset),
-			coverage(coverage),
-			size(length)
-		{};
-
-		~CacheEntry() { if (data) free(data); };
-
-		void* data;
-		PX_off_t offset;
-		int coverage;
+	static const u32 NIL = 0xFFFFFFFF;
+
+	struct Entry {
+		PX_off_t chunk; // offset / m_chunkSize
+		u8* data;
 		int size;
+		int coverage;
+		u32 prev;       // LRU list, m_head is the most recently used
+		u32 next;
+		u32 hnext;      // bucket chain
 	};
 
-	std::list<CacheEntry*> m_entries;
-	void MatchLimit(bool removeAll = false);
-	PX_off_t m_size;
+	u32  Bucket(PX_off_t chunk) const { return (u32)(((u64)chunk * 0x9E3779B97F4A7C15ull) >> 32) & m_bucketMask; };
+	u32  Find(PX_off_t chunk) const;
+	void Unlink(u32 i);
+	void Unhash(u32 i);
+	void PushFront(u32 i);
+	void Allocate();
+
+	std::vector<Entry> m_entries; // in use: [0, m_used)
+	std::vector<u32> m_buckets;
+	u32 m_bucketMask;
+	u32 m_used;
+	u32 m_head;
+	u32 m_tail;
+	u32 m_allocated;              // chunk buffers in the pool
+
+	uint m_chunkSize;
 	PX_off_t m_limit;
+	Stats m_stats;
 };
 
 #undef CLAMP
@@ -89,6 +89,9 @@ bool CsoFileReader::Open(const wxString& fileName) {
 		Close();
 		return false;
 	}
+
+	const u32 readaheadFrames = std::max<u32>(CSO_READAHEAD_SIZE >> m_frameShift, 1);
+	m_readahead.Start([this](u64 frame) { return PrefetchFrame(frame); }, readaheadFrames);
 	return true;
 }
 
@@ -131,9 +134,8 @@ bool CsoFileReader::InitializeBuffers() {
 		m_readBuffer = new u8[m_frameSize + (1 << m_indexShift)];
 	}
 
-	// This is a buffer for the most recently decompressed frame.
-	m_zlibBuffer = new u8[m_frameSize + (1 << m_indexShift)];
-	m_zlibBufferFrame = numFrames;
+	// Cache whole decompressed frames.
+	m_cache.SetChunkSize(m_frameSize);
 
 	const u32 indexSize = numFrames + 1;
 	m_index = new u32[indexSize];
@@ -155,10 +157,14 @@ bool CsoFileReader::InitializeBuffers() {
 }
 
 void CsoFileReader::Close() {
+	m_readahead.Stop();
+	m_readahead.PrintStats("CSO");
+	m_readahead.ResetStats();
+	m_cache.PrintStats("CSO");
+	m_cache.ResetStats();
+
 	m_filename.Empty();
-#if CSO_USE_CHUNKSCACHE
 	m_cache.Clear();
-#endif
 
 	if (m_src) {
 		fclose(m_src);
@@ -173,10 +179,6 @@ void CsoFileReader::Close() {
 		delete[] m_readBuffer;
 		m_readBuffer = NULL;
 	}
-	if (m_zlibBuffer) {
-		delete[] m_zlibBuffer;
-		m_zlibBuffer = NULL;
-	}
 	if (m_index) {
 		delete[] m_index;
 		m_index = NULL;
@@ -184,6 +186,11 @@ void CsoFileReader::Close() {
 }
 
 int CsoFileReader::ReadSync(void* pBuffer, uint sector, uint count) {
+	std::lock_guard<std::mutex> lock(m_readahead.Lock());
+	return _ReadSync(pBuffer, sector, count);
+}
+
+int CsoFileReader::_ReadSync(void* pBuffer, uint sector, uint count) {
 	if (!m_src) {
 		return 0;
 	}
@@ -198,27 +205,10 @@ int CsoFileReader::ReadSync(void* pBuffer, uint sector, uint count) {
 	int bytes = 0;
 
 	while (remaining > 0) {
-		int readBytes;
-
-#if CSO_USE_CHUNKSCACHE
-		// Try first to read from the cache.
-		readBytes = m_cache.Read(dest + bytes, pos + bytes, remaining);
-#else
-		readBytes = -1;
-#endif
-		if (readBytes < 0) {
-			readBytes = ReadFromFrame(dest + bytes, pos + bytes, remaining);
-			if (readBytes == 0) {
-				// We hit EOF.
-				break;
-			}
-
-#if CSO_USE_CHUNKSCACHE
-			// Add the bytes into the cache.  We need to allocate a buffer for it.
-			void *cached = malloc(readBytes);
-			memcpy(cached, dest + bytes, readBytes);
-			m_cache.Take(cached, pos + bytes, readBytes, readBytes);
-#endif
+		int readBytes = ReadFromFrame(dest + bytes, pos + bytes, remaining);
+		if (readBytes == 0) {
+			// We hit EOF.
+			break;
 		}
 
 		bytes += readBytes;
@@ -241,65 +231,100 @@ int CsoFileReader::ReadFromFrame(u8 *dest, u64 pos, int maxBytes) {
 
 	// Grab the index data for the frame we're about to read.
 	const bool compressed = (m_index[frame + 0] & 0x80000000) == 0;
-	const u32 index0 = m_index[frame + 0] & 0x7FFFFFFF;
-	const u32 index1 = m_index[frame + 1] & 0x7FFFFFFF;
-
-	// Calculate where the compressed payload is (if compressed.)
-	const u64 frameRawPos = (u64)index0 << m_indexShift;
-	const u64 frameRawSize = (u64)(index1 - index0) << m_indexShift;
 
 	if (!compressed) {
 		// Just read directly, easy.
+		const u64 frameRawPos = (u64)(m_index[frame + 0] & 0x7FFFFFFF) << m_indexShift;
 		if (PX_fseeko(m_src, m_dataoffset + frameRawPos + offset, SEEK_SET) != 0) {
 			Console.Error("Unable to seek to uncompressed CSO data.");
 			return 0;
 		}
 		return fread(dest, 1, bytes, m_src);
 	} else {
-		// We don't need to decompress if we already did this same frame last time.
-		if (m_zlibBufferFrame != frame) {
-			if (PX_fseeko(m_src, m_dataoffset + frameRawPos, SEEK_SET) != 0) {
-				Console.Error("Unable to seek to compressed CSO data.");
-				return 0;
-			}
-			// This might be less bytes than frameRawSize in case of padding on the last frame.
-			// This is because the index positions must be aligned.
-			const u32 readRawBytes = fread(m_readBuffer, 1, frameRawSize, m_src);
-			if (!DecompressFrame(frame, readRawBytes)) {
-				return 0;
-			}
+		// Usually decompressed already, by an earlier read or the readahead.
+		if (m_cache.Read(dest, pos, bytes) >= 0) {
+			return bytes;
+		}
+
+		const u8* data = DecompressFrame(frame);
+		if (!data) {
+			return 0;
 		}
 
 		// Now we just copy the offset data from the cache.
-		memcpy(dest, m_zlibBuffer + offset, bytes);
+		memcpy(dest, data + offset, bytes);
 	}
 
 	return bytes;
 }
 
-bool CsoFileReader::DecompressFrame(u32 frame, u32 readBufferSize) {
+// Decompresses the frame into a new m_cache entry, and returns the entry's data.
+u8* CsoFileReader::DecompressFrame(u32 frame) {
+	// Calculate where the compressed payload is.
+	const u32 index0 = m_index[frame + 0] & 0x7FFFFFFF;
+	const u32 index1 = m_index[frame + 1] & 0x7FFFFFFF;
+	const u64 frameRawPos = (u64)index0 << m_indexShift;
+	const u64 frameRawSize = (u64)(index1 - index0) << m_indexShift;
+
+	if (PX_fseeko(m_src, m_dataoffset + frameRawPos, SEEK_SET) != 0) {
+		Console.Error("Unable to seek to compressed CSO data.");
+		return NULL;
+	}
+	// This might be less bytes than frameRawSize in case of padding on the last frame.
+	// This is because the index positions must be aligned.
+	const u32 readRawBytes = fread(m_readBuffer, 1, frameRawSize, m_src);
+
+	const u64 framePos = (u64)frame << m_frameShift;
+	u8* dest = (u8*)m_cache.Insert(framePos, m_frameSize, m_frameSize);
+
 	m_z_stream->next_in = m_readBuffer;
-	m_z_stream->avail_in = readBufferSize;
-	m_z_stream->next_out = m_zlibBuffer;
+	m_z_stream->avail_in = readRawBytes;
+	m_z_stream->next_out = dest;
 	m_z_stream->avail_out = m_frameSize;
 
 	int status = inflate(m_z_stream, Z_FINISH);
 	bool success = status == Z_STREAM_END && m_z_stream->total_out == m_frameSize;
-	if (success) {
-		// Our buffer now contains this frame.
-		m_zlibBufferFrame = frame;
-	} else {
+	inflateReset(m_z_stream);
+
+	if (!success) {
 		Console.Error("Unable to decompress CSO frame using zlib.");
-		m_zlibBufferFrame = (u32)-1;
+		m_cache.Remove(framePos);
+		return NULL;
 	}
 
-	inflateReset(m_z_stream);
-	return success;
+	m_decompressed++;
+	return dest;
+}
+
+// Called by m_readahead's thread, with its lock held
+int CsoFileReader::PrefetchFrame(u64 frame) {
+	if (frame >= (m_totalSize + m_frameSize - 1) >> m_frameShift) {
+		return -1;
+	}
+
+	// Uncompressed frames are read straight into the destination, nothing to do ahead.
+	if ((m_index[frame] & 0x80000000) != 0 || m_cache.Has(frame << m_frameShift)) {
+		return 0;
+	}
+
+	return DecompressFrame((u32)frame) ? 1 : -1;
 }
 
 void CsoFileReader::BeginRead(void* pBuffer, uint sector, uint count) {
-	// TODO: No async support yet, implement as sync.
-	m_bytesRead = ReadSync(pBuffer, sector, count);
+	// Still read synchronously, but the frames are normally decompressed ahead by
+	// m_readahead, so this mostly costs the copy.
+	const u64 start = GetCPUTicks();
+	bool hit;
+	{
+		std::lock_guard<std::mutex> lock(m_readahead.Lock());
+		const u32 decompressed = m_decompressed;
+		m_bytesRead = _ReadSync(pBuffer, sector, count);
+		hit = m_decompressed == decompressed;
+	}
+
+	const u64 pos = (u64)sector * m_blocksize;
+	const u64 end = pos + (u64)std::max(count, 1u) * m_blocksize - 1;
+	m_readahead.Read(pos >> m_frameShift, end >> m_frameShift, hit, GetCPUTicks() - start);
 }
 
 int CsoFileReader::FinishRead() {
@@ -15,22 +15,17 @@
 
 #pragma once
 
-// Based on testing, the overhead of using this cache is high.
-//
-// The test was done with CSO files using a block size of 16KB.
-// Cache hit rates were observed in the range of 25%.
-// Cache overhead added 35% to the overall read time.
-//
-// For this reason, it's currently disabled.
-#define CSO_USE_CHUNKSCACHE 0
-
 #include "AsyncFileReader.h"
 #include "ChunksCache.h"
+#include "ReadaheadThread.h"
 
 struct CsoHeader;
 typedef struct z_stream_s z_stream;
 
+// Decompressed frames cache, allocated as frames get read
 static const uint CSO_CHUNKCACHE_SIZE_MB = 200;
+// How much is decompressed ahead of sequential reads (rounded up to a whole frame)
+static const uint CSO_READAHEAD_SIZE = 256 * 1024;
 
 class CsoFileReader : public AsyncFileReader
 {
@@ -41,15 +36,12 @@ public:
 		m_frameShift(0),
 		m_indexShift(0),
 		m_readBuffer(0),
-		m_zlibBuffer(0),
-		m_zlibBufferFrame(0),
+		m_decompressed(0),
 		m_index(0),
 		m_totalSize(0),
 		m_src(0),
 		m_z_stream(0),
-#if CSO_USE_CHUNKSCACHE
-		m_cache(CSO_CHUNKCACHE_SIZE_MB),
-#endif
+		m_cache(2048, CSO_CHUNKCACHE_SIZE_MB),
 		m_bytesRead(0) {
 		m_blocksize = 2048;
 	};
@@ -78,24 +70,27 @@ private:
 	static bool ValidateHeader(const CsoHeader& hdr);
 	bool ReadFileHeader();
 	bool InitializeBuffers();
+	int _ReadSync(void* pBuffer, uint sector, uint count);
 	int ReadFromFrame(u8 *dest, u64 pos, int maxBytes);
-	bool DecompressFrame(u32 frame, u32 readBufferSize);
+	u8* DecompressFrame(u32 frame);
+	int PrefetchFrame(u64 frame);
 
 	u32 m_frameSize;
 	u8 m_frameShift;
 	u8 m_indexShift;
 	u8* m_readBuffer;
-	u8 *m_zlibBuffer;
-	u32 m_zlibBufferFrame;
+	u32 m_decompressed; // frames decompressed into m_cache, by either thread
 	u32 *m_index;
 	u64 m_totalSize;
 	// The actual source cso file handle.
 	FILE* m_src;
 	z_stream* m_z_stream;
 
-#if CSO_USE_CHUNKSCACHE
+	// Decompressed frames, including the ones m_readahead decompressed ahead of the reads
 	ChunksCache m_cache;
-#endif
+
+	// Everything above used by reads is guarded by m_readahead.Lock()
+	ReadaheadThread m_readahead;
 
 	// The result of a read is stored here between BeginRead() and FinishRead().
 	int m_bytesRead;
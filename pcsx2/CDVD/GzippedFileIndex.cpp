@@ -0,0 +1,490 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrecompiledHeader.h"
+#include <algorithm>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "CompressedFileReaderUtils.h"
+#include "GzippedFileIndex.h"
+
+#define GZIP_ID "PCSX2.index.gzip.v2|"
+#define GZIP_ID_V1 "PCSX2.index.gzip.v1|"
+#define GZIP_ID_LEN (sizeof(GZIP_ID) - 1)	/* sizeof includes the \0 terminator */
+
+// File format is:
+// - [GZIP_ID_LEN] GZIP_ID (no \0)
+// - [sizeof(GzippedIndexHeader)] header
+// - [count * sizeof(GzippedIndexPoint)] the access points
+// - [rest] the windows of the points, each deflated on its own (zlib format)
+struct GzippedIndexHeader {
+	s32 span;
+	u32 count;
+	s64 uncompressedSize;
+};
+
+static_assert(sizeof(GzippedIndexHeader) == 16 && sizeof(GzippedIndexPoint) == 32, "index file layout");
+
+// v1 files were GZIP_ID_V1, zlib_indexed.h's former struct access as is (list pointer
+// included), and then the Points with their windows.
+#pragma pack(push, 1)
+struct GzippedIndexHeaderV1 {
+	int have;
+	int size;
+	void* list;
+	s32 span;
+	s64 uncompressedSize;
+};
+#pragma pack(pop)
+
+#define WINDOW_BOUND (WINSIZE + WINSIZE / 8) // more than compressBound(WINSIZE)
+
+static s64 fsize(FILE* f) {
+	if (PX_fseeko(f, 0, SEEK_END))
+		return -1;
+	return PX_ftello(f);
+}
+
+// Inflates the start of a gzip file, returns the number of bytes read into buf
+static int InflateHead(FILE* in, u8* buf, int len) {
+	z_stream strm;
+	memzero(strm);
+	if (inflateInit2(&strm, 47) != Z_OK) // gzip or zlib
+		return 0;
+
+	u8 input[16 * 1024];
+	strm.next_out = buf;
+	strm.avail_out = len;
+	PX_fseeko(in, 0, SEEK_SET);
+
+	int ret = Z_OK;
+	while (strm.avail_out && ret == Z_OK) {
+		if (!strm.avail_in) {
+			strm.avail_in = fread(input, 1, sizeof(input), in);
+			strm.next_in = input;
+			if (!strm.avail_in)
+				break;
+		}
+		ret = inflate(&strm, Z_NO_FLUSH);
+	}
+
+	inflateEnd(&strm);
+	return len - strm.avail_out;
+}
+
+// The size of the uncompressed data, before it is known. The gzip trailer has it modulo
+// 4 GB, and the ISO9660 volume size is close to it. Without a volume descriptor, assume
+// the compressed file isn't more than twice as big as the data.
+static s64 EstimateUncompressedSize(FILE* in, s64 compressedSize) {
+	u8 trailer[4];
+	if (compressedSize < 18 || PX_fseeko(in, compressedSize - 4, SEEK_SET) || fread(trailer, 1, 4, in) != 4)
+		return 0;
+
+	const s64 wrap = 1ll << 32;
+	s64 size = trailer[0] | trailer[1] << 8 | trailer[2] << 16 | (u32)trailer[3] << 24;
+
+	// The primary volume descriptor is at sector 16, of 2048 byte (iso) or 2352 byte (mode 1
+	// or mode 2 form 1 bin) sectors. Its volume space size is at byte 80.
+	const struct { int offset; int sectorSize; } pvds[] = {
+		{ 16 * 2048, 2048 }, { 16 * 2352 + 16, 2352 }, { 16 * 2352 + 24, 2352 }
+	};
+	const int headSize = 16 * 2352 + 24 + 2048;
+	u8* head = (u8*)malloc(headSize);
+	const int got = InflateHead(in, head, headSize);
+
+	s64 volumeSize = 0;
+	for (const auto& pvd : pvds) {
+		const u8* p = head + pvd.offset;
+		if (pvd.offset + 2048 <= got && p[0] == 1 && !memcmp(p + 1, "CD001", 5)) {
+			volumeSize = (s64)(p[80] | p[81] << 8 | p[82] << 16 | (u32)p[83] << 24) * pvd.sectorSize;
+			break;
+		}
+	}
+	free(head);
+
+	if (volumeSize) {
+		while (size + wrap / 2 < volumeSize)
+			size += wrap;
+	} else {
+		while (size < compressedSize / 2)
+			size += wrap;
+	}
+	return size;
+}
+
+GzippedFileIndex::GzippedFileIndex() :
+	m_span(0),
+	m_uncompressedSize(0),
+	m_complete(false),
+	m_points(0),
+	m_count(0),
+	m_windows(0),
+	m_point((Point*)malloc(sizeof(Point))),
+	m_pointIndex(-1),
+	m_map(0),
+	m_mapSize(0),
+#ifdef _WIN32
+	m_mapping(NULL),
+#endif
+	m_lock(0),
+	m_abort(false),
+	m_scanned(0),
+	m_compressedSize(0),
+	m_buildStart(0),
+	m_printedPercent(0),
+	m_started(false) {
+}
+
+GzippedFileIndex::~GzippedFileIndex() {
+	Close();
+	free(m_point);
+}
+
+void GzippedFileIndex::Close() {
+	if (m_thread.joinable()) {
+		m_abort = true;
+		m_thread.join();
+		if (!m_complete)
+			Console.WriteLn(Color_Gray, L"gzip index: build stopped at %d%%, it will restart on the next open.",
+			                (int)(100 * GetProgress()));
+	}
+	m_abort = false;
+
+	Unmap();
+	m_builtPoints.clear();
+	m_builtPoints.shrink_to_fit();
+	m_builtWindows.clear();
+	m_builtWindows.shrink_to_fit();
+
+	m_span = 0;
+	m_uncompressedSize = 0;
+	m_complete = false;
+	m_points = 0;
+	m_count = 0;
+	m_windows = 0;
+	m_pointIndex = -1;
+	m_lock = 0;
+	m_scanned = 0;
+	m_compressedSize = 0;
+	m_started = false;
+}
+
+bool GzippedFileIndex::Load(const wxString& indexfile) {
+	Close();
+
+	char fileId[GZIP_ID_LEN + 1] = { 0 };
+	FILE* f = PX_fopen_rb(indexfile);
+	if (!f || fread(fileId, 1, GZIP_ID_LEN, f) != GZIP_ID_LEN) {
+		Console.Error(L"Error: Can't open index file: '%s'", WX_STR(indexfile));
+		if (f)
+			fclose(f);
+		return false;
+	}
+	fclose(f);
+
+	if (!strcmp(fileId, GZIP_ID))
+		return Map(indexfile);
+
+	if (strcmp(fileId, GZIP_ID_V1)) {
+		Console.Error(L"Error: Incompatible gzip index, please delete it manually: '%s'", WX_STR(indexfile));
+		return false;
+	}
+
+	// Old index with uncompressed windows, convert it
+	if (!ReadV1(indexfile)) {
+		Close();
+		return false;
+	}
+	m_complete = true;
+
+	if (wxRemoveFile(indexfile))
+		Save(indexfile);
+	return true;
+}
+
+bool GzippedFileIndex::Map(const wxString& indexfile) {
+#ifdef _WIN32
+	HANDLE file = CreateFile(indexfile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	LARGE_INTEGER size;
+	if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &size) && size.QuadPart >= GZIP_ID_LEN) {
+		m_mapSize = (size_t)size.QuadPart;
+		m_mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (m_mapping)
+			m_map = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+	if (file != INVALID_HANDLE_VALUE)
+		CloseHandle(file);
+#else
+	int fd = open(PX_wfilename(indexfile), O_RDONLY);
+	struct stat st;
+	if (fd >= 0 && !fstat(fd, &st) && st.st_size >= (off_t)GZIP_ID_LEN) {
+		m_mapSize = st.st_size;
+		m_map = mmap(NULL, m_mapSize, PROT_READ, MAP_SHARED, fd, 0);
+		if (m_map == MAP_FAILED)
+			m_map = 0;
+	}
+	if (fd >= 0)
+		close(fd);
+#endif
+	if (!m_map) {
+		Console.Error(L"Error: Can't map index file: '%s'", WX_STR(indexfile));
+		Unmap();
+		return false;
+	}
+
+	const u8* data = (const u8*)m_map + GZIP_ID_LEN;
+	const size_t size = m_mapSize - GZIP_ID_LEN;
+	GzippedIndexHeader header;
+	bool ok = size >= sizeof(header);
+	if (ok) {
+		memcpy(&header, data, sizeof(header));
+		ok = header.span > 0 && size >= sizeof(header) + (u64)header.count * sizeof(GzippedIndexPoint);
+	}
+	if (ok) {
+		m_points = (const GzippedIndexPoint*)(data + sizeof(header));
+		m_count = header.count;
+		m_windows = (const u8*)(m_points + m_count);
+		const size_t windowsSize = size - sizeof(header) - m_count * sizeof(GzippedIndexPoint);
+		for (u32 i = 0; ok && i < m_count; i++)
+			ok = (u64)m_points[i].windowOffset + m_points[i].windowSize <= windowsSize
+			     && (!i || m_points[i].out > m_points[i - 1].out);
+	}
+	if (!ok) {
+		Console.Error(L"Error: unexpected size of gzip index, please delete it manually: '%s'.", WX_STR(indexfile));
+		Unmap();
+		m_points = 0;
+		m_count = 0;
+		m_windows = 0;
+		return false;
+	}
+
+	m_span = header.span;
+	m_uncompressedSize = header.uncompressedSize;
+	m_complete = true;
+	return true;
+}
+
+void GzippedFileIndex::Unmap() {
+#ifdef _WIN32
+	if (m_map)
+		UnmapViewOfFile(m_map);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	m_mapping = NULL;
+#else
+	if (m_map)
+		munmap(m_map, m_mapSize);
+#endif
+	m_map = 0;
+	m_mapSize = 0;
+}
+
+bool GzippedFileIndex::ReadV1(const wxString& indexfile) {
+	FILE* f = PX_fopen_rb(indexfile);
+	if (!f)
+		return false;
+
+	GzippedIndexHeaderV1 header;
+	const s64 size = fsize(f);
+	bool ok = !PX_fseeko(f, GZIP_ID_LEN, SEEK_SET) && fread(&header, sizeof(header), 1, f) == 1
+	          && header.have >= 0 && header.span > 0
+	          && size == (s64)(GZIP_ID_LEN + sizeof(header) + (u64)header.have * sizeof(Point));
+
+	u8 window[WINDOW_BOUND];
+	for (int i = 0; ok && i < header.have; i++) {
+		uLongf windowSize = sizeof(window);
+		ok = fread(m_point, sizeof(Point), 1, f) == 1
+		     && compress(window, &windowSize, m_point->window, WINSIZE) == Z_OK;
+		if (ok)
+			Add(m_point, window, windowSize);
+	}
+	fclose(f);
+
+	if (!ok) {
+		Console.Error(L"Error: unexpected size of gzip index, please delete it manually: '%s'.", WX_STR(indexfile));
+		return false;
+	}
+
+	m_span = header.span;
+	m_uncompressedSize = header.uncompressedSize;
+	Console.WriteLn(Color_Gray, L"gzip index: converting v1 index to v2, %u KB instead of %u KB.",
+	                (u32)((m_builtWindows.size() + m_count * sizeof(GzippedIndexPoint)) / 1024),
+	                (u32)(size / 1024));
+	return true;
+}
+
+bool GzippedFileIndex::Save(const wxString& indexfile) const {
+	if (wxFileName::FileExists(indexfile)) {
+		Console.Warning(L"WARNING: Won't write index - file name exists (please delete it manually): '%s'", WX_STR(indexfile));
+		return false;
+	}
+
+	GzippedIndexHeader header = { m_span, m_count, m_uncompressedSize };
+	std::ofstream outfile(PX_wfilename(indexfile), std::ofstream::binary);
+	outfile.write(GZIP_ID, GZIP_ID_LEN);
+	outfile.write((const char*)&header, sizeof(header));
+	outfile.write((const char*)m_points, m_count * sizeof(GzippedIndexPoint));
+	outfile.write((const char*)m_windows, m_builtWindows.size());
+	outfile.close();
+
+	// Verify
+	FILE* f = PX_fopen_rb(indexfile);
+	const s64 size = f ? fsize(f) : -1;
+	if (f)
+		fclose(f);
+	if (size != (s64)(GZIP_ID_LEN + sizeof(header) + m_count * sizeof(GzippedIndexPoint) + m_builtWindows.size())) {
+		Console.Warning(L"Warning: Can't write index file to disk: '%s'", WX_STR(indexfile));
+		return false;
+	}
+
+	Console.WriteLn(Color_Green, L"OK: Gzip quick access index file saved to disk: '%s'", WX_STR(indexfile));
+	return true;
+}
+
+bool GzippedFileIndex::Build(const wxString& gzfile, const wxString& indexfile, s32 span, std::mutex& lock) {
+	Close();
+
+	FILE* in = PX_fopen_rb(gzfile);
+	if (!in)
+		return false;
+
+	m_span = span;
+	m_lock = &lock;
+	m_compressedSize = fsize(in);
+	m_uncompressedSize = EstimateUncompressedSize(in, m_compressedSize);
+	m_buildStart = GetCPUTicks();
+	m_printedPercent = 0;
+	PX_fseeko(in, 0, SEEK_SET);
+
+	m_thread = std::thread(&GzippedFileIndex::Run, this, in, indexfile);
+
+	std::unique_lock<std::mutex> start(m_startLock);
+	m_startCv.wait(start, [this] { return m_started; });
+	start.unlock();
+
+	std::lock_guard<std::mutex> built(lock);
+	return m_count || m_complete;
+}
+
+// Worker thread
+void GzippedFileIndex::Run(FILE* in, wxString indexfile) {
+	PX_off_t size;
+	int ret = build_index(in, m_span, AddPoint, this, &size);
+	fclose(in);
+
+	if (ret >= 0) {
+		{
+			std::lock_guard<std::mutex> lock(*m_lock);
+			if (size != m_uncompressedSize)
+				Console.Warning(L"gzip index: the size is %u MB, not %u MB as estimated.",
+				                (u32)(size / _1mb), (u32)(m_uncompressedSize / _1mb));
+			m_uncompressedSize = size;
+			m_complete = true;
+		}
+
+		Console.WriteLn(Color_Green, L"gzip index: built in %u ms, %u access points, %u KB of windows.",
+		                (u32)((GetCPUTicks() - m_buildStart) * 1000 / GetTickFrequency()),
+		                m_count, (u32)(m_builtWindows.size() / 1024));
+		Save(indexfile);
+	} else if (!m_abort) {
+		Console.Error(L"ERROR (%d): gzip index could not be generated: '%s'", ret, WX_STR(indexfile));
+	}
+
+	{
+		std::lock_guard<std::mutex> start(m_startLock);
+		m_started = true;
+	}
+	m_startCv.notify_one();
+}
+
+// Called by build_index on the worker thread
+int GzippedFileIndex::AddPoint(void* opaque, const Point* here) {
+	GzippedFileIndex* index = (GzippedFileIndex*)opaque;
+	if (index->m_abort)
+		return 1;
+
+	u8 window[WINDOW_BOUND];
+	uLongf windowSize = sizeof(window);
+	if (compress(window, &windowSize, here->window, WINSIZE) != Z_OK)
+		return 1;
+
+	{
+		std::lock_guard<std::mutex> lock(*index->m_lock);
+		index->Add(here, window, windowSize);
+	}
+	index->m_scanned = here->in;
+
+	if (index->m_count == 1) {
+		{
+			std::lock_guard<std::mutex> start(index->m_startLock);
+			index->m_started = true;
+		}
+		index->m_startCv.notify_one();
+	}
+
+	const int percent = (int)(100 * index->GetProgress());
+	if (percent / 10 > index->m_printedPercent / 10) {
+		index->m_printedPercent = percent;
+		Console.WriteLn(Color_Gray, L"gzip index: %d%% after %u ms", percent,
+		                (u32)((GetCPUTicks() - index->m_buildStart) * 1000 / GetTickFrequency()));
+	}
+
+	return index->m_abort;
+}
+
+void GzippedFileIndex::Add(const Point* here, const u8* window, uLongf windowSize) {
+	GzippedIndexPoint point = { here->out, here->in, here->bits, (u32)m_builtWindows.size(), (u32)windowSize, 0 };
+	m_builtWindows.insert(m_builtWindows.end(), window, window + windowSize);
+	m_builtPoints.push_back(point);
+
+	m_points = m_builtPoints.data();
+	m_count = m_builtPoints.size();
+	m_windows = m_builtWindows.data();
+}
+
+const Point* GzippedFileIndex::GetPoint(PX_off_t offset) {
+	// Last point with out <= offset
+	const GzippedIndexPoint* p = std::upper_bound(m_points, m_points + m_count, offset,
+		[](PX_off_t offset, const GzippedIndexPoint& point) { return offset < point.out; });
+	if (p == m_points)
+		return NULL;
+
+	const s32 i = --p - m_points;
+	if (i == m_pointIndex)
+		return m_point;
+
+	uLongf windowSize = WINSIZE;
+	if (uncompress(m_point->window, &windowSize, m_windows + p->windowOffset, p->windowSize) != Z_OK || windowSize != WINSIZE) {
+		m_pointIndex = -1;
+		return NULL;
+	}
+
+	m_point->out = p->out;
+	m_point->in = p->in;
+	m_point->bits = p->bits;
+	m_pointIndex = i;
+	return m_point;
+}
+
+float GzippedFileIndex::GetProgress() const {
+	if (m_complete)
+		return 1;
+	return m_compressedSize > 0 ? (float)m_scanned / m_compressedSize : 0;
+}
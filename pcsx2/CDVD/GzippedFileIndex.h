@@ -0,0 +1,110 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "zlib_indexed.h"
+
+// An access point as stored in the index file. The windows follow the points, deflated,
+// and a window is only inflated when its point is used.
+struct GzippedIndexPoint {
+	s64 out;          // offset in the uncompressed data
+	s64 in;           // offset in the gzip file of the first full byte
+	s32 bits;         // number of bits (1-7) from the byte at in - 1, or 0
+	u32 windowOffset; // of the deflated window, from the start of the windows
+	u32 windowSize;   // deflated size
+	u32 reserved;
+};
+
+// Quick access index of a gzip file: access points about every span bytes of uncompressed
+// data (see zlib_indexed.h). It's either mapped from an index file, or built on a worker
+// thread, and then usable from the first access point on and saved once complete.
+class GzippedFileIndex {
+	DeclareNoncopyableObject(GzippedFileIndex);
+public:
+	GzippedFileIndex();
+	~GzippedFileIndex();
+
+	// Maps an index file. A v1 index file is read and rewritten in the current format.
+	bool Load(const wxString& indexfile);
+
+	// Starts scanning gzfile for access points. Returns once the first one is there, the
+	// others are added while holding lock. The index is saved to indexfile when complete.
+	bool Build(const wxString& gzfile, const wxString& indexfile, s32 span, std::mutex& lock);
+
+	// Stops the build if still running
+	void Close();
+
+	// While building, the following must only be used holding the lock given to Build()
+
+	bool IsComplete() const { return m_complete; };
+	s32 GetSpan() const { return m_span; };
+
+	// Until complete, estimated from the gzip trailer and the ISO9660 volume size
+	PX_off_t GetUncompressedSize() const { return m_uncompressedSize; };
+
+	// The last access point at or before offset, with its window, or NULL if none
+	const Point* GetPoint(PX_off_t offset);
+
+	// Fraction of the gzip file scanned so far, 1 once complete
+	float GetProgress() const;
+
+private:
+	static int AddPoint(void* opaque, const Point* here);
+	void Run(FILE* in, wxString indexfile);
+	bool Map(const wxString& indexfile);
+	void Unmap();
+	bool ReadV1(const wxString& indexfile);
+	bool Save(const wxString& indexfile) const;
+	void Add(const Point* here, const u8* window, uLongf windowSize);
+
+	s32 m_span;
+	std::atomic<s64> m_uncompressedSize;
+	std::atomic<bool> m_complete;
+
+	// The index, mapped or built
+	const GzippedIndexPoint* m_points;
+	u32 m_count;
+	const u8* m_windows;
+
+	Point* m_point;     // last point returned by GetPoint
+	s32 m_pointIndex;   // its index, or -1
+
+	// Mapped index file
+	void* m_map;
+	size_t m_mapSize;
+#ifdef _WIN32
+	HANDLE m_mapping;
+#endif
+
+	// Background build
+	std::vector<GzippedIndexPoint> m_builtPoints;
+	std::vector<u8> m_builtWindows;
+	std::mutex* m_lock;
+	std::thread m_thread;
+	std::atomic<bool> m_abort;
+	std::atomic<s64> m_scanned;  // gzip file bytes
+	s64 m_compressedSize;
+	u64 m_buildStart;
+	int m_printedPercent;
+	std::mutex m_startLock;
+	std::condition_variable m_startCv;
+	bool m_started;     // first point added, or build over
+};
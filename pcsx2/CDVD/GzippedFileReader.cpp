@@ -14,7 +14,6 @@
 */
 
 #include "PrecompiledHeader.h"
-#include <fstream>
 #include <wx/stdpaths.h>
 #include "AppConfig.h"
 #include "ChunksCache.h"
@@ -24,84 +23,6 @@
 
 #define CLAMP(val, minval, maxval) (std::min(maxval, std::max(minval, val)))
 
-static s64 fsize(const wxString& filename) {
-	if (!wxFileName::FileExists(filename))
-		return -1;
-
-	std::ifstream f(PX_wfilename(filename), std::ifstream::binary);
-	f.seekg(0, f.end);
-	s64 size = f.tellg();
-	f.close();
-
-	return size;
-}
-
-#define GZIP_ID "PCSX2.index.gzip.v1|"
-#define GZIP_ID_LEN (sizeof(GZIP_ID) - 1)	/* sizeof includes the \0 terminator */
-
-// File format is:
-// - [GZIP_ID_LEN] GZIP_ID (no \0)
-// - [sizeof(Access)] index (should be allocated, contains various sizes)
-// - [rest] the indexed data points (should be allocated, index->list should then point to it)
-static Access* ReadIndexFromFile(const wxString& filename) {
-	s64 size = fsize(filename);
-	if (size <= 0) {
-		Console.Error(L"Error: Can't open index file: '%s'", WX_STR(filename));
-		return 0;
-	}
-	std::ifstream infile(PX_wfilename(filename), std::ifstream::binary);
-
-	char fileId[GZIP_ID_LEN + 1] = { 0 };
-	infile.read(fileId, GZIP_ID_LEN);
-	if (wxString::From8BitData(GZIP_ID) != wxString::From8BitData(fileId)) {
-		Console.Error(L"Error: Incompatible gzip index, please delete it manually: '%s'", WX_STR(filename));
-		infile.close();
-		return 0;
-	}
-
-	Access* index = (Access*)malloc(sizeof(Access));
-	infile.read((char*)index, sizeof(Access));
-
-	s64 datasize = size - GZIP_ID_LEN - sizeof(Access);
-	if (datasize != (s64)index->have * sizeof(Point)) {
-		Console.Error(L"Error: unexpected size of gzip index, please delete it manually: '%s'.", WX_STR(filename));
-		infile.close();
-		free(index);
-		return 0;
-	}
-
-	char* buffer = (char*)malloc(datasize);
-	infile.read(buffer, datasize);
-	infile.close();
-	index->list = (Point*)buffer; // adjust list pointer
-	return index;
-}
-
-static void WriteIndexToFile(Access* index, const wxString filename) {
-	if (wxFileName::FileExists(filename)) {
-		Console.Warning(L"WARNING: Won't write index - file name exists (please delete it manually): '%s'", WX_STR(filename));
-		return;
-	}
-
-	std::ofstream outfile(PX_wfilename(filename), std::ofstream::binary);
-	outfile.write(GZIP_ID, GZIP_ID_LEN);
-
-	Point* tmp = index->list;
-	index->list = 0; // current pointer is useless on disk, normalize it as 0.
-	outfile.write((char*)index, sizeof(Access));
-	index->list = tmp;
-
-	outfile.write((char*)index->list, sizeof(Point) * index->have);
-	outfile.close();
-
-	// Verify
-	if (fsize(filename) != (s64)GZIP_ID_LEN + sizeof(Access) + sizeof(Point) * index->have) {
-		Console.Warning(L"Warning: Can't write index file to disk: '%s'", WX_STR(filename));
-	} else {
-		Console.WriteLn(Color_Green, L"OK: Gzip quick access index file saved to disk: '%s'", WX_STR(filename));
-	}
-}
-
 static wxString INDEX_TEMPLATE_KEY(L"$(f)");
 // template:
 // must contain one and only one instance of '$(f)' (without the quotes)
@@ -179,10 +100,12 @@ static wxString iso2indexname(const wxString& isoname) {
 
 GzippedFileReader::GzippedFileReader(void) :
 	mBytesRead(0),
-	m_pIndex(0),
 	m_zstates(0),
+	m_zstatesSize(0),
+	m_openTicks(0),
 	m_src(0),
-	m_cache(GZFILE_CACHE_SIZE_MB) {
+	m_cache(GZFILE_READ_CHUNK_SIZE, GZFILE_CACHE_SIZE_MB),
+	m_extracted(0) {
 	m_blocksize = 2048;
 	AsyncPrefetchReset();
 };
@@ -192,11 +115,12 @@ void GzippedFileReader::InitZstates() {
 		delete[] m_zstates;
 		m_zstates = 0;
 	}
-	if (!m_pIndex)
+	m_zstatesSize = m_index.GetUncompressedSize();
+	if (!m_index.GetSpan())
 		return;
 
 	// having another extra element helps avoiding logic for last (so 2+ instead of 1+)
-	int size = 2 + m_pIndex->uncompressed_size / m_pIndex->span;
+	int size = 2 + m_zstatesSize / m_index.GetSpan();
 	m_zstates = new Czstate[size]();
 }
 
@@ -268,7 +192,8 @@ void GzippedFileReader::AsyncPrefetchCancel()
 	if (!asyncInProgress)
 		return;
 
-	if (!CancelIo(hOverlappedFile)) {
+	// The readahead thread extracts too, so the read may have been issued by the other thread
+	if (!CancelIoEx(hOverlappedFile, &asyncOperationContext)) {
 		Console.Warning("canceling gz prefetch failed. following prefetching will not work.");
 		return;
 	}
@@ -283,19 +208,16 @@ bool GzippedFileReader::CanHandle(const wxString& fileName) {
 }
 
 bool GzippedFileReader::OkIndex() {
-	if (m_pIndex)
-		return true;
-
 	// Try to read index from disk
 	wxString indexfile = iso2indexname(m_filename);
 	if (indexfile.length() == 0)
 		return false; // iso2indexname(...) will print errors if it can't apply the template
 
-	if (wxFileName::FileExists(indexfile) && (m_pIndex = ReadIndexFromFile(indexfile))) {
+	if (wxFileName::FileExists(indexfile) && m_index.Load(indexfile)) {
 		Console.WriteLn(Color_Green, L"OK: Gzip quick access index read from disk: '%s'", WX_STR(indexfile));
-		if (m_pIndex->span != GZFILE_SPAN_DEFAULT) {
+		if (m_index.GetSpan() != GZFILE_SPAN_DEFAULT) {
 			Console.Warning(L"Note: This index has %1.1f MB intervals, while the current default for new indexes is %1.1f MB.",
-			                (float)m_pIndex->span / 1024 / 1024, (float)GZFILE_SPAN_DEFAULT / 1024 / 1024);
+			                (float)m_index.GetSpan() / 1024 / 1024, (float)GZFILE_SPAN_DEFAULT / 1024 / 1024);
 			Console.Warning(L"It will work fine, but if you want to generate a new index with default intervals, delete this index file.");
 			Console.Warning(L"(smaller intervals mean bigger index file and quicker but more frequent decompressions)");
 		}
@@ -303,47 +225,67 @@ bool GzippedFileReader::OkIndex() {
 		return true;
 	}
 
-	// No valid index file. Generate an index
-	Console.Warning(L"This may take a while (but only once). Scanning compressed file to generate a quick access index...");
-
-	Access *index;
-	FILE* infile = PX_fopen_rb(m_filename);
-	int len = build_index(infile, GZFILE_SPAN_DEFAULT, &index);
-	printf("\n"); // build_index prints progress without \n's
-	fclose(infile);
-
-	if (len >= 0) {
-		m_pIndex = index;
-		WriteIndexToFile((Access*)m_pIndex, indexfile);
-	} else {
-		Console.Error(L"ERROR (%d): index could not be generated for file '%s'", len, WX_STR(m_filename));
-		free_index(index);
-		InitZstates();
-		return false;
-	}
+	// No valid index file. Generate an index while the emulation starts, reads past the
+	// part already indexed decompress from the last access point found (and then sequentially).
+	Console.Warning(L"Scanning compressed file to generate a quick access index, seeking will be slower until it's done...");
 
+	bool ok = m_index.Build(m_filename, indexfile, GZFILE_SPAN_DEFAULT, m_readahead.Lock());
+	if (!ok)
+		Console.Error(L"ERROR: index could not be generated for file '%s'", WX_STR(m_filename));
+
+	std::lock_guard<std::mutex> lock(m_readahead.Lock());
 	InitZstates();
-	return true;
+	return ok;
 }
 
 bool GzippedFileReader::Open(const wxString& fileName) {
 	Close();
 	m_filename = fileName;
+	m_openTicks = GetCPUTicks();
 	if (!(m_src = PX_fopen_rb(m_filename)) || !CanHandle(fileName) || !OkIndex()) {
 		Close();
 		return false;
 	};
 
 	AsyncPrefetchOpen();
+	m_readahead.Start([this](u64 chunk) { return PrefetchChunk(chunk); }, GZFILE_READAHEAD_CHUNKS);
 	return true;
 };
 
 void GzippedFileReader::BeginRead(void* pBuffer, uint sector, uint count) {
-	// No a-sync support yet, implement as sync
-	mBytesRead = ReadSync(pBuffer, sector, count);
-	return;
+	// Still read synchronously, but the chunks are normally extracted ahead by
+	// m_readahead, so this mostly costs the copy.
+	PX_off_t offset = (s64)sector * m_blocksize + m_dataoffset;
+	PX_off_t last = offset + (s64)std::max(count, 1u) * m_blocksize - 1;
+
+	const u64 start = GetCPUTicks();
+	bool hit;
+	{
+		std::lock_guard<std::mutex> lock(m_readahead.Lock());
+		const u32 extracted = m_extracted;
+		mBytesRead = _ReadSync(pBuffer, offset, count * m_blocksize);
+		hit = m_extracted == extracted;
+	}
+	if (mBytesRead < 0)
+		Console.Error(L"Error: iso-gzip read unsuccessful.");
+	FirstRead();
+
+	m_readahead.Read(offset / GZFILE_READ_CHUNK_SIZE, last / GZFILE_READ_CHUNK_SIZE, hit, GetCPUTicks() - start);
 };
 
+// Called by m_readahead's thread, with its lock held
+int GzippedFileReader::PrefetchChunk(u64 chunk) {
+	PX_off_t offset = chunk * GZFILE_READ_CHUNK_SIZE;
+	if (offset >= m_index.GetUncompressedSize())
+		return -1;
+
+	if (m_cache.Has(offset))
+		return 0;
+
+	char dummy;
+	return _ReadSync(&dummy, offset, 1) < 0 ? -1 : 1;
+}
+
 int GzippedFileReader::FinishRead(void) {
 	int res = mBytesRead;
 	mBytesRead = -1;
@@ -356,15 +298,29 @@ int GzippedFileReader::FinishRead(void) {
 int GzippedFileReader::ReadSync(void* pBuffer, uint sector, uint count) {
 	PX_off_t offset = (s64)sector * m_blocksize + m_dataoffset;
 	int bytesToRead = count * m_blocksize;
+	std::unique_lock<std::mutex> lock(m_readahead.Lock());
 	int res = _ReadSync(pBuffer, offset, bytesToRead);
+	lock.unlock();
 	if (res < 0)
 		Console.Error(L"Error: iso-gzip read unsuccessful.");
+	FirstRead();
 	return res;
 }
 
+// Logs the time from Open to the first read, which the index has to be ready for
+void GzippedFileReader::FirstRead() {
+	if (!m_openTicks)
+		return;
+
+	Console.WriteLn(Color_Gray, L"gzip: first read %u ms after open, index %d%% built.",
+	                (u32)((GetCPUTicks() - m_openTicks) * 1000 / GetTickFrequency()),
+	                (int)(100 * m_index.GetProgress()));
+	m_openTicks = 0;
+}
+
 // If we have a valid and adequate zstate for this span, use it, else, use the index
 PX_off_t GzippedFileReader::GetOptimalExtractionStart(PX_off_t offset) {
-	int span = m_pIndex->span;
+	int span = m_index.GetSpan();
 	Czstate& cstate = m_zstates[offset / span];
 	PX_off_t stateOffset = cstate.state.isValid ? cstate.state.out_offset : 0;
 	if (stateOffset && stateOffset <= offset)
@@ -379,11 +335,15 @@ PX_off_t GzippedFileReader::GetOptimalExtractionStart(PX_off_t offset) {
 }
 
 int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRead) {
-	if (!OkIndex())
+	if (m_index.GetUncompressedSize() != m_zstatesSize)
+		InitZstates(); // the index build completed and corrected the estimated size
+	if (!m_zstates)
 		return -1;
+	if (offset >= m_zstatesSize)
+		return 0;
 
 	// Without all the caching, chunking and states, this would be enough:
-	// return extract(m_src, m_pIndex, offset, (unsigned char*)pBuffer, bytesToRead);
+	// return extract(m_src, m_index.GetPoint(offset), offset, (unsigned char*)pBuffer, bytesToRead, &state);
 
 	// Split request to GZFILE_READ_CHUNK_SIZE chunks at GZFILE_READ_CHUNK_SIZE boundaries
 	uint maxInChunk = GZFILE_READ_CHUNK_SIZE - offset % GZFILE_READ_CHUNK_SIZE;
@@ -412,15 +372,19 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 	int size = offset + maxInChunk - extractOffset;
 	unsigned char* extracted = (unsigned char*)malloc(size);
 
-	int span = m_pIndex->span;
+	int span = m_index.GetSpan();
 	int spanix = extractOffset / span;
+	Zstate* state = &m_zstates[spanix].state;
+	// The access point is only needed (and its window inflated) if there's no state to continue
+	const Point* here = state->isValid && state->out_offset == extractOffset ? NULL : m_index.GetPoint(extractOffset);
 	AsyncPrefetchCancel();
-	res = extract(m_src, m_pIndex, extractOffset, extracted, size, &(m_zstates[spanix].state));
+	res = extract(m_src, here, extractOffset, extracted, size, state);
 	if (res < 0) {
 		free(extracted);
 		return res;
 	}
 	AsyncPrefetchChunk(getInOffset(&(m_zstates[spanix].state)));
+	m_extracted++;
 
 	int copied = ChunksCache::CopyAvailable(extracted, extractOffset, res, pBuffer, offset, bytesToRead);
 
@@ -438,18 +402,12 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 		m_zstates[spanix].Kill();
 	}
 
-	if (size <= GZFILE_READ_CHUNK_SIZE)
-		m_cache.Take(extracted, extractOffset, res, size);
-	else { // split into cacheable chunks
-		for (int i = 0; i < size; i += GZFILE_READ_CHUNK_SIZE) {
-			int available = CLAMP(res - i, 0, GZFILE_READ_CHUNK_SIZE);
-			void* chunk = available ? malloc(available) : 0;
-			if (available)
-				memcpy(chunk, extracted + i, available);
-			m_cache.Take(chunk, extractOffset + i, available, std::min(size - i, GZFILE_READ_CHUNK_SIZE));
-		}
-		free(extracted);
+	// split into cacheable chunks
+	for (int i = 0; i < size; i += GZFILE_READ_CHUNK_SIZE) {
+		int available = CLAMP(res - i, 0, GZFILE_READ_CHUNK_SIZE);
+		m_cache.Take(extracted + i, extractOffset + i, available, std::min(size - i, GZFILE_READ_CHUNK_SIZE));
 	}
+	free(extracted);
 
 	int duration = NOW() - s;
 	if (duration > 10)
@@ -463,11 +421,15 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 }
 
 void GzippedFileReader::Close() {
+	m_readahead.Stop();
+	m_readahead.PrintStats("gzip");
+	m_readahead.ResetStats();
+	m_cache.PrintStats("gzip");
+	m_cache.ResetStats();
+
 	m_filename.Empty();
-	if (m_pIndex) {
-		free_index((Access*)m_pIndex);
-		m_pIndex = 0;
-	}
+	m_openTicks = 0;
+	m_index.Close();
 
 	InitZstates(); // results in delete because no index
 	m_cache.Clear();
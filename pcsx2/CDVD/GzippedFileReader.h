@@ -19,11 +19,14 @@ typedef struct zstate Zstate;
 
 #include "AsyncFileReader.h"
 #include "ChunksCache.h"
+#include "GzippedFileIndex.h"
+#include "ReadaheadThread.h"
 #include "zlib_indexed.h"
 
 #define GZFILE_SPAN_DEFAULT (1048576L * 4)   /* distance between direct access points when creating a new index */
 #define GZFILE_READ_CHUNK_SIZE (256 * 1024)  /* zlib extraction chunks size (at 0-based boundaries) */
 #define GZFILE_CACHE_SIZE_MB 200             /* cache size for extracted data. must be at least GZFILE_READ_CHUNK_SIZE (in MB)*/
+#define GZFILE_READAHEAD_CHUNKS 2            /* chunks extracted ahead of sequential reads */
 
 class GzippedFileReader : public AsyncFileReader
 {
@@ -47,7 +50,8 @@ public:
 	virtual uint GetBlockCount(void) const {
 		// type and formula copied from FlatFileReader
 		// FIXME? : Shouldn't it be uint and (size - m_dataoffset) / m_blocksize ?
-		return (int)((m_pIndex ? m_pIndex->uncompressed_size : 0) / m_blocksize);
+		// While the index is being built, the size is an estimate (see GzippedFileIndex)
+		return (int)(m_index.GetUncompressedSize() / m_blocksize);
 	};
 
 	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
@@ -65,17 +69,25 @@ private:
 		Zstate state;
 	};
 
-	bool	OkIndex();  // Verifies that we have an index, or try to create one
+	bool	OkIndex();  // Loads the index, or starts building one
 	PX_off_t GetOptimalExtractionStart(PX_off_t offset);
 	int     _ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRead);
+	int     PrefetchChunk(u64 chunk);
 	void	InitZstates();
+	void	FirstRead();
 
 	int		mBytesRead; // Temp sync read result when simulating async read
-	Access* m_pIndex;   // Quick access index
+	GzippedFileIndex m_index; // Quick access index
 	Czstate* m_zstates;
+	PX_off_t m_zstatesSize; // uncompressed size m_zstates was allocated for
+	u64		m_openTicks;  // until the first read completes
 	FILE*	m_src;
 
 	ChunksCache m_cache;
+	u32		m_extracted; // chunks extracted into m_cache, by either thread
+
+	// Everything above used by reads is guarded by m_readahead.Lock()
+	ReadaheadThread m_readahead;
 
 #ifdef _WIN32
 	// Used by async prefetch
@@ -17,9 +17,13 @@
 #include "PrecompiledHeader.h"
 #include "IopCommon.h"
 #include "IsoFileFormats.h"
+#include "ChunksCache.h"
+#include "CompressedFileReaderUtils.h"
 
 #include <errno.h>
 
+static FILE* s_lsn_trace = NULL;
+
 static const char* nameFromType(int type)
 {
     switch(type)
@@ -52,6 +56,9 @@ void InputIsoFile::BeginRead2(uint lsn)
 {
 	m_current_lsn = lsn;
 
+	if (s_lsn_trace)
+		fprintf(s_lsn_trace, "%u\n", lsn);
+
 	if (lsn >= m_blocks)
 	{
 		// While this usually indicates that the ISO is corrupted, some games do attempt
@@ -284,6 +291,100 @@ void InputIsoFile::Close()
 	m_reader = NULL;
 	
 	_init();
+
+	if (s_lsn_trace)
+		fflush(s_lsn_trace);
+}
+
+void InputIsoFile::SetLsnTrace(const wxString& tracefile)
+{
+	if (s_lsn_trace)
+		fclose(s_lsn_trace);
+
+	s_lsn_trace = tracefile.IsEmpty() ? NULL : wxFopen(tracefile, L"w");
+	if (!s_lsn_trace && !tracefile.IsEmpty())
+		Console.Error(L"isoFile error: Can't create the lsn trace file '%s'", WX_STR(tracefile));
+}
+
+// Replays the lsn trace through a ChunksCache of gzip sized chunks, without any data, to
+// measure the cache alone: hit rate and cost per lookup for a few cache sizes.
+static void BenchmarkChunksCache(const std::vector<u32>& trace, uint blocksize)
+{
+	static const uint limits[] = {16, 64, 200};
+	static const uint chunkSize = 256 * 1024;
+
+	for (uint limit : limits)
+	{
+		ChunksCache cache(chunkSize, limit);
+		u8 dummy[16];
+
+		const u64 start = GetCPUTicks();
+		for (u32 lsn : trace)
+		{
+			PX_off_t offset = (PX_off_t)lsn * blocksize;
+			if (cache.Read(dummy, offset, sizeof(dummy)) < 0)
+				cache.Insert(offset - offset % chunkSize, chunkSize, chunkSize);
+		}
+		const u64 ticks = GetCPUTicks() - start;
+
+		const ChunksCache::Stats& stats = cache.GetStats();
+		Console.WriteLn(L"ChunksCache %3u MB: %.1f%% hits, %u evictions, %u KB in use, %.0f ns/read",
+			limit, 100.0 * stats.hits / std::max<u64>(stats.hits + stats.misses, 1), (u32)stats.evictions,
+			(u32)(cache.GetMemoryUsage() / 1024), 1e9 * ticks / GetTickFrequency() / std::max<size_t>(trace.size(), 1));
+	}
+}
+
+void IsoBenchmark(const wxString& srcfile, const wxString& tracefile)
+{
+	std::vector<u32> trace;
+	if (FILE* fp = wxFopen(tracefile, L"r"))
+	{
+		uint lsn;
+		while (fscanf(fp, "%u", &lsn) == 1)
+			trace.push_back(lsn);
+		fclose(fp);
+	}
+
+	if (trace.empty())
+	{
+		Console.Error(L"isoFile error: No lsn trace in '%s'", WX_STR(tracefile));
+		return;
+	}
+
+	InputIsoFile iso;
+	try {
+		if (!iso.Open(srcfile))
+			return;
+	}
+	catch (BaseException& ex)
+	{
+		Console.Error(ex.FormatDiagnosticMessage());
+		return;
+	}
+
+	Console.WriteLn(L"Replaying %u reads on '%s'", (u32)trace.size(), WX_STR(srcfile));
+
+	u8 buffer[CD_FRAMESIZE_RAW];
+	u64 maxTicks = 0;
+	const u64 start = GetCPUTicks();
+	for (u32 lsn : trace)
+	{
+		const u64 readStart = GetCPUTicks();
+		iso.BeginRead2(lsn);
+		iso.FinishRead3(buffer, CDVD_MODE_2048);
+		maxTicks = std::max(maxTicks, GetCPUTicks() - readStart);
+	}
+	const u64 ticks = GetCPUTicks() - start;
+
+	const u64 freq = GetTickFrequency();
+	Console.WriteLn(L"%u ms total, %u us/read, max %u us",
+		(u32)(ticks * 1000 / freq), (u32)(ticks * 1000000 / freq / trace.size()), (u32)(maxTicks * 1000000 / freq));
+
+	// The readers print their readahead and cache stats when closed
+	const uint blocksize = iso.GetBlockSize();
+	iso.Close();
+
+	BenchmarkChunksCache(trace, blocksize);
 }
 
 bool InputIsoFile::IsOpened() const
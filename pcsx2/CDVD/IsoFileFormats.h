@@ -74,6 +74,7 @@ public:
 	isoType GetType() const		{ return m_type; }
 	uint GetBlockCount() const	{ return m_blocks; }	
 	int GetBlockOffset() const	{ return m_blockofs; }
+	uint GetBlockSize() const	{ return m_blocksize; }
 	
 	const wxString& GetFilename() const
 	{
@@ -89,6 +90,9 @@ public:
 
 	void BeginRead2(uint lsn);
 	int FinishRead3(u8* dest, uint mode);
+
+	// Records the lsn of every BeginRead2 to a text file, one per line (--isotrace)
+	static void SetLsnTrace(const wxString& tracefile);
 	
 protected:
 	void _init();
@@ -97,6 +101,10 @@ protected:
 	void FindParts();
 };
 
+// Replays a trace recorded with --isotrace on an ISO, and prints the read times and the
+// reader and cache stats (--isobench)
+extern void IsoBenchmark(const wxString& srcfile, const wxString& tracefile);
+
 class OutputIsoFile
 {
 	DeclareNoncopyableObject( OutputIsoFile );
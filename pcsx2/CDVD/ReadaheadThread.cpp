@@ -0,0 +1,108 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrecompiledHeader.h"
+#include "ReadaheadThread.h"
+
+void ReadaheadThread::Start(const std::function<int(u64 chunk)>& prefetch, u32 depth) {
+	Stop();
+	ResetStats();
+
+	m_prefetch = prefetch;
+	m_depth = depth;
+	m_last = ~0ull;
+	if (m_depth)
+		m_thread = std::thread(&ReadaheadThread::Run, this);
+}
+
+void ReadaheadThread::Stop() {
+	if (m_thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> queue(m_queue_lock);
+			m_exit = true;
+		}
+		m_queue_cv.notify_one();
+		m_thread.join();
+	}
+
+	m_exit = false;
+	m_next = m_end = 0;
+}
+
+void ReadaheadThread::Read(u64 first, u64 last, bool hit, u64 ticks) {
+	m_stats.reads++;
+	m_stats.hits += hit;
+	m_stats.stallTicks += ticks;
+	m_stats.maxStallTicks = std::max(m_stats.maxStallTicks, ticks);
+
+	// A read of the same or the next chunk is taken as sequential, anything else as a seek
+	const bool sequential = first == m_last || first == m_last + 1;
+	m_last = last;
+
+	if (!m_thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> queue(m_queue_lock);
+		if (!sequential) {
+			m_next = m_end = 0;
+			return;
+		}
+
+		// Keep what the worker already went through, the chunks are in the cache
+		m_next = std::max(m_next, last + 1);
+		m_end = last + 1 + m_depth;
+		if (m_next >= m_end)
+			return;
+	}
+	m_queue_cv.notify_one();
+}
+
+void ReadaheadThread::Run() {
+	std::unique_lock<std::mutex> queue(m_queue_lock);
+
+	while (true) {
+		m_queue_cv.wait(queue, [this] { return m_exit || m_next < m_end; });
+		if (m_exit)
+			break;
+
+		const u64 chunk = m_next++;
+		queue.unlock();
+
+		int res;
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			res = m_prefetch(chunk);
+		}
+
+		queue.lock();
+		if (res < 0 && m_next == chunk + 1)
+			m_next = m_end; // end of file, unless the reads have moved on meanwhile
+		else if (res > 0)
+			m_stats.prefetched++;
+	}
+}
+
+void ReadaheadThread::PrintStats(const char* name) const {
+	if (!m_stats.reads)
+		return;
+
+	const u64 freq = GetTickFrequency();
+	DevCon.WriteLn(Color_Gray, "%s readahead: %u reads, %.1f%% hits, %u us stall/read (max %u us), %u chunks prefetched",
+	               name, (u32)m_stats.reads, 100.0 * m_stats.hits / m_stats.reads,
+	               (u32)(m_stats.stallTicks * 1000000 / freq / m_stats.reads),
+	               (u32)(m_stats.maxStallTicks * 1000000 / freq),
+	               (u32)m_stats.prefetched);
+}
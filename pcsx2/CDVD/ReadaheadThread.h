@@ -0,0 +1,74 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Stall and prefetch counters of a compressed reader, printed when it is closed
+struct ReadaheadStats {
+	u64 reads;      // BeginRead calls
+	u64 hits;       // reads which didn't have to decompress anything themselves
+	u64 stallTicks; // time BeginRead kept the caller waiting, lock waits included
+	u64 maxStallTicks;
+	u64 prefetched; // chunks decompressed by the worker
+};
+
+// Decompresses the chunks (CSO frames, gzip extraction chunks) which follow a sequential
+// read on a worker thread, so that the next reads find them already in the reader's cache.
+//
+// The reader's cache and decompression state are shared with the worker and must only
+// be touched while holding Lock().  The prefetch callback is called with it held, it
+// decompresses the chunk into the cache and returns 1, or 0 if it was already there, or
+// -1 past the end of the file or on errors.
+class ReadaheadThread {
+	DeclareNoncopyableObject(ReadaheadThread);
+public:
+	ReadaheadThread() : m_depth(0), m_exit(false), m_next(0), m_end(0), m_last(~0ull) { ResetStats(); };
+	~ReadaheadThread() { Stop(); };
+
+	void Start(const std::function<int(u64 chunk)>& prefetch, u32 depth);
+	void Stop();
+
+	std::mutex& Lock() { return m_lock; };
+
+	// Called after each read of chunks [first, last], while not holding Lock().  Queues the
+	// next chunks if the read continued the previous one, else drops what's still queued.
+	void Read(u64 first, u64 last, bool hit, u64 ticks);
+
+	const ReadaheadStats& GetStats() const { return m_stats; };
+	void ResetStats() { memzero(m_stats); };
+	void PrintStats(const char* name) const;
+
+private:
+	void Run();
+
+	std::function<int(u64 chunk)> m_prefetch;
+	u32 m_depth;    // chunks kept decompressed ahead of the last read
+
+	std::thread m_thread;
+	std::mutex m_lock; // reader state
+	std::mutex m_queue_lock;
+	std::condition_variable m_queue_cv;
+	bool m_exit;
+	u64 m_next;     // queued chunks are [m_next, m_end)
+	u64 m_end;
+	u64 m_last;     // last chunk of the previous read, emulation thread only
+
+	ReadaheadStats m_stats;
+};
@@ -49,6 +49,8 @@ Comments) 1950 to 1952 in the files http://tools.ietf.org/html/rfc1950
       (Thanks to Mark Adler for suggesting the approach)
   - build_index(...) - added progress prints
   - CHUNK changed from 16k to 512k
+  - build_index(...) hands each access point to a callback instead of building the list,
+      and extract(...) takes the access point to start from. The list lives in GzippedFileIndex.
  */
 
 /* Illustrate the use of Z_BLOCK, inflatePrime(), and inflateSetDictionary()
@@ -133,99 +135,53 @@ __attribute__((packed))
 
 typedef struct point Point;
 
-/* access point list */
-struct access {
-    int have;           /* number of list entries filled in */
-    int size;           /* number of list entries allocated (only used internally during build)*/
-    struct point *list; /* allocated list */
-
-    s32 span;           /* once the index is built, holds the span size used to build it */
-    PX_off_t uncompressed_size; /* filled by build_index */
-}
-#ifndef _WIN32
-__attribute__((packed))
-#endif
-;
-
-typedef struct access Access;
-
 #ifdef _WIN32
 #    pragma pack(pop, indexData)
 #endif
 
-/* Deallocate an index built by build_index() */
-local void free_index(struct access *index)
-{
-    if (index != NULL) {
-        free(index->list);
-        free(index);
-    }
-}
+/* Called by build_index() for every access point, in order.  Returns non-zero to
+   abort the build. */
+typedef int (*addpoint_func)(void *opaque, const struct point *here);
 
-/* Add an entry to the access point list.  If out of memory, deallocate the
-   existing list and return NULL. */
-local struct access *addpoint(struct access *index, int bits,
+/* Fill in the access point, unwrapping the sliding window, and pass it on */
+local int addpoint(addpoint_func add, void *opaque, struct point *here, int bits,
     PX_off_t in, PX_off_t out, unsigned left, unsigned char *window)
 {
-    struct point *next;
-
-    /* if list is empty, create it (start with eight points) */
-    if (index == NULL) {
-        index = (Access*)malloc(sizeof(struct access));
-        if (index == NULL) return NULL;
-        index->list = (Point*)malloc(sizeof(struct point) << 3);
-        if (index->list == NULL) {
-            free(index);
-            return NULL;
-        }
-        index->size = 8;
-        index->have = 0;
-    }
-
-    /* if list is full, make it bigger */
-    else if (index->have == index->size) {
-        index->size <<= 1;
-        next = (Point*)realloc(index->list, sizeof(struct point) * index->size);
-        if (next == NULL) {
-            free_index(index);
-            return NULL;
-        }
-        index->list = next;
-    }
-
-    /* fill in entry and increment how many we have */
-    next = index->list + index->have;
-    next->bits = bits;
-    next->in = in;
-    next->out = out;
+    here->bits = bits;
+    here->in = in;
+    here->out = out;
     if (left)
-        memcpy(next->window, window + WINSIZE - left, left);
+        memcpy(here->window, window + WINSIZE - left, left);
     if (left < WINSIZE)
-        memcpy(next->window + left, window, WINSIZE - left);
-    index->have++;
-
-    /* return list, possibly reallocated */
-    return index;
+        memcpy(here->window + left, window, WINSIZE - left);
+    return add(opaque, here);
 }
 
-/* Make one entire pass through the compressed stream and build an index, with
-   access points about every span bytes of uncompressed output -- span is
-   chosen to balance the speed of random access against the memory requirements
-   of the list, about 32K bytes per access point.  Note that data after the end
-   of the first zlib or gzip stream in the file is ignored.  build_index()
-   returns the number of access points on success (>= 1), Z_MEM_ERROR for out
-   of memory, Z_DATA_ERROR for an error in the input file, or Z_ERRNO for a
-   file read error.  On success, *built points to the resulting index. */
-local int build_index(FILE *in, PX_off_t span, struct access **built)
+/* Make one entire pass through the compressed stream and find access points
+   about every span bytes of uncompressed output -- span is chosen to balance
+   the speed of random access against the memory requirements of the list,
+   about 32K bytes per access point.  Note that data after the end of the first
+   zlib or gzip stream in the file is ignored.  build_index() returns the
+   number of access points on success (>= 1), Z_MEM_ERROR for out of memory or
+   if add aborted the build, Z_DATA_ERROR for an error in the input file, or
+   Z_ERRNO for a file read error.  On success, *uncompressed_size holds the
+   size of the uncompressed data. */
+local int build_index(FILE *in, PX_off_t span, addpoint_func add, void *opaque,
+                      PX_off_t *uncompressed_size)
 {
     int ret;
-    PX_off_t totin, totout, totPrinted;     /* our own total counters to avoid 4GB limit */
+    PX_off_t totin, totout;     /* our own total counters to avoid 4GB limit */
     PX_off_t last;              /* totout value of last access point */
-    struct access *index;       /* access points being generated */
+    int have;                   /* access points found */
+    struct point *here;         /* access point being passed to add */
     z_stream strm;
     unsigned char input[CHUNK];
     unsigned char window[WINSIZE];
 
+    here = (Point*)malloc(sizeof(struct point));
+    if (here == NULL)
+        return Z_MEM_ERROR;
+
     /* initialize inflate */
     strm.zalloc = Z_NULL;
     strm.zfree = Z_NULL;
@@ -233,14 +189,16 @@ local int build_index(FILE *in, PX_off_t span, struct access **built)
     strm.avail_in = 0;
     strm.next_in = Z_NULL;
     ret = inflateInit2(&strm, 47);      /* automatic zlib or gzip decoding */
-    if (ret != Z_OK)
+    if (ret != Z_OK) {
+        free(here);
         return ret;
+    }
 
     /* inflate the input, maintain a sliding window, and build an index -- this
        also validates the integrity of the compressed data using the check
        information at the end of the gzip or zlib stream */
-    totin = totout = last = totPrinted = 0;
-    index = NULL;               /* will be allocated by first addpoint() */
+    totin = totout = last = 0;
+    have = 0;
     strm.avail_out = 0;
     do {
         /* get some compressed data from input file */
@@ -288,40 +246,28 @@ local int build_index(FILE *in, PX_off_t span, struct access **built)
              */
             if ((strm.data_type & 128) && !(strm.data_type & 64) &&
                 (totout == 0 || totout - last > span)) {
-                index = addpoint(index, strm.data_type & 7, totin,
-                                 totout, strm.avail_out, window);
-                if (index == NULL) {
+                if (addpoint(add, opaque, here, strm.data_type & 7, totin,
+                             totout, strm.avail_out, window)) {
                     ret = Z_MEM_ERROR;
                     goto build_index_error;
                 }
+                have++;
                 last = totout;
             }
         } while (strm.avail_in != 0);
-        if (totin / (50 * 1024 * 1024) != totPrinted / (50 * 1024 * 1024)) {
-            printf("%dMB ", (int)(totin / (1024 * 1024)));
-            totPrinted = totin;
-        }
     } while (ret != Z_STREAM_END);
 
-    if (index == NULL) {
-        // Could happen if the start of the stream in Z_STREAM_END
-        return 0;
-    }
-
-    /* clean up and return index (release unused entries in list) */
+    /* clean up and return the number of access points (0 could happen if the
+       start of the stream is Z_STREAM_END) */
     (void)inflateEnd(&strm);
-    index->list = (Point*)realloc(index->list, sizeof(struct point) * index->have);
-    index->size = index->have;
-    index->span = span;
-    index->uncompressed_size = totout;
-    *built = index;
-    return index->have;
+    free(here);
+    *uncompressed_size = totout;
+    return have;
 
     /* return error */
   build_index_error:
     (void)inflateEnd(&strm);
-    if (index != NULL)
-        free_index(index);
+    free(here);
     return ret;
 }
 
@@ -336,18 +282,19 @@ static inline PX_off_t getInOffset(zstate *state) {
 	return state->in_offset;
 }
 
-/* Use the index to read len bytes from offset into buf, return bytes read or
-   negative for error (Z_DATA_ERROR or Z_MEM_ERROR).  If data is requested past
+/* Use the access point here (the last one at or before offset) to read len
+   bytes from offset into buf, return bytes read or negative for error
+   (Z_DATA_ERROR or Z_MEM_ERROR).  here isn't used, and may be NULL, when state
+   continues at offset.  If data is requested past
    the end of the uncompressed data, then extract() will return a value less
    than len, indicating how much as actually read into buf.  This function
    should not return a data error unless the file was modified since the index
    was generated.  extract() may also return Z_ERRNO if there is an error on
    reading or seeking the input file. */
-local int extract(FILE *in, struct access *index, PX_off_t offset,
+local int extract(FILE *in, const struct point *here, PX_off_t offset,
                   unsigned char *buf, int len, zstate *state)
 {
     int ret, skip;
-    struct point *here;
     unsigned char input[CHUNK];
     unsigned char discard[WINSIZE];
     int isEnd = 0;
@@ -370,11 +317,8 @@ local int extract(FILE *in, struct access *index, PX_off_t offset,
         offset = 0;
         skip = 1;
     } else {
-        /* find where in stream to start */
-        here = index->list;
-        ret = index->have;
-        while (--ret && here[1].out <= offset)
-            here++;
+        if (here == NULL || here->out > offset)
+            return Z_DATA_ERROR;
 
         /* initialize file and inflate state to start there */
         state->strm.zalloc = Z_NULL;
@@ -247,6 +247,11 @@ struct Pcsx2Config
 				PreBlockCheckIOP:1;
 			bool
 				EnableEECache   :1;
+			bool
+				PersistentEEBlocks :1;	// precompile the blocks seen in previous sessions of the same game
+			bool
+				AsyncMicroVU1	:1,		// compile new VU1 programs on a worker thread, interpreting them meanwhile
+				PersistentVU1Programs :1;	// precompile the VU1 programs seen in previous sessions of the same game
 		BITFIELD_END
 
 		RecompilerOptions();
@@ -297,6 +302,7 @@ struct Pcsx2Config
 		bool	SynchronousMTGS;
 
 		int		VsyncQueueSize;
+		int		RingSizeFactor;		// MTGS ringbuffer size, as a power of 2 (in qwords)
 
 		bool		FrameLimitEnable;
 		bool		FrameSkipEnable;
@@ -319,6 +325,7 @@ struct Pcsx2Config
 			return
 				OpEqu( SynchronousMTGS )		&&
 				OpEqu( VsyncQueueSize )			&&
+				OpEqu( RingSizeFactor )			&&
 				
 				OpEqu( FrameSkipEnable )		&&
 				OpEqu( FrameLimitEnable )		&&
@@ -528,8 +535,11 @@ TraceLogFilters&				SetTraceConfig();
 #define THREAD_VU1					(EmuConfig.Cpu.Recompiler.UseMicroVU1 && EmuConfig.Speedhacks.vuThread)
 #define CHECK_MICROVU0				(EmuConfig.Cpu.Recompiler.UseMicroVU0)
 #define CHECK_MICROVU1				(EmuConfig.Cpu.Recompiler.UseMicroVU1)
+#define CHECK_MICROVU1_ASYNC		(EmuConfig.Cpu.Recompiler.AsyncMicroVU1 && !THREAD_VU1)
+#define CHECK_MICROVU1_PROGCACHE	(EmuConfig.Cpu.Recompiler.PersistentVU1Programs)
 #define CHECK_EEREC					(EmuConfig.Cpu.Recompiler.EnableEE && GetCpuProviders().IsRecAvailable_EE())
 #define CHECK_CACHE					(EmuConfig.Cpu.Recompiler.EnableEECache)
+#define CHECK_EEREC_BLOCKCACHE		(EmuConfig.Cpu.Recompiler.PersistentEEBlocks)
 #define CHECK_IOPREC				(EmuConfig.Cpu.Recompiler.EnableIOP && GetCpuProviders().IsRecAvailable_IOP())
 
 //------------ SPECIAL GAME FIXES!!! ---------------
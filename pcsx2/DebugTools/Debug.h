@@ -312,6 +312,7 @@ struct SysConsoleLogPack
 {
 	ConsoleLogSource		ELF;
 	ConsoleLogSource		eeRecPerf;
+	ConsoleLogSource		threadPerf;
 	ConsoleLogSource		sysoutConsole;
 
 	ConsoleLogFromVM<Color_Cyan>		eeConsole;
@@ -388,6 +389,7 @@ extern void __Log( const char* fmt, ... );
 
 #define ELF_LOG			SysConsole.ELF.IsActive()			&& SysConsole.ELF.Write
 #define eeRecPerfLog	SysConsole.eeRecPerf.IsActive()		&& SysConsole.eeRecPerf
+#define threadPerfLog	SysConsole.threadPerf.IsActive()	&& SysConsole.threadPerf
 #define eeConLog		SysConsole.eeConsole.IsActive()		&& SysConsole.eeConsole.Write
 #define eeDeci2Log		SysConsole.deci2.IsActive()			&& SysConsole.deci2.Write
 #define iopConLog		SysConsole.iopConsole.IsActive()	&& SysConsole.iopConsole.Write
@@ -298,6 +298,16 @@ enum MTGS_RingCommand
 };
 
 
+// Ring contention counters, reported every few frames with the ThreadPerf log source
+struct MTGS_RingStats
+{
+	std::atomic<u32>	Wakeups;			// MTGS thread wakeups requested (semaphore posts)
+	u32					ProducerStalls;		// Packets which had to wait for room in the ring (EE thread)
+	u64					ProducerStallTicks;
+	std::atomic<u64>	ConsumerIdleTicks;	// Time the MTGS thread slept waiting for packets
+	std::atomic<u32>	ConsumerSpinHits;	// Packets caught by spinning, without sleeping
+};
+
 struct MTGS_FreezeData
 {
 	freezeData*	fdata;
@@ -314,8 +324,15 @@ class SysMtgsThread : public SysThreadBase
 public:
 	// note: when m_ReadPos == m_WritePos, the fifo is empty
 	// Threading info: m_ReadPos is updated by the MTGS thread. m_WritePos is updated by the EE thread
-	std::atomic<unsigned int> m_ReadPos;  // cur pos gs is reading from
-	std::atomic<unsigned int> m_WritePos; // cur pos ee thread is writing to
+	// (each on its own cache line, so the two threads don't keep stealing it from each other)
+	__aligned(64) std::atomic<unsigned int> m_ReadPos;  // cur pos gs is reading from
+	__aligned(64) std::atomic<unsigned int> m_WritePos; // cur pos ee thread is writing to
+	uint			m_CachedReadPos;	// last m_ReadPos seen by the EE thread (only reloaded when the ring looks full)
+
+	MTGS_RingStats	m_Stats;
+	u64				m_StatsStart;		// Start of the stats reporting window (EE thread)
+	uint			m_StatsFrames;
+	__aligned(64) uint m_SpinCount;		// Polls of m_WritePos before the MTGS thread sleeps (MTGS thread)
 
 	std::atomic<bool>	m_RingBufferIsBusy;
 	std::atomic<bool>	m_SignalRingEnable;
@@ -390,6 +407,10 @@ protected:
 	void OnCleanupInThread();
 
 	void GenericStall( uint size );
+	void ApplyRingSize();
+	void UpdateStats();
+	bool SpinForPackets();
+	bool IsRingBusy();
 
 	// Used internally by SendSimplePacket type functions
 	void _FinishSimplePacket();
@@ -460,18 +481,24 @@ extern int g_nLeftGSFrames;
 // (actual size is 1<<m_RingBufferSizeFactor simd vectors [128-bit values])
 // A value of 19 is a 8meg ring buffer.  18 would be 4 megs, and 20 would be 16 megs.
 // Default was 2mb, but some games with lots of MTGS activity want 8mb to run fast (rama)
-static const uint RingBufferSizeFactor = 19;
+// The size in use is picked by EmuConfig.GS.RingSizeFactor when the MTGS thread is started
+// (plugin init); the storage is always allocated at the max size.  The minimum has to hold
+// the biggest single packet: a GIF path flushes up to its _1mb+_1kb safe zone (Gif_Unit.h)
+// at once, and GenericStall can't make room for a packet bigger than the ring.
+static const uint RingBufferSizeFactorMin = 17;
+static const uint RingBufferSizeFactorMax = 19;
+static const uint RingBufferSizeMax = 1<<RingBufferSizeFactorMax;
 
 // size of the ringbuffer in simd128's.
-static const uint RingBufferSize = 1<<RingBufferSizeFactor;
+extern uint RingBufferSize;
 
 // Mask to apply to ring buffer indices to wrap the pointer from end to
 // start (the wrapping is what makes it a ringbuffer, yo!)
-static const uint RingBufferMask = RingBufferSize - 1;
+extern uint RingBufferMask;
 
 struct MTGS_BufferedData
 {
-	u128		m_Ring[RingBufferSize];
+	u128		m_Ring[RingBufferSizeMax];
 	u8			Regs[Ps2MemSize::GSregs];
 
 	MTGS_BufferedData() {}
@@ -41,8 +41,17 @@ using namespace Threading;
 // =====================================================================================================
 
 __aligned(32) MTGS_BufferedData RingBuffer;
+uint RingBufferSize = RingBufferSizeMax;
+uint RingBufferMask = RingBufferSizeMax - 1;
 extern bool renderswitch;
 
+// Bounds of the MTGS thread's spin for new packets before it sleeps (see SpinForPackets)
+static const uint MtgsSpinMin = 16;
+static const uint MtgsSpinMax = 4096;
+
+// Number of vsyncs the ring stats are accumulated over before being logged
+static const uint MtgsStatsFrames = 60;
+
 
 #ifdef RINGBUF_DEBUG_STACK
 #include <list>
@@ -66,6 +75,7 @@ void SysMtgsThread::OnStart()
 
 	m_ReadPos			= 0;
 	m_WritePos			= 0;
+	m_CachedReadPos		= 0;
 	m_RingBufferIsBusy  = false;
 	m_packet_size		= 0;
 	m_packet_writepos	= 0;
@@ -76,6 +86,17 @@ void SysMtgsThread::OnStart()
 	m_SignalRingPosition  = 0;
 
 	m_CopyDataTally		= 0;
+	m_SpinCount			= MtgsSpinMin;
+
+	m_Stats.Wakeups				= 0;
+	m_Stats.ProducerStalls		= 0;
+	m_Stats.ProducerStallTicks	= 0;
+	m_Stats.ConsumerIdleTicks	= 0;
+	m_Stats.ConsumerSpinHits	= 0;
+	m_StatsStart		= GetCPUTicks();
+	m_StatsFrames		= 0;
+
+	ApplyRingSize();
 
 	_parent::OnStart();
 }
@@ -103,6 +124,7 @@ void SysMtgsThread::ResetGS()
 	//  * clear the path and byRegs structs (used by GIFtagDummy)
 
 	m_ReadPos             = m_WritePos.load();
+	m_CachedReadPos       = m_ReadPos.load();
 	m_QueuedFrameCount    = 0;
 	m_VsyncSignalListener = 0;
 
@@ -112,6 +134,43 @@ void SysMtgsThread::ResetGS()
 	SetEvent();
 }
 
+// Resizes the ring to EmuConfig.GS.RingSizeFactor.  Only called from OnStart(), before the
+// MTGS thread exists: RingBufferSize/Mask aren't atomic and the thread reads them while it
+// polls the ring, so they can't change under a running thread (not even on a GS reset).
+void SysMtgsThread::ApplyRingSize()
+{
+	const uint factor = std::min(std::max<uint>(EmuConfig.GS.RingSizeFactor, RingBufferSizeFactorMin), RingBufferSizeFactorMax);
+	if ((1u << factor) == RingBufferSize) return;
+
+	RingBufferSize = 1u << factor;
+	RingBufferMask = RingBufferSize - 1;
+
+	DevCon.WriteLn( "MTGS: Ringbuffer size set to %u KB", (RingBufferSize * 16) / _1kb );
+}
+
+// Logs the ring counters once every MtgsStatsFrames vsyncs (EE thread).
+void SysMtgsThread::UpdateStats()
+{
+	if (++m_StatsFrames < MtgsStatsFrames) return;
+
+	const u64 now     = GetCPUTicks();
+	const u64 elapsed = std::max<u64>(now - m_StatsStart, 1);
+	const u64 freq    = GetTickFrequency();
+
+	const u32 wakeups  = m_Stats.Wakeups.exchange(0, std::memory_order_relaxed);
+	const u64 idle     = m_Stats.ConsumerIdleTicks.exchange(0, std::memory_order_relaxed);
+	const u32 spinHits = m_Stats.ConsumerSpinHits.exchange(0, std::memory_order_relaxed);
+
+	threadPerfLog.Write( "MTGS: %u stalls/frame (%u us), %u wakeups/frame, %u spin hits/frame, GS thread idle %u%%",
+		m_Stats.ProducerStalls / m_StatsFrames, (u32)(m_Stats.ProducerStallTicks * 1000000 / freq),
+		wakeups / m_StatsFrames, spinHits / m_StatsFrames, (u32)(std::min(idle, elapsed) * 100 / elapsed) );
+
+	m_Stats.ProducerStalls     = 0;
+	m_Stats.ProducerStallTicks = 0;
+	m_StatsStart  = now;
+	m_StatsFrames = 0;
+}
+
 struct RingCmdPacket_Vsync
 {
 	u8				regset1[0x0f0];
@@ -142,6 +201,8 @@ void SysMtgsThread::PostVsyncStart()
 	// Vsyncs should always start the GS thread, regardless of how little has actually be queued.
 	if (m_CopyDataTally != 0) SetEvent();
 
+	UpdateStats();
+
 	// If the MTGS is allowed to queue a lot of frames in advance, it creates input lag.
 	// Use the Queued FrameCount to stall the EE if another vsync (or two) are already queued
 	// in the ringbuffer.  The queue limit is disabled when both FrameLimiting and Vsync are
@@ -162,6 +223,7 @@ void SysMtgsThread::PostVsyncStart()
 	// To avoid this potential deadlock, ring must be wake up after m_VsyncSignalListener
 	// Note: potentially we can also miss the previous wake up if we optimize away the post just before the release of busy signal of the ring
 	// So let's ensure the ring doesn't sleep
+	m_Stats.Wakeups.fetch_add(1, std::memory_order_relaxed);
 	m_sem_event.Post();
 
 	m_sem_Vsync.WaitNoCancel();
@@ -271,6 +333,49 @@ class RingBufferLock {
 	}
 };
 
+// Polls the ring for new packets for a little while, since the EE usually queues the next
+// ones within microseconds and a sleep/wakeup round trip on the semaphore costs more than
+// that.  The ring is flagged busy meanwhile, so the EE doesn't post wakeups for packets
+// that are going to be caught anyway.  The poll count adapts to how often it pays off.
+// Returns false if nothing came (and the thread should sleep).
+bool SysMtgsThread::SpinForPackets()
+{
+	m_RingBufferIsBusy.store(true, std::memory_order_relaxed);
+
+	for (uint i = 0; i < m_SpinCount; ++i)
+	{
+		if (m_ReadPos.load(std::memory_order_relaxed) != m_WritePos.load(std::memory_order_acquire))
+		{
+			m_SpinCount = std::min(m_SpinCount * 2, MtgsSpinMax);
+			m_Stats.ConsumerSpinHits.fetch_add(1, std::memory_order_relaxed);
+			m_RingBufferIsBusy.store(false, std::memory_order_relaxed);
+			return true;
+		}
+		SpinWait();
+	}
+
+	m_SpinCount = std::max(m_SpinCount / 2, MtgsSpinMin);
+
+	// Check once more after clearing the flag, so that packets queued while it was set
+	// (without a wakeup) aren't left waiting for the next one.  Pairs with the fence in
+	// IsRingBusy: either the EE sees the flag cleared, or this sees its m_WritePos.
+	m_RingBufferIsBusy.store(false, std::memory_order_seq_cst);
+	return m_ReadPos.load(std::memory_order_relaxed) != m_WritePos.load(std::memory_order_seq_cst);
+}
+
+// True when the MTGS thread is processing or polling the ring, and will pick up everything
+// committed to m_WritePos so far without a wakeup.  A flag seen set is reloaded after a full
+// fence, so that the m_WritePos store before the call can't be reordered after the load; this
+// is only paid for while the MTGS thread is busy.
+bool SysMtgsThread::IsRingBusy()
+{
+	if (!m_RingBufferIsBusy.load(std::memory_order_relaxed))
+		return false;
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	return m_RingBufferIsBusy.load(std::memory_order_relaxed);
+}
+
 void SysMtgsThread::ExecuteTaskInThread()
 {
 	// Threading info: run in MTGS thread
@@ -289,7 +394,12 @@ void SysMtgsThread::ExecuteTaskInThread()
 		// is very optimized (only 1 instruction test in most cases), so no point in trying
 		// to avoid it.
 
-		m_sem_event.WaitWithoutYield();
+		if (!SpinForPackets())
+		{
+			const u64 idleStart = GetCPUTicks();
+			m_sem_event.WaitWithoutYield();
+			m_Stats.ConsumerIdleTicks.fetch_add(GetCPUTicks() - idleStart, std::memory_order_relaxed);
+		}
 		StateCheckInThread();
 		busy.Acquire();
 
@@ -639,8 +749,11 @@ void SysMtgsThread::WaitGS(bool syncRegs, bool weakWait, bool isMTVU)
 // For use in loops that wait on the GS thread to do certain things.
 void SysMtgsThread::SetEvent()
 {
-	if(!m_RingBufferIsBusy.load(std::memory_order_relaxed))
+	if(!IsRingBusy())
+	{
+		m_Stats.Wakeups.fetch_add(1, std::memory_order_relaxed);
 		m_sem_event.Post();
+	}
 
 	m_CopyDataTally = 0;
 }
@@ -669,7 +782,7 @@ void SysMtgsThread::SendDataPacket()
 	{
 		WaitGS();
 	}
-	else if(!m_RingBufferIsBusy.load(std::memory_order_relaxed))
+	else if(!IsRingBusy())
 	{
 		m_CopyDataTally += m_packet_size;
 		if( m_CopyDataTally > 0x2000 ) SetEvent();
@@ -687,6 +800,19 @@ void SysMtgsThread::GenericStall( uint size )
 	// except for calls to RingbufferRestert() -- handled below.
 	const uint writepos = m_WritePos.load(std::memory_order_relaxed);
 
+	// The cached read position lags behind the MTGS thread, so the free room it gives is
+	// never more than the real one.  The shared m_ReadPos cache line is only read when
+	// that isn't enough for the packet.
+	uint readpos = m_CachedReadPos;
+	uint freeroom;
+
+	if (writepos < readpos)
+		freeroom = readpos - writepos;
+	else
+		freeroom = RingBufferSize - (writepos - readpos);
+
+	if (freeroom > size) return;
+
 	// Sanity checks! (within the confines of our ringbuffer please!)
 	pxAssert( size < RingBufferSize );
 	pxAssert( writepos < RingBufferSize );
@@ -696,8 +822,8 @@ void SysMtgsThread::GenericStall( uint size )
 	// But if not then we need to make sure the readpos is outside the scope of
 	// the block about to be written (writepos + size)
 
-	uint readpos = m_ReadPos.load(std::memory_order_acquire);
-	uint freeroom;
+	readpos = m_ReadPos.load(std::memory_order_acquire);
+	m_CachedReadPos = readpos;
 
 	if (writepos < readpos)
 		freeroom = readpos - writepos;
@@ -706,6 +832,8 @@ void SysMtgsThread::GenericStall( uint size )
 
 	if (freeroom <= size)
 	{
+		const u64 stallStart = GetCPUTicks();
+
 		// writepos will overlap readpos if we commit the data, so we need to wait until
 		// readpos is out past the end of the future write pos, or until it wraps around
 		// (in which case writepos will be >= readpos).
@@ -761,6 +889,10 @@ void SysMtgsThread::GenericStall( uint size )
 				if (freeroom > size) break;
 			}
 		}
+
+		m_CachedReadPos = readpos;
+		m_Stats.ProducerStalls++;
+		m_Stats.ProducerStallTicks += GetCPUTicks() - stallStart;
 	}
 }
 
@@ -825,7 +957,7 @@ void SysMtgsThread::SendSimpleGSPacket(MTGS_RingCommand type, u32 offset, u32 si
 	SendSimplePacket(type, (int)offset, (int)size, (int)path);
 
 	if(!EmuConfig.GS.SynchronousMTGS) {
-		if(!m_RingBufferIsBusy.load(std::memory_order_relaxed)) {
+		if(!IsRingBusy()) {
 			m_CopyDataTally += size / 16;
 			if (m_CopyDataTally > 0x2000) SetEvent();
 		}
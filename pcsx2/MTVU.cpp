@@ -24,6 +24,15 @@ __aligned16 VU_Thread vu1Thread(CpuVU1, VU1);
 #define MTVU_ALWAYS_KICK 0
 #define MTVU_SYNC_MODE   0
 
+// Bounds of the adaptive spins of both threads (in polls), and number of yields the
+// EE thread does after spinning before it sleeps
+static const u32 MtvuSpinMin    = 16;
+static const u32 MtvuSpinMax    = 4096;
+static const u32 MtvuYieldCount = 8;
+
+// Number of vsyncs the stats are accumulated over before being logged
+static const u32 MtvuStatsFrames = 60;
+
 // Rounds up a size in bytes for size in u32's
 static __fi u32 size_u32(u32 x) { return (x + 3) >> 2; }
 
@@ -38,6 +47,28 @@ enum MTVU_EVENT {
 	MTVU_RESET
 };
 
+// Polls done() up to spinCount times, then yields a few times, and returns false if it
+// still isn't done (the caller then sleeps).  The spin count doubles when spinning was
+// enough and halves when it wasn't, so it settles to how long the other thread takes.
+template<typename T>
+static bool MTVU_SpinWait(u32& spinCount, T done)
+{
+	for (u32 i = 0; i < spinCount; ++i) {
+		if (done()) {
+			spinCount = std::min(spinCount * 2, MtvuSpinMax);
+			return true;
+		}
+		SpinWait();
+	}
+	spinCount = std::max(spinCount / 2, MtvuSpinMin);
+
+	for (u32 i = 0; i < MtvuYieldCount; ++i) {
+		std::this_thread::yield();
+		if (done()) return true;
+	}
+	return false;
+}
+
 // Calls the vif unpack functions from the MTVU thread
 static void MTVU_Unpack(void* data, VIFregisters& vifRegs)
 {
@@ -85,6 +116,16 @@ void VU_Thread::Reset()
 	m_write_pos     = 0;
 	m_ato_read_pos  = 0;
 	m_read_pos      = 0;
+	m_vuSpinCount   = MtvuSpinMin;
+	m_eeSpinCount   = MtvuSpinMin;
+	stats.waitVUCount   = 0;
+	stats.waitVUTicks   = 0;
+	stats.waitSizeCount = 0;
+	stats.waitSizeTicks = 0;
+	stats.idleTicks     = 0;
+	stats.spinHits      = 0;
+	stats.start         = GetCPUTicks();
+	stats.frames        = 0;
 	memzero(vif);
 	memzero(vifRegs);
 	for (size_t i = 0; i < 4; ++i)
@@ -98,10 +139,37 @@ void VU_Thread::ExecuteTaskInThread()
 	} PCSX2_PAGEFAULT_EXCEPT;
 }
 
+// Polls the ring for a little while before the VU thread goes to sleep, since the EE
+// often sends the next packets right away.  isBusy is set meanwhile, so KickStart()
+// doesn't post wakeups for packets that are going to be caught anyway.
+bool VU_Thread::SpinForPackets()
+{
+	isBusy.store(true, std::memory_order_relaxed);
+	for (u32 i = 0; i < m_vuSpinCount; ++i) {
+		if (m_ato_read_pos.load(std::memory_order_relaxed) != GetWritePos()) {
+			m_vuSpinCount = std::min(m_vuSpinCount * 2, MtvuSpinMax);
+			stats.spinHits.fetch_add(1, std::memory_order_relaxed);
+			isBusy.store(false, std::memory_order_relaxed);
+			return true;
+		}
+		SpinWait();
+	}
+	m_vuSpinCount = std::max(m_vuSpinCount / 2, MtvuSpinMin);
+
+	// Check once more after clearing isBusy, for packets committed while it was set.  Pairs
+	// with the fence in KickStart(): either the EE sees isBusy cleared, or this sees its packets.
+	isBusy.store(false, std::memory_order_seq_cst);
+	return m_ato_read_pos.load(std::memory_order_relaxed) != m_ato_write_pos.load(std::memory_order_seq_cst);
+}
+
 void VU_Thread::ExecuteRingBuffer()
 {
 	for(;;) {
-		semaEvent.WaitWithoutYield();
+		if (!SpinForPackets()) {
+			u64 idleStart = GetCPUTicks();
+			semaEvent.WaitWithoutYield();
+			stats.idleTicks.fetch_add(GetCPUTicks() - idleStart, std::memory_order_relaxed);
+		}
 		ScopedLockBool lock(mtxBusy, isBusy);
 		while (m_ato_read_pos.load(std::memory_order_relaxed) != GetWritePos()) {
 			u32 tag = Read();
@@ -163,24 +231,29 @@ void VU_Thread::ExecuteRingBuffer()
 // Should only be called by ReserveSpace()
 __ri void VU_Thread::WaitOnSize(s32 size)
 {
-	for(;;) {
+	auto hasRoom = [&]() {
 		s32 readPos  = GetReadPos();
-		if (readPos <= m_write_pos) break; // MTVU is reading in back of write_pos
+		if (readPos <= m_write_pos) return true; // MTVU is reading in back of write_pos
 		// FIXME greg: there is a bug somewhere in the queue pointer
 		// management. It creates a deadlock/corruption in SotC intro (before
 		// the first menu). I added a 4KB safety net which seem to avoid to
 		// trigger the bug.
 		// Note: a wait lock instead of a yield also helps to avoid the bug.
-		if (readPos >  m_write_pos + size + _4kb) break; // Enough free front space
-		{ // Let MTVU run to free up buffer space
-			KickStart();
-			// Locking might trigger a full flush of the ring buffer. Yield
-			// will be more aggressive, and only flush the minimal size.
-			// Performance will be smoother but it will consume extra CPU cycle
-			// on the EE thread (not an issue on 4 cores).
-			std::this_thread::yield();
-		}
+		return readPos > m_write_pos + size + _4kb; // Enough free front space
+	};
+	if (hasRoom()) return;
+
+	u64 start = GetCPUTicks();
+	for(;;) { // Let MTVU run to free up buffer space
+		KickStart();
+		// Locking might trigger a full flush of the ring buffer. Spinning and
+		// yielding will be more aggressive, and only flush the minimal size.
+		// Performance will be smoother but it will consume extra CPU cycle
+		// on the EE thread (not an issue on 4 cores).
+		if (MTVU_SpinWait(m_eeSpinCount, hasRoom)) break;
 	}
+	stats.waitSizeCount++;
+	stats.waitSizeTicks += GetCPUTicks() - start;
 }
 
 // Makes sure theres enough room in the ring buffer
@@ -295,8 +368,16 @@ u32 VU_Thread::Get_vuCycles()
 
 void VU_Thread::KickStart(bool forceKick)
 {
+	// A set isBusy is reloaded after a full fence, so the load can't move before the
+	// m_ato_write_pos store of CommitWritePos(); only paid while the VU thread is busy.
+	bool busy = isBusy.load(std::memory_order_acquire);
+	if (busy) {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		busy = isBusy.load(std::memory_order_relaxed);
+	}
+
 	if ((forceKick && !semaEvent.Count())
-	|| (!isBusy.load(std::memory_order_acquire) && GetReadPos() != m_ato_write_pos.load(std::memory_order_relaxed))) semaEvent.Post();
+	|| (!busy && GetReadPos() != m_ato_write_pos.load(std::memory_order_relaxed))) semaEvent.Post();
 }
 
 bool VU_Thread::IsDone()
@@ -307,14 +388,43 @@ bool VU_Thread::IsDone()
 void VU_Thread::WaitVU()
 {
 	MTVU_LOG("MTVU - WaitVU!");
+	if (IsDone()) return;
+
+	u64 start = GetCPUTicks();
 	for(;;) {
-		if (IsDone()) break;
 		//DevCon.WriteLn("WaitVU()");
 		pxAssert(THREAD_VU1);
 		KickStart();
-		std::this_thread::yield(); // Give a chance to the MTVU thread to actually start
+		// Give a chance to the MTVU thread to actually start (and often finish)
+		if (MTVU_SpinWait(m_eeSpinCount, [this]() { return IsDone(); })) break;
 		ScopedLock lock(mtxBusy);
+		if (IsDone()) break;
 	}
+	stats.waitVUCount++;
+	stats.waitVUTicks += GetCPUTicks() - start;
+}
+
+void VU_Thread::UpdateStats()
+{
+	if (++stats.frames < MtvuStatsFrames) return;
+
+	const u64 now     = GetCPUTicks();
+	const u64 elapsed = std::max<u64>(now - stats.start, 1);
+	const u64 freq    = GetTickFrequency();
+	const u64 idle    = stats.idleTicks.exchange(0, std::memory_order_relaxed);
+	const u32 hits    = stats.spinHits.exchange(0, std::memory_order_relaxed);
+
+	threadPerfLog.Write("MTVU: %u WaitVU/frame (%u us), %u ring full/frame (%u us), %u spin hits/frame, VU thread idle %u%%",
+		stats.waitVUCount / stats.frames, (u32)(stats.waitVUTicks * 1000000 / freq),
+		stats.waitSizeCount / stats.frames, (u32)(stats.waitSizeTicks * 1000000 / freq),
+		hits / stats.frames, (u32)(std::min(idle, elapsed) * 100 / elapsed));
+
+	stats.waitVUCount   = 0;
+	stats.waitVUTicks   = 0;
+	stats.waitSizeCount = 0;
+	stats.waitSizeTicks = 0;
+	stats.start  = now;
+	stats.frames = 0;
 }
 
 void VU_Thread::ExecuteVU(u32 vu_addr, u32 vif_top, u32 vif_itop)
@@ -22,6 +22,18 @@
 #define MTVU_LOG(...) do{} while(0)
 //#define MTVU_LOG DevCon.WriteLn
 
+// Wait/idle counters of the MTVU ring, reported every few frames with the ThreadPerf log source
+struct VU_ThreadStats {
+	u32 waitVUCount;				// EE thread waits for MTVU to finish (WaitVU)
+	u64 waitVUTicks;
+	u32 waitSizeCount;				// EE thread waits for ring space (WaitOnSize)
+	u64 waitSizeTicks;
+	std::atomic<u64> idleTicks;		// VU thread asleep waiting for packets
+	std::atomic<u32> spinHits;		// Packets the VU thread caught while spinning, without sleeping
+	u64 start;						// Start of the reporting window
+	u32 frames;
+};
+
 // Notes:
 // - This class should only be accessed from the EE thread...
 // - buffer_size must be power of 2
@@ -35,7 +47,10 @@ class VU_Thread : public pxThread {
 	__aligned(64) std::atomic<int> m_ato_read_pos; // Only modified by VU thread
 	__aligned(64) std::atomic<int> m_ato_write_pos;    // Only modified by EE thread
 	__aligned(64) int  m_read_pos; // temporary read pos (local to the VU thread)
-	int  m_write_pos; // temporary write pos (local to the EE thread)
+	u32  m_vuSpinCount;               // polls before the VU thread sleeps (local to the VU thread)
+	__aligned(64) int  m_write_pos; // temporary write pos (local to the EE thread)
+	u32  m_eeSpinCount;               // polls before the EE thread yields (local to the EE thread)
+	VU_ThreadStats stats;
 	Mutex     mtxBusy;
 	Semaphore semaEvent;
 	BaseVUmicroCPU*& vuCPU;
@@ -62,6 +77,9 @@ public:
 	// Waits till MTVU is done processing
 	void WaitVU();
 
+	// Logs the wait/idle counters every few frames (called on vsync by the EE thread)
+	void UpdateStats();
+
 	void ExecuteVU(u32 vu_addr, u32 vif_top, u32 vif_itop);
 
 	void VifUnpack(vifStruct& _vif, VIFregisters& _vifRegs, u8* data, u32 size);
@@ -81,6 +99,7 @@ protected:
 
 private:
 	void ExecuteRingBuffer();
+	bool SpinForPackets();
 
 	void WaitOnSize(s32 size);
 	void ReserveSpace(s32 size);
@@ -891,6 +891,16 @@ void eeMemoryReserve::Release()
 // code below.
 //
 
+// Sub-page tracking:
+// Games that keep data next to their code fault on every data write, and clearing the whole
+// page each time makes them recompile the same blocks over and over.  Once a page has been
+// through a fault and gets re-protected, the recompiler emits a cheap prologue in the blocks
+// of that page that tests the page's dirty flag (see mmap_HasSubPageChecks).  A later fault
+// then only clears the blocks overlapping the written 128 byte chunk, and marks the page
+// dirty: the surviving blocks verify their own code on entry until the page is re-protected.
+//
+static const uint CodeChunkShift = 7;		// 128 byte chunks, 32 per page
+
 struct vtlb_PageProtectionInfo
 {
 	// Ram De-mapping -- used to convert fully translated/mapped offsets (which reside with
@@ -901,9 +911,27 @@ struct vtlb_PageProtectionInfo
 	u32 ReverseRamMap;
 
 	vtlb_ProtectionMode Mode;
+
+	// One bit per 128 byte chunk containing recompiled code.
+	u32 CodeChunks;
+
+	// Set when the page was re-protected after a fault; every block compiled on it since
+	// checks the dirty flag.
+	bool SubPageChecks;
+
+	// Statistics (see mmap_PrintProtectionStats)
+	u32 Faults;			// write faults
+	u32 PageClears;		// faults that cleared every block of the page
+	u32 Compiles;		// blocks compiled from this page
 };
 
 static __aligned16 vtlb_PageProtectionInfo m_PageProtectInfo[Ps2MemSize::MainRam >> 12];
+static __aligned16 u8 m_PageDirty[Ps2MemSize::MainRam >> 12];
+
+static __fi int mmap_GetRamPage( u32 paddr )
+{
+	return ((uptr)PSM( paddr & ~0xfff ) - (uptr)eeMem->Main) >> 12;
+}
 
 
 // returns:
@@ -950,10 +978,77 @@ void mmap_MarkCountedRamPage( u32 paddr )
 		paddr>>12
 	);
 
+	// Re-protecting a page that was under manual protection: the recompiler has cleared or
+	// verified every unchecked block of the page, so new blocks can use sub-page checks.
+	if( m_PageProtectInfo[rampage].Mode == ProtMode_Manual )
+		m_PageProtectInfo[rampage].SubPageChecks = true;
+
 	m_PageProtectInfo[rampage].Mode = ProtMode_Write;
+	m_PageDirty[rampage] = 0;
 	HostSys::MemProtect( &eeMem->Main[rampage<<12], __pagesize, PageAccess_ReadOnly() );
 }
 
+// paddr - physically mapped PS2 address of a block being recompiled, size in bytes.
+// Records the chunks holding code for sub-page invalidation.
+void mmap_MarkCodeChunks( u32 paddr, u32 size )
+{
+	pxAssert( eeMem && size );
+
+	int rampage = mmap_GetRamPage( paddr );
+	if( (uint)rampage >= (Ps2MemSize::MainRam >> 12) ) return;
+
+	const uint first = (paddr & 0xfff) >> CodeChunkShift;
+	const uint last  = ((paddr & 0xfff) + size - 1) >> CodeChunkShift;
+
+	for( uint i = first; i <= last && i < 32; ++i )
+		m_PageProtectInfo[rampage].CodeChunks |= 1u << i;
+
+	m_PageProtectInfo[rampage].Compiles++;
+}
+
+// Returns true if blocks recompiled from this (write protected) page must test the dirty
+// flag returned by mmap_GetPageDirtyFlag on entry.
+bool mmap_HasSubPageChecks( u32 paddr )
+{
+	pxAssert( eeMem );
+
+	int rampage = mmap_GetRamPage( paddr );
+	if( (uint)rampage >= (Ps2MemSize::MainRam >> 12) ) return false;
+
+	return m_PageProtectInfo[rampage].SubPageChecks;
+}
+
+const u8* mmap_GetPageDirtyFlag( u32 paddr )
+{
+	return &m_PageDirty[mmap_GetRamPage( paddr )];
+}
+
+// Logs the pages with the most write faults -- the ones where code and data share a page.
+void mmap_PrintProtectionStats()
+{
+	static const int TopCount = 8;
+
+	std::vector<std::pair<u32, int>> pages;
+	for( int i = 0; i < (int)ArraySize(m_PageProtectInfo); ++i )
+	{
+		if( m_PageProtectInfo[i].Faults )
+			pages.push_back( std::make_pair( m_PageProtectInfo[i].Faults, i ) );
+	}
+
+	if( pages.empty() ) return;
+
+	std::sort( pages.rbegin(), pages.rend() );
+
+	eeRecPerfLog.Write( "Page protection: %u pages faulted", (u32)pages.size() );
+
+	for( int i = 0; i < TopCount && i < (int)pages.size(); ++i )
+	{
+		const vtlb_PageProtectionInfo& info = m_PageProtectInfo[pages[i].second];
+		eeRecPerfLog.Write( "  page 0x%05x : faults = %u  page clears = %u  blocks compiled = %u  code chunks = %08x",
+			pages[i].second, info.Faults, info.PageClears, info.Compiles, info.CodeChunks );
+	}
+}
+
 // offset - offset of address relative to psM.
 // All recompiled blocks belonging to the page are cleared, and any new blocks recompiled
 // from code residing in this page will use manual protection.
@@ -962,15 +1057,37 @@ static __fi void mmap_ClearCpuBlock( uint offset )
 	pxAssert( eeMem );
 
 	int rampage = offset >> 12;
+	vtlb_PageProtectionInfo& info = m_PageProtectInfo[rampage];
 
 	// Assertion: This function should never be run on a block that's already under
 	// manual protection.  Indicates a logic error in the recompiler or protection code.
-	pxAssertMsg( m_PageProtectInfo[rampage].Mode != ProtMode_Manual,
+	pxAssertMsg( info.Mode != ProtMode_Manual,
 		"Attempted to clear a block that is already under manual protection." );
 
 	HostSys::MemProtect( &eeMem->Main[rampage<<12], __pagesize, PageAccess_ReadWrite() );
-	m_PageProtectInfo[rampage].Mode = ProtMode_Manual;
-	Cpu->Clear( m_PageProtectInfo[rampage].ReverseRamMap, 0x400 );
+	info.Mode = ProtMode_Manual;
+	info.Faults++;
+
+	if( info.SubPageChecks )
+	{
+		// Every block of the page checks the dirty flag, so only the chunk being written
+		// needs to be cleared right away (a 128 bit store can't span more than two chunks).
+		m_PageDirty[rampage] = 1;
+
+		const uint first = (offset & 0xfff) >> CodeChunkShift;
+		const uint last  = std::min<uint>( ((offset & 0xfff) + 15) >> CodeChunkShift, 31 );
+
+		for( uint i = first; i <= last; ++i )
+		{
+			if( info.CodeChunks & (1u << i) )
+				Cpu->Clear( info.ReverseRamMap + (i << CodeChunkShift), 1 << (CodeChunkShift - 2) );
+		}
+		return;
+	}
+
+	info.PageClears++;
+	info.CodeChunks = 0;
+	Cpu->Clear( info.ReverseRamMap, 0x400 );
 }
 
 void mmap_PageFaultHandler::OnPageFaultEvent( const PageFaultInfo& info, bool& handled )
@@ -992,6 +1109,8 @@ void mmap_PageFaultHandler::OnPageFaultEvent( const PageFaultInfo& info, bool& h
 void mmap_ResetBlockTracking()
 {
 	//DbgCon.WriteLn( "vtlb/mmap: Block Tracking reset..." );
+	mmap_PrintProtectionStats();
 	memzero( m_PageProtectInfo );
+	memzero( m_PageDirty );
 	if (eeMem) HostSys::MemProtect( eeMem->Main, Ps2MemSize::MainRam, PageAccess_ReadWrite() );
 }
@@ -126,6 +126,10 @@ enum vtlb_ProtectionMode
 
 extern vtlb_ProtectionMode mmap_GetRamPageInfo( u32 paddr );
 extern void mmap_MarkCountedRamPage( u32 paddr );
+extern void mmap_MarkCodeChunks( u32 paddr, u32 size );
+extern bool mmap_HasSubPageChecks( u32 paddr );
+extern const u8* mmap_GetPageDirtyFlag( u32 paddr );
+extern void mmap_PrintProtectionStats();
 extern void mmap_ResetBlockTracking();
 
 #define memRead8 vtlb_memRead<mem8_t>
@@ -62,6 +62,7 @@ namespace PathDefs
 	extern wxDirName GetCheats();
 	extern wxDirName GetCheatsWS();
 	extern wxDirName GetDocs();
+	extern wxDirName GetCache();
 
 	extern wxDirName Get( FoldersEnum_t folderidx );
 
@@ -80,6 +81,7 @@ namespace PathDefs
 		extern const wxDirName& Cheats();
 		extern const wxDirName& CheatsWS();
 		extern const wxDirName& Docs();
+		extern const wxDirName& Cache();
 	}
 }
 
@@ -165,6 +165,10 @@ void Pcsx2Config::RecompilerOptions::LoadSave( IniInterface& ini )
 	IniBitBool( StackFrameChecks );
 	IniBitBool( PreBlockCheckEE );
 	IniBitBool( PreBlockCheckIOP );
+
+	IniBitBool( PersistentEEBlocks );
+	IniBitBool( AsyncMicroVU1 );
+	IniBitBool( PersistentVU1Programs );
 }
 
 Pcsx2Config::CpuOptions::CpuOptions()
@@ -205,6 +209,7 @@ Pcsx2Config::GSOptions::GSOptions()
 
 	SynchronousMTGS			= false;
 	VsyncQueueSize			= 2;
+	RingSizeFactor			= 19;
 
 	FramesToDraw			= 2;
 	FramesToSkip			= 2;
@@ -220,6 +225,7 @@ void Pcsx2Config::GSOptions::LoadSave( IniInterface& ini )
 
 	IniEntry( SynchronousMTGS );
 	IniEntry( VsyncQueueSize );
+	IniEntry( RingSizeFactor );
 
 	IniEntry( FrameLimitEnable );
 	IniEntry( FrameSkipEnable );
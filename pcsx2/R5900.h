@@ -400,6 +400,12 @@ extern R5900cpu *Cpu;
 extern R5900cpu intCpu;
 extern R5900cpu recCpu;
 
+// Records the blocks the EE recompiler compiles, links and clears to a text file (--blocktrace)
+extern void recSetBlockTrace(const wxString& tracefile);
+// Replays a --blocktrace file through the recompiler's block index and through the sorted
+// array it replaced, and prints the time per event of both (--blockbench)
+extern void recBlockBenchmark(const wxString& tracefile);
+
 enum EE_EventType
 {
 	DMAC_VIF0	= 0,
@@ -101,6 +101,11 @@ TLD_eeRecPerf = {
 	pxDt("Logs manual protection, split blocks, and other things that might impact performance.")
 },
 
+TLD_threadPerf = {
+	L"ThreadPerf",	L"&Thread Performance",
+	pxDt("Logs contention between the EE and the MTGS/MTVU threads: ring stalls, idle time and wakeups.")
+},
+
 TLD_eeConsole = {
 	L"EEout",		L"EE C&onsole",
 	pxDt("Shows the game developer's logging text (EE processor)")
@@ -137,6 +142,7 @@ TLD_controlInfo = {
 SysConsoleLogPack::SysConsoleLogPack()
 	: ELF		   (&TLD_ELF, Color_Gray)
 	, eeRecPerf	   (&TLD_eeRecPerf, Color_Gray)
+	, threadPerf   (&TLD_threadPerf, Color_Gray)
 	, sysoutConsole(&TLD_sysoutConsole, Color_Gray)
 	, eeConsole	   (&TLD_eeConsole)
 	, iopConsole   (&TLD_iopConsole)
@@ -527,14 +527,19 @@ bool SysCpuProviderPack::HadSomeFailures( const Pcsx2Config::RecompilerOptions&
 
 BaseVUmicroCPU* CpuVU0 = NULL;
 BaseVUmicroCPU* CpuVU1 = NULL;
+BaseVUmicroCPU* CpuIntVU0 = NULL;
+BaseVUmicroCPU* CpuIntVU1 = NULL;
 
 void SysCpuProviderPack::ApplyConfig() const
 {
 	Cpu		= CHECK_EEREC	? &recCpu : &intCpu;
 	psxCpu	= CHECK_IOPREC	? &psxRec : &psxInt;
 
-	CpuVU0 = CpuProviders->interpVU0;
-	CpuVU1 = CpuProviders->interpVU1;
+	CpuIntVU0 = CpuProviders->interpVU0;
+	CpuIntVU1 = CpuProviders->interpVU1;
+
+	CpuVU0 = CpuIntVU0;
+	CpuVU1 = CpuIntVU1;
 
 	if( EmuConfig.Cpu.Recompiler.EnableVU0 )
 		CpuVU0 = (BaseVUmicroCPU*)CpuProviders->microVU0;
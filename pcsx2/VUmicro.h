@@ -257,6 +257,10 @@ public:
 extern BaseVUmicroCPU* CpuVU0;
 extern BaseVUmicroCPU* CpuVU1;
 
+// Interpreters, also used by microVU while a program is compiled in the background.
+extern BaseVUmicroCPU* CpuIntVU0;
+extern BaseVUmicroCPU* CpuIntVU1;
+
 
 // VU0
 extern void vu0ResetRegs();
@@ -108,6 +108,12 @@ namespace PathDefs
 			static const wxDirName retval( L"docs" );
 			return retval;
 		}
+
+		const wxDirName& Cache()
+		{
+			static const wxDirName retval( L"cache" );
+			return retval;
+		}
 	};
 
 	// Specifies the root folder for the application install.
@@ -209,6 +215,13 @@ namespace PathDefs
 		return AppRoot() + Base::Docs();
 	}
 
+	// Per-game caches (recompiler block lists, microprograms) live next to the user's
+	// other documents; they're safe to delete at any time.
+	wxDirName GetCache()
+	{
+		return GetDocuments() + Base::Cache();
+	}
+
 	wxDirName GetSavestates()
 	{
 		return GetDocuments() + Base::Savestates();
@@ -467,6 +480,11 @@ wxDirName GetCheatsWsFolder()
 	return GetResolvedFolder(FolderId_CheatsWS);
 }
 
+wxDirName GetCacheFolder()
+{
+	return PathDefs::GetCache();
+}
+
 wxDirName GetSettingsFolder()
 {
 	if( wxGetApp().Overrides.SettingsFolder.IsOk() )
@@ -67,6 +67,7 @@ extern wxString  GetUiKeysFilename();
 extern wxDirName GetLogFolder();
 extern wxDirName GetCheatsFolder();
 extern wxDirName GetCheatsWsFolder();
+extern wxDirName GetCacheFolder();
 
 enum InstallationModeType
 {
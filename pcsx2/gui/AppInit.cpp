@@ -19,6 +19,8 @@
 #include "ConsoleLogger.h"
 #include "MSWstuff.h"
 #include "MTVU.h" // for thread cancellation on shutdown
+#include "CDVD/IsoFileFormats.h"
+#include "R5900.h" // for the block trace options
 
 #include "Utilities/IniInterface.h"
 #include "DebugTools/Debug.h"
@@ -242,6 +244,10 @@ void Pcsx2App::OnInitCmdLine( wxCmdLineParser& parser )
 	parser.AddSwitch( wxEmptyString,L"portable",	_("enables portable mode operation (requires admin/root access)") );
 
 	parser.AddSwitch( wxEmptyString,L"profiling",	_("update options to ease profiling (debug)") );
+	parser.AddOption( wxEmptyString,L"isotrace",	_("records the sectors read from the ISO to the specified file (debug)"), wxCMD_LINE_VAL_STRING );
+	parser.AddOption( wxEmptyString,L"isobench",	_("replays the specified --isotrace file on IsoFile, prints the read times and exits (debug)"), wxCMD_LINE_VAL_STRING );
+	parser.AddOption( wxEmptyString,L"blocktrace",	_("records the EE blocks compiled and cleared to the specified file (debug)"), wxCMD_LINE_VAL_STRING );
+	parser.AddOption( wxEmptyString,L"blockbench",	_("replays the specified --blocktrace file through the block index, prints the times and exits (debug)"), wxCMD_LINE_VAL_STRING );
 
 	const PluginInfo* pi = tbl_PluginInfo; do {
 		parser.AddOption( wxEmptyString, pi->GetShortname().Lower(),
@@ -357,6 +363,25 @@ bool Pcsx2App::OnCmdLineParsed( wxCmdLineParser& parser )
 		}
 	}
 
+	wxString trace;
+	if (parser.Found(L"isobench", &trace) && !trace.IsEmpty())
+	{
+		IsoBenchmark(Startup.IsoFile, trace);
+		return false;
+	}
+
+	if (parser.Found(L"isotrace", &trace) && !trace.IsEmpty())
+		InputIsoFile::SetLsnTrace(trace);
+
+	if (parser.Found(L"blockbench", &trace) && !trace.IsEmpty())
+	{
+		recBlockBenchmark(trace);
+		return false;
+	}
+
+	if (parser.Found(L"blocktrace", &trace) && !trace.IsEmpty())
+		recSetBlockTrace(trace);
+
 	wxString game_args;
 	if (parser.Found(L"gameargs", &game_args) && !game_args.IsEmpty())
 		Startup.GameLaunchArgs = game_args;
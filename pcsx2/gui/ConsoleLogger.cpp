@@ -288,14 +288,15 @@ enum MenuId_LogSources_Offset
 	MenuId_LogSources_Offset_eeConsole = 0,
 	MenuId_LogSources_Offset_iopConsole,
 	MenuId_LogSources_Offset_eeRecPerf,
+	MenuId_LogSources_Offset_threadPerf,
 
-	MenuId_LogSources_Offset_ELF = 4,
+	MenuId_LogSources_Offset_ELF = 5,
 
-	MenuId_LogSources_Offset_Event = 6,
+	MenuId_LogSources_Offset_Event = 7,
 	MenuId_LogSources_Offset_Thread,
 	MenuId_LogSources_Offset_sysoutConsole,
 
-	MenuId_LogSources_Offset_recordingConsole = 10,
+	MenuId_LogSources_Offset_recordingConsole = 11,
 	MenuId_LogSources_Offset_controlInfo
 };
 
@@ -305,6 +306,7 @@ static ConsoleLogSource* const ConLogSources[] =
 	(ConsoleLogSource*)&SysConsole.eeConsole,
 	(ConsoleLogSource*)&SysConsole.iopConsole,
 	(ConsoleLogSource*)&SysConsole.eeRecPerf,
+	(ConsoleLogSource*)&SysConsole.threadPerf,
 	NULL,
 	(ConsoleLogSource*)&SysConsole.ELF,
 	NULL,
@@ -324,6 +326,7 @@ static const bool ConLogDefaults[] =
 	true,
 	true,
 	false,
+	false,
 	true,
 	false,
 	false,
@@ -23,26 +23,17 @@ BASEBLOCKEX* BaseBlocks::New(u32 startpc, uptr fnptr)
 	for (linkiter_t i = range.first; i != range.second; ++i)
 		*(u32*)i->second = fnptr - (i->second + 4);
 	
-	return blocks.insert(startpc, fnptr);;
-}
-
-int BaseBlocks::LastIndex(u32 startpc) const
-{
-	if (0 == blocks.size())
-		return -1;
-
-	int imin = 0, imax = blocks.size() - 1, imid;
+	pxAssert(blocks.find(startpc) == blocks.end());
 
-	while(imin != imax) {
-		imid = (imin+imax+1)>>1;
+	BASEBLOCKEX& block = blocks[startpc];
+	memzero(block);
+	block.startpc = startpc;
+	block.fnptr = fnptr;
 
-		if (blocks[imid].startpc > startpc)
-			imax = imid - 1;
-		else
-			imin = imid;
-	}
+	if (trace)
+		fprintf(trace, "n %x\n", startpc);
 
-	return imin;
+	return &block;
 }
 
 #if 0
@@ -78,5 +69,251 @@ void BaseBlocks::Link(u32 pc, s32* jumpptr)
 	else
 		*jumpptr = (s32)(recompiler - (sptr)(jumpptr + 1));
 	links.insert(std::pair<u32, uptr>(pc, (uptr)jumpptr));
+
+	if (trace)
+		fprintf(trace, "l %x\n", pc);
+}
+
+
+// Forgets a link made by Link(), so the jump is no longer retargeted when the block at
+// pc is cleared or recompiled.  The jump itself is left untouched.
+void BaseBlocks::Unlink(u32 pc, s32* jumpptr)
+{
+	std::pair<linkiter_t, linkiter_t> range = links.equal_range(pc);
+	for (linkiter_t i = range.first; i != range.second; ++i)
+	{
+		if (i->second == (uptr)jumpptr)
+		{
+			links.erase(i);
+			return;
+		}
+	}
 }
 
+// Forgets every link whose jump lies in [begin, end), so code memory that is reused by the
+// recompiler doesn't get patched when the link targets are cleared or recompiled.
+void BaseBlocks::UnlinkRange(uptr begin, uptr end)
+{
+	for (linkiter_t i = links.begin(); i != links.end(); )
+	{
+		if (i->second >= begin && i->second < end)
+			i = links.erase(i);
+		else
+			++i;
+	}
+}
+
+// --------------------------------------------------------------------------------------
+//  Block index benchmark (--blockbench)
+// --------------------------------------------------------------------------------------
+// The sorted array BaseBlocks used before the map, with the same interface as BaseBlocks
+// (minus the links), so a trace can be replayed through both.  Inserting and removing
+// moves every block above the slot, and pointers are only valid until the next New().
+class SortedBlockArray
+{
+	std::vector<BASEBLOCKEX> blocks;
+	u32 _size;
+
+	int LastIndex(u32 startpc) const
+	{
+		if (0 == _size)
+			return -1;
+
+		int imin = 0, imax = _size - 1, imid;
+
+		while(imin != imax) {
+			imid = (imin+imax+1)>>1;
+
+			if (blocks[imid].startpc > startpc)
+				imax = imid - 1;
+			else
+				imin = imid;
+		}
+
+		return (startpc < blocks[imin].startpc) ? -1 : imin;
+	}
+
+	BASEBLOCKEX* At(int idx)
+	{
+		return (idx < 0 || idx >= (int)_size) ? NULL : &blocks[idx];
+	}
+
+public:
+	SortedBlockArray() : blocks(0x4000), _size(0) {}
+
+	BASEBLOCKEX* New(u32 startpc, uptr fnptr)
+	{
+		if (_size + 1 >= blocks.size())
+			blocks.resize(blocks.size() + 0x2000); // some games requires even more!
+
+		int idx = LastIndex(startpc) + 1;
+		if (idx < (int)_size)
+			memmove(&blocks[idx + 1], &blocks[idx], (_size - idx) * sizeof(BASEBLOCKEX));
+
+		memzero(blocks[idx]);
+		blocks[idx].startpc = startpc;
+		blocks[idx].fnptr = fnptr;
+		_size++;
+		return &blocks[idx];
+	}
+
+	BASEBLOCKEX* Last(u32 startpc)	{ return At(LastIndex(startpc)); }
+	BASEBLOCKEX* First()			{ return At(0); }
+	BASEBLOCKEX* Next(const BASEBLOCKEX* block)	{ return At(block - &blocks[0] + 1); }
+	BASEBLOCKEX* Prev(const BASEBLOCKEX* block)	{ return At(block - &blocks[0] - 1); }
+
+	BASEBLOCKEX* Get(u32 startpc)
+	{
+		BASEBLOCKEX* block = Last(startpc);
+
+		if (!block || ((block->size) && (startpc >= block->startpc + block->size * 4)))
+			return NULL;
+		else
+			return block;
+	}
+
+	// The array version of recClear checked every block after a clear.
+	BASEBLOCKEX* FirstReaching(u32 pc)	{ return First(); }
+
+	void SetSize(BASEBLOCKEX* block, u16 size)	{ block->size = size; }
+	size_t Count() const	{ return _size; }
+	void Reset()			{ _size = 0; }
+
+	void Remove(BASEBLOCKEX* block)
+	{
+		int idx = block - &blocks[0];
+		memmove(&blocks[idx], &blocks[idx + 1], (_size - idx - 1) * sizeof(BASEBLOCKEX));
+		_size--;
+	}
+};
+
+struct BlockTraceEvent
+{
+	char op;
+	u32 pc;
+	u32 size;
+};
+
+struct BlockTraceResult
+{
+	u64 ticks;
+	size_t peak;		// most blocks indexed at once
+	size_t remaining;	// blocks left at the end
+	u32 found;			// lookups that found a block, both indexes must agree on it
+	u64 checked;		// blocks looked at by the recClear checks
+};
+
+// Does what the recompiler did with the index for every event of the trace.  Clears replay
+// the lookups and the check of recClear; the blocks they removed follow as their own events.
+template< typename Index >
+static BlockTraceResult ReplayBlockTrace(Index& index, const std::vector<BlockTraceEvent>& trace)
+{
+	// BaseBlocks::Remove marks the code of removed blocks in devbuilds
+	static u8 code[16];
+
+	BlockTraceResult result = {};
+	const u64 start = GetCPUTicks();
+	for (const BlockTraceEvent& ev : trace)
+	{
+		switch (ev.op)
+		{
+			case 'n':
+				if (index.Get(ev.pc)) result.found++;
+				index.New(ev.pc, (uptr)code);
+				result.peak = std::max(result.peak, index.Count());
+				break;
+
+			case 's':
+				if (BASEBLOCKEX* block = index.Last(ev.pc))
+					index.SetSize(block, ev.size);
+				break;
+
+			case 'l':
+				if (index.Get(ev.pc)) result.found++;
+				break;
+
+			case 'c':
+			{
+				const u32 end = ev.pc + ev.size * 4;
+				for (BASEBLOCKEX* block = index.Last(end - 4); block; block = index.Prev(block))
+				{
+					if (block->startpc + block->size * 4 <= ev.pc)
+						break;
+					result.found++;
+				}
+				for (BASEBLOCKEX* block = index.FirstReaching(ev.pc); block && block->startpc < end; block = index.Next(block))
+					result.checked++;
+				break;
+			}
+
+			case 'd':
+			{
+				BASEBLOCKEX* block = index.Last(ev.pc);
+				if (block && block->startpc == ev.pc)
+					index.Remove(block);
+				break;
+			}
+
+			case 'r':
+				index.Reset();
+				break;
+		}
+	}
+
+	result.ticks = GetCPUTicks() - start;
+	result.remaining = index.Count();
+	return result;
+}
+
+static void PrintBlockTraceResult(const wxChar* name, const BlockTraceResult& result, size_t events, uint clears)
+{
+	const u64 freq = GetTickFrequency();
+	Console.WriteLn(L"%s %u ms total, %.0f ns/event, %.1f blocks checked per clear", name,
+		(u32)(result.ticks * 1000 / freq), 1e9 * result.ticks / freq / events, (double)result.checked / std::max(clears, 1u));
+}
+
+void recBlockBenchmark(const wxString& tracefile)
+{
+	std::vector<BlockTraceEvent> trace;
+	if (FILE* fp = wxFopen(tracefile, L"r"))
+	{
+		BlockTraceEvent ev;
+		while (fscanf(fp, " %c", &ev.op) == 1)
+		{
+			ev.pc = ev.size = 0;
+			if (ev.op != 'r' && fscanf(fp, "%x", &ev.pc) != 1)
+				break;
+			if ((ev.op == 's' || ev.op == 'c') && fscanf(fp, "%x", &ev.size) != 1)
+				break;
+			trace.push_back(ev);
+		}
+		fclose(fp);
+	}
+
+	if (trace.empty())
+	{
+		Console.Error(L"Recompiler error: No block trace in '%s'", WX_STR(tracefile));
+		return;
+	}
+
+	uint counts[256] = {};
+	for (const BlockTraceEvent& ev : trace)
+		counts[(u8)ev.op]++;
+
+	Console.WriteLn(L"Replaying %u block events: %u compiled, %u links, %u clears, %u removed, %u resets",
+		(u32)trace.size(), counts['n'], counts['l'], counts['c'], counts['d'], counts['r']);
+
+	BaseBlocks blocks;
+	const BlockTraceResult result = ReplayBlockTrace(blocks, trace);
+	blocks.Reset();
+
+	SortedBlockArray array;
+	const BlockTraceResult arrayResult = ReplayBlockTrace(array, trace);
+
+	if (result.peak != arrayResult.peak || result.remaining != arrayResult.remaining || result.found != arrayResult.found)
+		Console.Error(L"Recompiler error: The block indexes disagree on the trace");
+
+	Console.WriteLn(L"Peak of %u blocks, %u left", (u32)result.peak, (u32)result.remaining);
+	PrintBlockTraceResult(L"Ordered map: ", result, trace.size(), counts['c']);
+	PrintBlockTraceResult(L"Sorted array:", arrayResult, trace.size(), counts['c']);
+}
@@ -15,7 +15,7 @@
 
 #pragma once
 
-#include <map>			// used by BaseBlockEx
+#include <map>			// used by BaseBlocks
 
 // Every potential jump point in the PS2's addressable memory has a BASEBLOCK
 // associated with it. So that means a BASEBLOCK for every 4 bytes of PS2
@@ -44,187 +44,158 @@ struct BASEBLOCKEX
 
 };
 
-class BaseBlockArray {
-	s32 _Reserved;
-	s32 _Size;
-	BASEBLOCKEX *blocks;
+// Blocks are indexed by startpc in an ordered map, so inserting and clearing blocks stays
+// O(log n) however many blocks a game compiles, and BASEBLOCKEX pointers remain valid until
+// the block itself is removed.  A block can start inside an older one that is still intact
+// (a jump into its middle), so Get() only looks at the last block starting at or below a pc;
+// FirstReaching() is there for the queries that must see every block holding a pc.
+class BaseBlocks
+{
+protected:
+	typedef std::multimap<u32, uptr>::iterator linkiter_t;
+	typedef std::map<u32, BASEBLOCKEX>::iterator blockiter_t;
+	typedef std::map<u32, BASEBLOCKEX>::const_iterator const_blockiter_t;
 
-	__fi void resize(s32 size)
-	{
-		pxAssert(size > 0);
-		BASEBLOCKEX *newMem = new BASEBLOCKEX[size];
-		if(blocks) {
-			memcpy(newMem, blocks, _Reserved * sizeof(BASEBLOCKEX));
-			delete[] blocks;
-		}
-		blocks = newMem;
-		pxAssert(blocks != NULL);
-	}
+	// switch to a hash map later?
+	std::multimap<u32, uptr> links;
+	uptr recompiler;
+	std::map<u32, BASEBLOCKEX> blocks;
+	u32 maxbytes;		// longest block since the last Reset, in bytes
+	FILE* trace;		// see SetTrace
 
-	void reserve(u32 size)
-	{
-		resize(size);
-		_Reserved = size;
-	}
 public:
-	~BaseBlockArray()
+	BaseBlocks() :
+		recompiler(0)
+	,	maxbytes(0)
+	,	trace(NULL)
 	{
-		if(blocks) {
-			delete[] blocks;
-		}
 	}
 
-	BaseBlockArray (s32 size) : _Reserved(0),
-		_Size(0), blocks(NULL)
+	// Records New, SetSize, Link, Remove, Reset and the cleared ranges to a text file, one
+	// per line, so the index can be benchmarked on them (--blocktrace, --blockbench)
+	void SetTrace(FILE* fp)
 	{
-		reserve(size);
+		trace = fp;
 	}
 
-	BASEBLOCKEX *insert(u32 startpc, uptr fnptr)
+	__fi void TraceClear(u32 addr, u32 size)
 	{
-		if(_Size + 1 >= _Reserved) {
-			reserve(_Reserved + 0x2000); // some games requires even more!
-		}
-
-		// Insert the the new BASEBLOCKEX by startpc order
-		int imin = 0, imax = _Size, imid;
-
-		while (imin < imax) {
-			imid = (imin+imax)>>1;
-
-			if (blocks[imid].startpc > startpc)
-				imax = imid;
-			else
-				imin = imid + 1;
-		}
-	
-		pxAssert(imin == _Size || blocks[imin].startpc > startpc);
-
-		if(imin < _Size) {
-			// make a hole for a new block.
-			memmove(blocks + imin + 1, blocks + imin, (_Size - imin) * sizeof(BASEBLOCKEX));
-		}
-
-		memset((blocks + imin), 0, sizeof(BASEBLOCKEX));
-		blocks[imin].startpc = startpc;
-		blocks[imin].fnptr = fnptr;
-
-		_Size++;
-		return &blocks[imin];
+		if (trace)
+			fprintf(trace, "c %x %x\n", addr, size);
 	}
 
-	__fi BASEBLOCKEX &operator[](int idx) const
+	void SetJITCompile( void (*recompiler_)() )
 	{
-		return *(blocks + idx);
+		recompiler = (uptr)recompiler_;
 	}
 
-	void clear()
-	{
-		_Size = 0;
-	}
+	BASEBLOCKEX* New(u32 startpc, uptr fnptr);
+	//BASEBLOCKEX* GetByX86(uptr ip);
 
-	__fi u32 size() const
+	// Returns the block with the highest startpc that is not above startpc, or NULL.
+	__fi BASEBLOCKEX* Last(u32 startpc)
 	{
-		return _Size;
+		blockiter_t it = blocks.upper_bound(startpc);
+		if (it == blocks.begin())
+			return NULL;
+
+		return &(--it)->second;
 	}
 
-	__fi void erase(s32 first, s32 last)
+	// Returns the block containing startpc, or NULL.
+	__fi BASEBLOCKEX* Get(u32 startpc)
 	{
-		int range = last - first;
-
-		if(last < _Size) {
-			memmove(blocks + first, blocks + last, (_Size - last) * sizeof(BASEBLOCKEX));
-		}
+		BASEBLOCKEX* block = Last(startpc);
 
-		_Size -= range;
+		if (!block || ((block->size) && (startpc >= block->startpc + block->size * 4)))
+			return NULL;
+		else
+			return block;
 	}
-};
 
-class BaseBlocks
-{
-protected:
-	typedef std::multimap<u32, uptr>::iterator linkiter_t;
+	// Sets the size of a block once it is compiled.  Use this rather than writing size, so
+	// the overlap queries know how far back a block can start.
+	__fi void SetSize(BASEBLOCKEX* block, u16 size)
+	{
+		block->size = size;
+		maxbytes = std::max<u32>(maxbytes, size * 4);
 
-	// switch to a hash map later?
-	std::multimap<u32, uptr> links;
-	uptr recompiler;
-	BaseBlockArray blocks;
+		if (trace)
+			fprintf(trace, "s %x %x\n", block->startpc, size);
+	}
 
-public:
-	BaseBlocks() :
-		recompiler(0)
-	,	blocks(0x4000)
+	// Returns the first block that can hold code at or above pc, or NULL.  Blocks may nest, so
+	// the containing one isn't always Last(pc); walking Next() from here up to pc finds them
+	// all in a few steps, since none starts more than the longest block below pc.
+	__fi BASEBLOCKEX* FirstReaching(u32 pc)
 	{
+		BASEBLOCKEX* block = Last(pc > maxbytes ? pc - maxbytes : 0);
+		return block ? block : First();
 	}
 
-	void SetJITCompile( void (*recompiler_)() )
+	// Walks the blocks in startpc order; these return NULL past either end.
+	__fi BASEBLOCKEX* First()
 	{
-		recompiler = (uptr)recompiler_;
+		return blocks.empty() ? NULL : &blocks.begin()->second;
 	}
 
-	BASEBLOCKEX* New(u32 startpc, uptr fnptr);
-	int LastIndex (u32 startpc) const;
-	//BASEBLOCKEX* GetByX86(uptr ip);
-
-	__fi int Index (u32 startpc) const
+	__fi BASEBLOCKEX* Next(const BASEBLOCKEX* block)
 	{
-		int idx = LastIndex(startpc);
-
-		if ((idx == -1) || (startpc < blocks[idx].startpc) ||
-			((blocks[idx].size) && (startpc >= blocks[idx].startpc + blocks[idx].size * 4)))
-			return -1;
-		else
-			return idx;
+		blockiter_t it = blocks.upper_bound(block->startpc);
+		return (it == blocks.end()) ? NULL : &it->second;
 	}
 
-	__fi BASEBLOCKEX* operator[](int idx)
+	__fi BASEBLOCKEX* Prev(const BASEBLOCKEX* block)
 	{
-		if (idx < 0 || idx >= (int)blocks.size())
-			return 0;
+		blockiter_t it = blocks.lower_bound(block->startpc);
+		if (it == blocks.begin())
+			return NULL;
 
-		return &blocks[idx];
+		return &(--it)->second;
 	}
 
-	__fi BASEBLOCKEX* Get(u32 startpc)
+	__fi size_t Count() const
 	{
-		return (*this)[Index(startpc)];
+		return blocks.size();
 	}
 
-	__fi void Remove(int first, int last)
+	// Redirects every static link to the block back to the recompiler and forgets the block.
+	__fi void Remove(BASEBLOCKEX* block)
 	{
-		pxAssert(first <= last);
-		int idx = first;
-		do{
-			pxAssert(idx <= last);
-
-			//u32 startpc = blocks[idx].startpc;
-			std::pair<linkiter_t, linkiter_t> range = links.equal_range(blocks[idx].startpc);
-			for (linkiter_t i = range.first; i != range.second; ++i)
-				*(u32*)i->second = recompiler - (i->second + 4);
-
-			if( IsDevBuild )
-			{
-				// Clear the first instruction to 0xcc (breakpoint), as a way to assert if some
-				// static jumps get left behind to this block.  Note: Do not clear more than the
-				// first byte, since this code is called during exception handlers and event handlers
-				// both of which expect to be able to return to the recompiled code.
-
-				BASEBLOCKEX effu( blocks[idx] );
-				memset( (void*)effu.fnptr, 0xcc, 1 );
-			}
+		std::pair<linkiter_t, linkiter_t> range = links.equal_range(block->startpc);
+		for (linkiter_t i = range.first; i != range.second; ++i)
+			*(u32*)i->second = recompiler - (i->second + 4);
+
+		if( IsDevBuild )
+		{
+			// Clear the first instruction to 0xcc (breakpoint), as a way to assert if some
+			// static jumps get left behind to this block.  Note: Do not clear more than the
+			// first byte, since this code is called during exception handlers and event handlers
+			// both of which expect to be able to return to the recompiled code.
+
+			memset( (void*)block->fnptr, 0xcc, 1 );
 		}
-		while(idx++ < last);
 
 		// TODO: remove links from this block?
-		blocks.erase(first, last + 1);
+		const u32 startpc = block->startpc;
+		blocks.erase(startpc);
+
+		if (trace)
+			fprintf(trace, "d %x\n", startpc);
 	}
 
 	void Link(u32 pc, s32* jumpptr);
+	void Unlink(u32 pc, s32* jumpptr);
+	void UnlinkRange(uptr begin, uptr end);
 
 	__fi void Reset()
 	{
 		blocks.clear();
 		links.clear();
+		maxbytes = 0;
+
+		if (trace)
+			fprintf(trace, "r\n");
 	}
 };
 
@@ -130,6 +130,33 @@ void _flushCachedRegs();
 void _flushConstRegs();
 void _flushConstReg(int reg);
 
+////////////////////////////////////////////////////////////////////////////////
+//   Register file base
+
+// Recompiled EE and IOP code keeps ebp pointed into the register file of the cpu it runs:
+// the entry code loads it and the allocator never hands ebp out.  While a rec emits inside
+// a recScopedRegFile, operands such as ptr[&cpuRegs.pc] are addressed relative to ebp.  The
+// base sits 0x80 bytes in, so the first 16 EE GPRs (all 32 on the IOP) get 8 bit
+// displacements.  VTune builds want ebp as a frame pointer and keep absolute addresses.
+#ifdef ENABLE_VTUNE
+static const bool RecPinRegFile = false;
+#else
+static const bool RecPinRegFile = true;
+#endif
+
+template< typename T >
+static __fi u8* recRegFileBase(T& regs) { return (u8*)&regs + 0x80; }
+
+template< typename T >
+class recScopedRegFile : public x86Emitter::xScopedBaseRegister
+{
+public:
+	recScopedRegFile(T& regs)
+		: x86Emitter::xScopedBaseRegister(x86Emitter::ebp, recRegFileBase(regs), &regs, RecPinRegFile ? &regs + 1 : &regs)
+	{
+	}
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 //   XMM (128-bit) Register Allocation Tools
 
@@ -173,7 +173,9 @@ static DynGenFunc* _DynGen_EnterRecompiledCode()
 #ifdef ENABLE_VTUNE
 		xScopedStackFrame frame(true);
 #else
-		xScopedStackFrame frame(IsDevBuild);
+		// ebp holds the psxRegs base rather than a frame (see recScopedRegFile)
+		xScopedStackFrame frame(false, true);
+		xMOV(ebp, (uptr)recRegFileBase(psxRegs));
 #endif
 
 		xJMP((void*)iopDispatcherReg);
@@ -196,6 +198,7 @@ static void _DynGen_Dispatchers()
 	memset( iopRecDispatchers, 0xcc, __pagesize);
 
 	xSetPtr( iopRecDispatchers );
+	recScopedRegFile<psxRegisters> regFile( psxRegs );
 
 	// Place the EventTest and DispatcherReg stuff at the top, because they get called the
 	// most and stand to benefit from strong alignment and direct referencing.
@@ -810,37 +813,33 @@ static __fi u32 psxRecClearMem(u32 pc)
 	pc = HWADDR(pc);
 
 	u32 lowerextent = pc, upperextent = pc + 4;
-	int blockidx = recBlocks.Index(pc);
-	pxAssert(blockidx != -1);
+	BASEBLOCKEX* pexblock = recBlocks.Get(pc);
+	pxAssert(pexblock);
 
-	while (BASEBLOCKEX* pexblock = recBlocks[blockidx - 1]) {
-		if (pexblock->startpc + pexblock->size * 4 <= lowerextent)
+	while (BASEBLOCKEX* prevblock = recBlocks.Prev(pexblock)) {
+		if (prevblock->startpc + prevblock->size * 4 <= lowerextent)
 			break;
 
-		lowerextent = std::min(lowerextent, pexblock->startpc);
-		blockidx--;
+		lowerextent = std::min(lowerextent, prevblock->startpc);
+		pexblock = prevblock;
 	}
 
-	int toRemoveFirst = blockidx;
-
-	while (BASEBLOCKEX* pexblock = recBlocks[blockidx]) {
+	while (pexblock) {
 		if (pexblock->startpc >= upperextent)
 			break;
 
 		lowerextent = std::min(lowerextent, pexblock->startpc);
 		upperextent = std::max(upperextent, pexblock->startpc + pexblock->size * 4);
 
-		blockidx++;
-	}
-
-	if(toRemoveFirst != blockidx) {
-		recBlocks.Remove(toRemoveFirst, (blockidx - 1));
+		BASEBLOCKEX* nextblock = recBlocks.Next(pexblock);
+		recBlocks.Remove(pexblock);
+		pexblock = nextblock;
 	}
 
-	blockidx=0;
-	while(BASEBLOCKEX* pexblock = recBlocks[blockidx++])
+	// Only the blocks that can reach pc are checked, so this stays cheap in every build.
+	for (pexblock = recBlocks.FirstReaching(pc); pexblock && pexblock->startpc <= pc; pexblock = recBlocks.Next(pexblock))
 	{
-		if (pc >= pexblock->startpc && pc < pexblock->startpc + pexblock->size * 4) {
+		if (pc < pexblock->startpc + pexblock->size * 4) {
 			DevCon.Error("Impossible block clearing failure");
 			pxFailDev( "Impossible block clearing failure" );
 		}
@@ -1082,6 +1081,7 @@ static void __fastcall iopRecRecompile( const u32 startpc )
 {
 	u32 i;
 	u32 willbranch3 = 0;
+	recScopedRegFile<psxRegisters> regFile( psxRegs );
 
 	// Inject IRX hack
 	if (startpc == 0x1630 && g_Conf->CurrentIRX.Length() > 3) {
@@ -1261,7 +1261,7 @@ StartRecomp:
 		iIopDumpBlock(startpc, recPtr);
 
 	pxAssert( (psxpc-startpc)>>2 <= 0xffff );
-	s_pCurBlockEx->size = (psxpc-startpc)>>2;
+	recBlocks.SetSize(s_pCurBlockEx, (psxpc-startpc)>>2);
 
 	for(i = 1; i < (u32)s_pCurBlockEx->size; ++i) {
 		if (s_pCurBlock[i].GetFnptr() == (uptr)iopJITCompile)
@@ -34,6 +34,11 @@
 
 #include "../DebugTools/Breakpoints.h"
 #include "Patch.h"
+#include "AppConfig.h"
+
+#include <unordered_map>
+#include <wx/ffile.h>
+#include <zlib.h>
 
 #if !PCSX2_SEH
 #	include <csetjmp>
@@ -87,6 +92,35 @@ static BASEBLOCK *recROM2 = NULL;       // also here
 
 static BaseBlocks recBlocks;
 static u8* recPtr = NULL;
+
+// Code cache segments: recMem is filled one segment at a time, and once every segment has
+// been used, the least recently used one (approximated with a clock over the referenced
+// bits below) is evicted and refilled instead of resetting the whole cache.
+static const uint RecSegmentMaxCount = 64;
+static const uint RecSegmentHeadroom = _64kb;	// larger than any block
+
+struct eeCodeCacheStats
+{
+	u32 Evictions;			// segments reclaimed
+	u32 BlocksEvicted;
+	u64 BytesReclaimed;
+	u32 FullResets;
+};
+
+static u8 s_recSegReferenced[RecSegmentMaxCount];	// set when a block of the segment is dispatched
+static uint s_recSegShift = 0;
+static uint s_recSegCount = 0;
+static uint s_recSegCurrent = 0;	// segment recPtr is in
+static uint s_recSegUsed = 0;		// segments filled since the last reset
+static eeCodeCacheStats s_codeCacheStats;
+
+// Inline caches of register jumps, keyed by the address of their predicted-pc immediate.
+struct IndirectBranchSite
+{
+	s32* jumpptr;	// rel32 of the direct jump to the predicted block
+	u32 relinks;
+};
+static std::unordered_map<uptr, IndirectBranchSite> s_indirectSites;
 static u32 *recConstBufPtr = NULL;
 EEINST* s_pInstCache = NULL;
 static u32 s_nInstCacheSize = 0;
@@ -318,6 +352,7 @@ void recCall( void (*func)() )
 static void __fastcall recRecompile( const u32 startpc );
 static void __fastcall dyna_block_discard(u32 start,u32 sz);
 static void __fastcall dyna_page_reset(u32 start,u32 sz);
+static void __fastcall recIndirectBranchMiss(uptr site);
 
 // Recompiled code buffer for EE recompiler dispatchers!
 static u8 __pagealigned eeRecDispatchers[__pagesize];
@@ -332,12 +367,87 @@ static DynGenFunc* EnterRecompiledCode	= NULL;
 static DynGenFunc* ExitRecompiledCode	= NULL;
 static DynGenFunc* DispatchBlockDiscard = NULL;
 static DynGenFunc* DispatchPageReset    = NULL;
+static DynGenFunc* DispatchIndirectMiss = NULL;
+
+// Dispatcher round trips, sampled once per frame from the event test and printed to the
+// recompiler perf log.
+struct eeDispatchStats
+{
+	u32 RegDispatches;		// jumps through DispatcherReg (recLUT lookups), dev builds only
+	u32 IndirectMisses;		// register jumps whose inline prediction failed
+	u32 IndirectRelinks;	// predictions (re)pointed at a new target
+};
+
+static eeDispatchStats s_dispatchStats;
+static eeDispatchStats s_dispatchStatsTotal;
+static uint s_dispatchStatsFrame = 0;
+static uint s_dispatchStatsFrames = 0;
+static const uint DispatchStatsInterval = 60;
+
+static void recDispatchStatsUpdate()
+{
+	if (g_FrameCount == s_dispatchStatsFrame) return;
+	s_dispatchStatsFrame = g_FrameCount;
+
+	s_dispatchStatsTotal.RegDispatches		+= s_dispatchStats.RegDispatches;
+	s_dispatchStatsTotal.IndirectMisses		+= s_dispatchStats.IndirectMisses;
+	s_dispatchStatsTotal.IndirectRelinks	+= s_dispatchStats.IndirectRelinks;
+	memzero(s_dispatchStats);
+
+	if (++s_dispatchStatsFrames < DispatchStatsInterval) return;
+
+	if (IsDevBuild)
+	{
+		eeRecPerfLog.Write( "Dispatcher: %u round trips/frame, %u indirect misses/frame, %u relinks/frame",
+			s_dispatchStatsTotal.RegDispatches / DispatchStatsInterval,
+			s_dispatchStatsTotal.IndirectMisses / DispatchStatsInterval,
+			s_dispatchStatsTotal.IndirectRelinks / DispatchStatsInterval );
+	}
+	else
+	{
+		eeRecPerfLog.Write( "Dispatcher: %u indirect misses/frame, %u relinks/frame",
+			s_dispatchStatsTotal.IndirectMisses / DispatchStatsInterval,
+			s_dispatchStatsTotal.IndirectRelinks / DispatchStatsInterval );
+	}
+
+	memzero(s_dispatchStatsTotal);
+	s_dispatchStatsFrames = 0;
+}
+
+// Marks the segment holding the block at pc as used.  Sampled from the event test, which
+// dispatches often enough to catch the hot code without instrumenting every block.  The pc
+// is the one the dispatcher is about to look up, so its recLUT page is valid.
+static __fi void recSegmentTouch(u32 pc)
+{
+	const uptr offset = PC_GETBLOCK(pc)->GetFnptr() - (uptr)recMem->GetPtr();
+	if ((offset >> s_recSegShift) < s_recSegCount)
+		s_recSegReferenced[offset >> s_recSegShift] = 1;
+}
 
 static void recEventTest()
 {
+	recDispatchStatsUpdate();
+	recSegmentTouch(cpuRegs.pc);
 	_cpuEventTest_Shared();
 }
 
+// Jumps to the block of cpuRegs.pc through recLUT.  This and PC_GETBLOCK are the only
+// places that know the layout of the lookup tables: recLUT holds one uptr per 64k page,
+// pre-biased so that adding pc * (sizeof(BASEBLOCK)/4) lands on the page's BASEBLOCK.
+//
+// Note: this file is the x86-32 backend.  cpuRegs is already addressed relative to ebp
+// (see recScopedRegFile); a 64-bit build still needs recLUT and the const buffer, which are
+// addressed as 32-bit absolute displacements all over the opcode recs, moved under a base
+// register the same way.
+static void _DynGen_DispatchBlockLookup()
+{
+	xMOV( eax, ptr[&cpuRegs.pc] );
+	xMOV( ebx, eax );
+	xSHR( eax, 16 );
+	xMOV( ecx, ptr[recLUT + (eax*sizeof(uptr))] );
+	xJMP( ptr32[ecx+ebx] );
+}
+
 // The address for all cleared blocks.  It recompiles the current pc and then
 // dispatches to the recompiled block address.
 static DynGenFunc* _DynGen_JITCompile()
@@ -347,12 +457,7 @@ static DynGenFunc* _DynGen_JITCompile()
 	u8* retval = xGetAlignedCallTarget();
 
 	xFastCall((void*)recRecompile, ptr[&cpuRegs.pc] );
-
-	xMOV( eax, ptr[&cpuRegs.pc] );
-	xMOV( ebx, eax );
-	xSHR( eax, 16 );
-	xMOV( ecx, ptr[recLUT + (eax*4)] );
-	xJMP( ptr32[ecx+ebx] );
+	_DynGen_DispatchBlockLookup();
 
 	return (DynGenFunc*)retval;
 }
@@ -369,11 +474,12 @@ static DynGenFunc* _DynGen_DispatcherReg()
 {
 	u8* retval = xGetPtr();		// fallthrough target, can't align it!
 
-	xMOV( eax, ptr[&cpuRegs.pc] );
-	xMOV( ebx, eax );
-	xSHR( eax, 16 );
-	xMOV( ecx, ptr[recLUT + (eax*4)] );
-	xJMP( ptr32[ecx+ebx] );
+	// Every register jump and event test goes through here, so release builds don't pay
+	// for the counter (a read-modify-write to memory) on this path.
+	if (IsDevBuild)
+		xADD( ptr32[&s_dispatchStats.RegDispatches], 1 );
+
+	_DynGen_DispatchBlockLookup();
 
 	return (DynGenFunc*)retval;
 }
@@ -397,7 +503,9 @@ static DynGenFunc* _DynGen_EnterRecompiledCode()
 #ifdef ENABLE_VTUNE
 		xScopedStackFrame frame(true);
 #else
-		xScopedStackFrame frame(IsDevBuild);
+		// ebp holds the cpuRegs base rather than a frame (see recScopedRegFile)
+		xScopedStackFrame frame(false, true);
+		xMOV(ebp, (uptr)recRegFileBase(cpuRegs));
 #endif
 
 		xJMP((void*)DispatcherReg);
@@ -427,6 +535,15 @@ static DynGenFunc* _DynGen_DispatchPageReset()
 	return (DynGenFunc*)retval;
 }
 
+// ecx = inline cache site (see iBranchIndirectPredict)
+static DynGenFunc* _DynGen_DispatchIndirectMiss()
+{
+	u8* retval = xGetPtr();
+	xFastCall((void*)recIndirectBranchMiss);
+	xJMP((void*)DispatcherReg);
+	return (DynGenFunc*)retval;
+}
+
 static void _DynGen_Dispatchers()
 {
 	// In case init gets called multiple times:
@@ -436,6 +553,7 @@ static void _DynGen_Dispatchers()
 	memset( eeRecDispatchers, 0xcc, __pagesize);
 
 	xSetPtr( eeRecDispatchers );
+	recScopedRegFile<cpuRegisters> regFile( cpuRegs );
 
 	// Place the EventTest and DispatcherReg stuff at the top, because they get called the
 	// most and stand to benefit from strong alignment and direct referencing.
@@ -447,6 +565,7 @@ static void _DynGen_Dispatchers()
 	EnterRecompiledCode  = _DynGen_EnterRecompiledCode();
 	DispatchBlockDiscard = _DynGen_DispatchBlockDiscard();
 	DispatchPageReset    = _DynGen_DispatchPageReset();
+	DispatchIndirectMiss = _DynGen_DispatchIndirectMiss();
 
 	HostSys::MemProtectStatic( eeRecDispatchers, PageAccess_ExecOnly() );
 
@@ -576,6 +695,7 @@ static void recAlloc()
 
 static __aligned16 u16 manual_page[Ps2MemSize::MainRam >> 12];
 static __aligned16 u8 manual_counter[Ps2MemSize::MainRam >> 12];
+static __aligned16 u16 subpage_verify_counter[Ps2MemSize::MainRam >> 12];
 
 static std::atomic<bool> eeRecIsReset(false);
 static std::atomic<bool> eeRecNeedsReset(false);
@@ -583,6 +703,315 @@ static bool eeCpuExecuting = false;
 static bool g_resetEeScalingStats = false;
 static int g_patchesNeedRedo = 0;
 
+// --------------------------------------------------------------------------------------
+//  Persistent EE block cache
+// --------------------------------------------------------------------------------------
+// Remembers which blocks a game compiled (start pc, length and a checksum of the MIPS
+// code) and recompiles them eagerly when the same ELF boots again, so the compile burst
+// of the first minutes is paid once at the ELF entry point instead of during gameplay.
+//
+// Only the block list is persisted.  The generated x86 embeds absolute host pointers
+// (cpuRegs, recLUT, the const buffer, dispatchers) so it is regenerated from RAM instead
+// of being relocated.  That also means a stale entry can never produce wrong code: blocks
+// are compiled from the current RAM contents, and entries whose checksum doesn't match
+// are simply skipped.
+
+struct recCachedBlock
+{
+	u32 startpc;	// physical address (always kuseg main RAM)
+	u32 size;		// in instructions
+	u32 crc;		// crc32 of the MIPS code
+};
+
+static const u32 BlockCacheMagic		= 0x4b4c4245;	// 'EBLK'
+static const u32 BlockCacheVersion		= 1;
+static const u32 BlockCacheMaxEntries	= 0x20000;
+
+// Kernel code (below 1MB) runs through kseg0 aliases, so only blocks in the user area can
+// be compiled back at their physical address.
+static const u32 BlockCacheLowerBound	= 0x00100000;
+
+static u32 s_blockCacheCRC = 0;			// ElfCRC the compiled blocks belong to (0 = BIOS)
+static bool s_blockCacheWarmup = false;	// set when the ELF entry has been compiled
+static bool s_blockCacheWarming = false;	// set while the cached blocks are being compiled
+
+// Blocks dropped by capacity resets since the cache file was last written.  They are only
+// written out on shutdown or when the VM changes, so a full code cache costs no disk I/O.
+static std::map<u32, recCachedBlock> s_blockCachePending;
+
+// Boot statistics, from the compile of the ELF entry until the first stable frame: the
+// first of BootStableFrames frames in a row during which no block was compiled.
+static const u32 BootStableFrames = 60;
+static u64 s_bootStatsStart = 0;
+static u32 s_bootStatsCRC = 0;
+static u32 s_bootStatsBlocks = 0;
+static u32 s_bootStatsPrewarmed = 0;
+static u64 s_bootStatsLastTicks = 0;	// time and frame of the last compile
+static uint s_bootStatsLastFrame = 0;
+
+static wxString recBlockCacheFilename( u32 crc )
+{
+	return Path::Combine( GetCacheFolder(), wxsFormat( L"%08X.eeblocks", crc ) );
+}
+
+static bool recBlockCacheIsCacheable( u32 startpc, u32 size )
+{
+	return size && (startpc >= BlockCacheLowerBound) && (startpc + size * 4 <= Ps2MemSize::MainRam);
+}
+
+static u32 recBlockCacheChecksum( u32 startpc, u32 size )
+{
+	return crc32( 0, &eeMem->Main[startpc], size * 4 );
+}
+
+static void recBlockCacheLoad( u32 crc, std::map<u32, recCachedBlock>& dest )
+{
+	const wxString filename( recBlockCacheFilename( crc ) );
+	if (!wxFileExists( filename )) return;
+
+	wxFFile fp( filename, L"rb" );
+	if (!fp.IsOpened()) return;
+
+	u32 header[3];
+	if (fp.Read( header, sizeof(header) ) != sizeof(header)) return;
+	if (header[0] != BlockCacheMagic || header[1] != BlockCacheVersion) return;
+
+	const u32 count = std::min( header[2], BlockCacheMaxEntries );
+	std::vector<recCachedBlock> entries( count );
+	if (count && fp.Read( entries.data(), count * sizeof(recCachedBlock) ) != count * sizeof(recCachedBlock))
+		return;
+
+	for (const recCachedBlock& entry : entries)
+	{
+		if (recBlockCacheIsCacheable( entry.startpc, entry.size ))
+			dest[entry.startpc] = entry;
+	}
+}
+
+// Keeps the currently compiled blocks in s_blockCachePending, before a reset drops them.
+static void recBlockCacheCollect()
+{
+	if (!s_blockCacheCRC) return;
+
+	for (BASEBLOCKEX* pexblock = recBlocks.First(); pexblock; pexblock = recBlocks.Next(pexblock))
+	{
+		if (!recBlockCacheIsCacheable( pexblock->startpc, pexblock->size )) continue;
+
+		recCachedBlock& entry = s_blockCachePending[pexblock->startpc];
+		entry.startpc	= pexblock->startpc;
+		entry.size		= pexblock->size;
+		entry.crc		= recBlockCacheChecksum( pexblock->startpc, pexblock->size );
+	}
+}
+
+// Merges the compiled and pending blocks into the game's cache file.  Entries from previous
+// sessions are kept, so code that only runs in some levels still ends up being cached.
+static void recBlockCacheSave()
+{
+	recBlockCacheCollect();
+
+	std::map<u32, recCachedBlock> pending;
+	pending.swap( s_blockCachePending );
+
+	if (!s_blockCacheCRC) return;
+
+	std::map<u32, recCachedBlock> blocks;
+	recBlockCacheLoad( s_blockCacheCRC, blocks );
+
+	const size_t oldcount = blocks.size();
+
+	for (const auto& it : pending)
+		blocks[it.first] = it.second;
+
+	if (blocks.size() > BlockCacheMaxEntries) return;
+
+	GetCacheFolder().Mkdir();
+
+	const wxString filename( recBlockCacheFilename( s_blockCacheCRC ) );
+	wxFFile fp( filename, L"wb" );
+	if (!fp.IsOpened())
+	{
+		Console.Warning( L"EE/iR5900-32: Could not write block cache %s", WX_STR(filename) );
+		return;
+	}
+
+	const u32 header[3] = { BlockCacheMagic, BlockCacheVersion, (u32)blocks.size() };
+	fp.Write( header, sizeof(header) );
+	for (const auto& it : blocks)
+		fp.Write( &it.second, sizeof(recCachedBlock) );
+
+	DevCon.WriteLn( L"EE/iR5900-32: Block cache %08X saved (%u blocks, %u new)",
+		s_blockCacheCRC, (u32)blocks.size(), (u32)(blocks.size() - oldcount) );
+}
+
+// Compiles every cached block whose MIPS code is still present in RAM.  Called right after
+// the ELF entry point has been compiled, when the main executable has been fully loaded.
+static void recBlockCacheWarmup()
+{
+	s_blockCacheWarmup = false;
+
+	std::map<u32, recCachedBlock> blocks;
+	recBlockCacheLoad( s_blockCacheCRC, blocks );
+
+	if (blocks.empty()) return;
+
+	const u64 start = GetCPUTicks();
+	u32 compiled = 0, mismatched = 0;
+
+	// Keeps the precompiled blocks out of the boot statistics, which report them separately
+	ScopedBool warming( s_blockCacheWarming );
+
+	for (const auto& it : blocks)
+	{
+		const recCachedBlock& entry = it.second;
+
+		// Leave enough room that the game's own compiles don't trigger a reset straight away.
+		if (eeRecNeedsReset || s_recSegUsed >= s_recSegCount * 3 / 4
+			|| (recConstBufPtr - recConstBuf) >= RECCONSTBUF_SIZE / 2)
+			break;
+
+		// The block must be reachable at its physical address, otherwise the pc constants
+		// embedded by recompilation would be wrong.
+		if ((u8*)PSM( entry.startpc ) != &eeMem->Main[entry.startpc]) continue;
+		if (PC_GETBLOCK( entry.startpc )->GetFnptr() != (uptr)JITCompile) continue;
+
+		if (recBlockCacheChecksum( entry.startpc, entry.size ) != entry.crc)
+		{
+			++mismatched;
+			continue;
+		}
+
+		recRecompile( entry.startpc );
+		++compiled;
+	}
+
+	s_bootStatsPrewarmed = compiled;
+
+	const u64 ms = (GetCPUTicks() - start) * 1000 / GetTickFrequency();
+	Console.WriteLn( Color_StrongBlack, "EE/iR5900-32: Precompiled %u of %u cached blocks in %u ms (%u stale)",
+		compiled, (u32)blocks.size(), (u32)ms, mismatched );
+}
+
+// Reports the boot once BootStableFrames frames went by without a compile.  This is only
+// noticed on the next compile (or reset), so the first stable frame is timed by the last
+// compile before it, which is within a frame of it.
+static bool recBootStatsCheck()
+{
+	if (!s_bootStatsStart || (g_FrameCount - s_bootStatsLastFrame) <= BootStableFrames)
+		return false;
+
+	const u64 ms = std::max<u64>( (s_bootStatsLastTicks - s_bootStatsStart) * 1000 / GetTickFrequency(), 1 );
+
+	Console.WriteLn( Color_StrongBlack, "EE/iR5900-32: First stable frame after %u ms (frame %u): %u blocks compiled during boot (%u blocks/sec, %u precompiled)",
+		(u32)ms, s_bootStatsLastFrame + 1, s_bootStatsBlocks, (u32)((u64)s_bootStatsBlocks * 1000 / ms), s_bootStatsPrewarmed );
+
+	s_bootStatsStart = 0;
+	return true;
+}
+
+static void recBootStatsUpdate()
+{
+	if (!s_bootStatsStart || s_blockCacheWarming || recBootStatsCheck()) return;
+
+	++s_bootStatsBlocks;
+	s_bootStatsLastTicks = GetCPUTicks();
+	s_bootStatsLastFrame = g_FrameCount;
+}
+
+static void recSegmentReset()
+{
+	// Segments are the largest power of two that gives at least 32 of them.
+	const uptr reserve = recMem->GetReserveSizeInBytes();
+	s_recSegShift = 16;
+	while ((reserve >> (s_recSegShift + 1)) >= 32) ++s_recSegShift;
+	s_recSegCount = std::min<uint>(reserve >> s_recSegShift, RecSegmentMaxCount);
+
+	s_recSegCurrent = 0;
+	s_recSegUsed = 1;
+	memzero(s_recSegReferenced);
+	s_recSegReferenced[0] = 1;
+}
+
+static __fi u8* recSegmentPtr(uint seg)
+{
+	return recMem->GetPtr() + ((uptr)seg << s_recSegShift);
+}
+
+// Discards every block whose code lies in the segment, so it can be refilled.
+static void recSegmentEvict(uint seg)
+{
+	const uptr begin = (uptr)recSegmentPtr(seg);
+	const uptr end = begin + ((uptr)1 << s_recSegShift);
+
+	std::vector<BASEBLOCKEX*> victims;
+	for (BASEBLOCKEX* pexblock = recBlocks.First(); pexblock; pexblock = recBlocks.Next(pexblock))
+	{
+		if (pexblock->fnptr >= begin && pexblock->fnptr < end)
+			victims.push_back(pexblock);
+	}
+
+	u64 bytes = 0;
+	for (BASEBLOCKEX* pexblock : victims)
+	{
+		// Only the lookups into this segment are reset: blocks compiled elsewhere may start
+		// inside the victim's range.  (recClear can't be used, it skips the ROM blocks.)
+		for (u32 pc = pexblock->startpc; pc < pexblock->startpc + std::max<u32>(pexblock->size, 1) * 4; pc += 4)
+		{
+			BASEBLOCK* pblock = PC_GETBLOCK(pc);
+			if (pblock->GetFnptr() >= begin && pblock->GetFnptr() < end)
+				pblock->SetFnptr((uptr)JITCompile);
+		}
+
+		bytes += pexblock->x86size;
+		recBlocks.Remove(pexblock);
+	}
+
+	// Jumps inside the segment must not be patched anymore once it is reused.
+	recBlocks.UnlinkRange(begin, end);
+	for (auto it = s_indirectSites.begin(); it != s_indirectSites.end(); )
+	{
+		if (it->first >= begin && it->first < end)
+			it = s_indirectSites.erase(it);
+		else
+			++it;
+	}
+
+	s_codeCacheStats.Evictions++;
+	s_codeCacheStats.BlocksEvicted += victims.size();
+	s_codeCacheStats.BytesReclaimed += bytes;
+
+	DevCon.WriteLn( "EE/iR5900-32: Evicted code segment %u (%u blocks, %u KB)",
+		seg, (u32)victims.size(), (u32)(bytes / _1kb) );
+}
+
+// Moves recPtr to a free segment, evicting the least recently used one if needed.
+static void recSegmentAdvance()
+{
+	uint seg;
+
+	if (s_recSegUsed < s_recSegCount)
+	{
+		seg = s_recSegUsed++;
+	}
+	else
+	{
+		// Clock: skip (and age) referenced segments; after a full turn every bit is clear.
+		seg = s_recSegCurrent;
+		do {
+			seg = (seg + 1) % s_recSegCount;
+			if (seg == s_recSegCurrent) continue;
+			if (!s_recSegReferenced[seg]) break;
+			s_recSegReferenced[seg] = 0;
+		} while (true);
+
+		recSegmentEvict(seg);
+	}
+
+	s_recSegCurrent = seg;
+	s_recSegReferenced[seg] = 1;
+	recPtr = recSegmentPtr(seg);
+}
+
 ////////////////////////////////////////////////////
 static void recResetRaw()
 {
@@ -597,9 +1026,35 @@ static void recResetRaw()
 
 	Console.WriteLn( Color_StrongBlack, "EE/iR5900-32 Recompiler Reset" );
 
+	if (s_codeCacheStats.Evictions)
+	{
+		Console.WriteLn( Color_StrongBlack, "EE/iR5900-32: %u code segments evicted (%u blocks, %u MB reclaimed), %u full resets",
+			s_codeCacheStats.Evictions, s_codeCacheStats.BlocksEvicted,
+			(u32)(s_codeCacheStats.BytesReclaimed / _1mb), s_codeCacheStats.FullResets );
+	}
+	s_codeCacheStats.FullResets++;
+
+	// Capacity resets are part of the boot, the game just recompiles what it needs.
+	if (!recBootStatsCheck() && ElfCRC != s_bootStatsCRC)
+		s_bootStatsStart = 0;
+
+	if (CHECK_EEREC_BLOCKCACHE)
+	{
+		// A different CRC here means the VM was reset or a new ELF was loaded; otherwise
+		// the code cache is just full, and its blocks are kept for the next save.
+		if (ElfCRC != s_blockCacheCRC)
+		{
+			recBlockCacheSave();
+			s_blockCacheCRC = 0;
+		}
+		else
+			recBlockCacheCollect();
+	}
+
 	recMem->Reset();
 	ClearRecLUT((BASEBLOCK*)recLutReserve_RAM, recLutSize);
 	memset(recRAMCopy, 0, Ps2MemSize::MainRam);
+	memzero(subpage_verify_counter);
 
 	maxrecmem = 0;
 
@@ -609,25 +1064,52 @@ static void recResetRaw()
 		memset( s_pInstCache, 0, sizeof(EEINST)*s_nInstCacheSize );
 
 	recBlocks.Reset();
+	s_indirectSites.clear();
 	mmap_ResetBlockTracking();
 
 	x86SetPtr(*recMem);
 
 	recPtr = *recMem;
 	recConstBufPtr = recConstBuf;
+	recSegmentReset();
 
 	g_branch = 0;
 	g_resetEeScalingStats = true;
 	g_patchesNeedRedo = 1;
 }
 
+static FILE* s_blockTrace = NULL;
+
+void recSetBlockTrace(const wxString& tracefile)
+{
+	if (s_blockTrace)
+		fclose(s_blockTrace);
+
+	s_blockTrace = tracefile.IsEmpty() ? NULL : wxFopen(tracefile, L"w");
+	if (!s_blockTrace && !tracefile.IsEmpty())
+		Console.Error(L"EE/iR5900-32: Can't create the block trace file '%s'", WX_STR(tracefile));
+
+	recBlocks.SetTrace(s_blockTrace);
+}
+
 static void recShutdown()
 {
+	if (CHECK_EEREC_BLOCKCACHE && recMem && recMem->IsOk())
+		recBlockCacheSave();
+	s_blockCachePending.clear();
+	s_blockCacheCRC = 0;
+
+	recBootStatsCheck();
+	s_bootStatsStart = 0;
+
 	safe_delete( recMem );
 	safe_aligned_free( recRAMCopy );
 	safe_aligned_free( recLutReserve_RAM );
 
 	recBlocks.Reset();
+	s_indirectSites.clear();
+	if (s_blockTrace)
+		fflush(s_blockTrace);
 
 	recRAM = recROM = recROM1 = recROM2 = NULL;
 
@@ -779,30 +1261,26 @@ void recClear(u32 addr, u32 size)
 	if ((addr) >= maxrecmem || !(recLUT[(addr) >> 16] + (addr & ~0xFFFFUL)))
 		return;
 	addr = HWADDR(addr);
+	recBlocks.TraceClear(addr, size);
 
-	int blockidx = recBlocks.LastIndex(addr + size * 4 - 4);
+	BASEBLOCKEX* pexblock = recBlocks.Last(addr + size * 4 - 4);
 
-	if (blockidx == -1)
+	if (!pexblock)
 		return;
 
 	u32 lowerextent = (u32)-1, upperextent = 0, ceiling = (u32)-1;
 
-	BASEBLOCKEX* pexblock = recBlocks[blockidx + 1];
-	if (pexblock)
-		ceiling = pexblock->startpc;
-
-	int toRemoveLast = blockidx;
+	if (BASEBLOCKEX* nextblock = recBlocks.Next(pexblock))
+		ceiling = nextblock->startpc;
 
-	while (pexblock = recBlocks[blockidx]) {
+	while (pexblock) {
+		BASEBLOCKEX* prevblock = recBlocks.Prev(pexblock);
 		u32 blockstart = pexblock->startpc;
 		u32 blockend = pexblock->startpc + pexblock->size * 4;
 		BASEBLOCK* pblock = PC_GETBLOCK(blockstart);
 
 		if (pblock == s_pCurBlock) {
-			if(toRemoveLast != blockidx) {
-				recBlocks.Remove((blockidx + 1), toRemoveLast);
-			}
-			toRemoveLast = --blockidx;
+			pexblock = prevblock;
 			continue;
 		}
 
@@ -817,25 +1295,24 @@ void recClear(u32 addr, u32 size)
 		// so set it to recompile now.  This will become JITCompile if we clear it.
 		pblock->SetFnptr((uptr)JITCompileInBlock);
 
-		blockidx--;
-	}
-
-	if(toRemoveLast != blockidx) {
-		recBlocks.Remove((blockidx + 1), toRemoveLast);
+		recBlocks.Remove(pexblock);
+		pexblock = prevblock;
 	}
 
 	upperextent = std::min(upperextent, ceiling);
 
-	for (int i = 0; pexblock = recBlocks[i]; i++) {
+	// Only the blocks that can reach the range are checked (one lookup and a short walk), so
+	// this stays cheap enough for release builds.
+	for (pexblock = recBlocks.FirstReaching(addr); pexblock && pexblock->startpc < addr + size * 4; pexblock = recBlocks.Next(pexblock)) {
 		if (s_pCurBlock == PC_GETBLOCK(pexblock->startpc))
 			continue;
 		u32 blockend = pexblock->startpc + pexblock->size * 4;
-		if (pexblock->startpc >= addr && pexblock->startpc < addr + size * 4
-		 || pexblock->startpc < addr && blockend > addr) {
+		if (pexblock->startpc >= addr || blockend > addr) {
 			if( !IsDevBuild )
 				Console.Error( "Impossible block clearing failure" );
 			else
 				pxFailDev( "Impossible block clearing failure" );
+			break;
 		}
 	}
 
@@ -1020,6 +1497,84 @@ static u32 scaleblockcycles()
 	return scaled;
 }
 
+// Register jump targets are mostly monomorphic (function pointers, switch tables, leaf
+// returns), so a site is only retargeted this many times before it settles on the
+// dispatcher.  Keeps the links multimap from growing on polymorphic returns.
+static const u32 IndirectBranchMaxRelinks = 2;
+
+// Called from DispatchIndirectMiss when the prediction of an inline cache site failed.
+// Points the site at the block of cpuRegs.pc if it has already been compiled.
+static void __fastcall recIndirectBranchMiss(uptr site)
+{
+	s_dispatchStats.IndirectMisses++;
+
+	auto it = s_indirectSites.find(site);
+	if (it == s_indirectSites.end() || it->second.relinks >= IndirectBranchMaxRelinks)
+		return;
+
+	const u32 newpc = cpuRegs.pc;
+	if ((newpc & 3) || !(recLUT[newpc >> 16] + (newpc & ~0xFFFFUL)))
+		return;
+
+	const uptr fnptr = PC_GETBLOCK(newpc)->GetFnptr();
+	if (fnptr == (uptr)JITCompile || fnptr == (uptr)JITCompileInBlock)
+		return;		// will be linked on a later miss, once compiled
+
+	BASEBLOCKEX* pexblock = recBlocks.Get(HWADDR(newpc));
+	if (!pexblock || pexblock->startpc != HWADDR(newpc))
+		return;
+
+	IndirectBranchSite& info = it->second;
+	u32* predictedPc = (u32*)site;
+
+	if (info.relinks)
+		recBlocks.Unlink(HWADDR(*predictedPc), info.jumpptr);
+
+	*predictedPc = newpc;
+	recBlocks.Link(HWADDR(newpc), info.jumpptr);
+
+	info.relinks++;
+	s_dispatchStats.IndirectRelinks++;
+}
+
+// Emits the dispatch for a register jump as a one-entry inline cache: the last target
+// pc is compared against cpuRegs.pc and, on a match, the block is entered with a direct
+// jump instead of the recLUT lookup of DispatcherReg.  The direct jump is registered
+// with recBlocks like any static link, so recClear redirects it to JITCompile (which
+// recompiles cpuRegs.pc -- the predicted pc at that point).
+// Expects the flags of the event test (sign = no event pending).
+static void iBranchIndirectPredict()
+{
+	if (EmuConfig.Gamefixes.GoemonTlbHack)
+	{
+		xJS( DispatcherReg );
+		return;
+	}
+
+	xForwardJNS8 eventPending;
+
+	xMOV( eax, ptr[&cpuRegs.pc] );
+	// cmp eax, imm32 -- hand encoded so the immediate is always 32 bits and patchable.
+	// The initial value never matches since EE pcs are word aligned.
+	xWrite8( 0x3d );
+	xWrite32( 1 );
+	u32* predictedPc = ((u32*)xGetPtr()) - 1;
+
+	xForwardJNE8 miss;
+	s32* jumpptr = xJcc32();
+	*jumpptr = (s32)((uptr)DispatcherReg - (uptr)(jumpptr + 1));
+
+	miss.SetTarget();
+	xMOV( ecx, (uptr)predictedPc );
+	xJMP( (void*)DispatchIndirectMiss );
+
+	eventPending.SetTarget();
+
+	IndirectBranchSite& info = s_indirectSites[(uptr)predictedPc];
+	info.jumpptr = jumpptr;
+	info.relinks = 0;
+}
+
 // Generates dynarec code for Event tests followed by a block dispatch (branch).
 // Parameters:
 //   newpc - address to jump to at the end of the block.  If newpc == 0xffffffff then
@@ -1055,7 +1610,7 @@ static void iBranchTest(u32 newpc)
 		xSUB(eax, ptr[&g_nextEventCycle]);
 
 		if (newpc == 0xffffffff)
-			xJS( DispatcherReg );
+			iBranchIndirectPredict();
 		else
 			recBlocks.Link(HWADDR(newpc), xJcc32(Jcc_Signed));
 
@@ -1501,6 +2056,60 @@ void __fastcall dyna_page_reset(u32 start,u32 sz)
 	mmap_MarkCountedRamPage( start );
 }
 
+// Number of dirty-page verifications after which a page under sub-page tracking is checked
+// as a whole and put back under write protection.
+static const uint SubPageVerifyThreshold = 64;
+
+static bool recBlockIsIntact(const BASEBLOCKEX* block)
+{
+	return memcmp(&recRAMCopy[block->startpc], PSM(block->startpc), block->size * 4) == 0;
+}
+
+// Called on entry of a sub-page checked block while its page is dirty (written to since the
+// page was last protected).  Returns zero if the block's code changed and must be discarded.
+static u32 __fastcall recVerifyBlock(u32 start)
+{
+	BASEBLOCKEX* block = recBlocks.Get(start);
+	if (!block || block->startpc != start)
+		return 0;
+
+	const bool intact = recBlockIsIntact(block);
+	const u32 page = start >> 12;
+
+	if (++subpage_verify_counter[page] < SubPageVerifyThreshold)
+		return intact;
+
+	// The page has been verified often enough: weed out the stale blocks and re-protect it,
+	// unless it already bounced too many times (see the manual_counter tweakpoint below).
+	subpage_verify_counter[page] = 0;
+
+	if (manual_counter[page] > 3)
+	{
+		eeRecPerfLog.Write( "Sub-page tracking gave up on page 0x%05X", page );
+		recClear(start & ~0xfffUL, 0x400);
+		return 0;
+	}
+
+	manual_counter[page]++;
+
+	// recClear removes blocks from recBlocks, so collect the stale blocks first.
+	std::vector<std::pair<u32, u32>> stale;
+
+	for (BASEBLOCKEX* pageBlock = recBlocks.Last((start & ~0xfffUL) + 0xffc); pageBlock; pageBlock = recBlocks.Prev(pageBlock))
+	{
+		if ((pageBlock->startpc >> 12) != page)
+			break;
+		if (pageBlock != block && !recBlockIsIntact(pageBlock))
+			stale.push_back(std::make_pair(pageBlock->startpc, (u32)pageBlock->size));
+	}
+
+	for (size_t j = 0; j < stale.size(); ++j)
+		recClear(stale[j].first, stale[j].second);
+
+	mmap_MarkCountedRamPage(start);
+	return intact;
+}
+
 static void memory_protect_recompiled_code(u32 startpc, u32 size)
 {
 	u32 inpage_ptr = HWADDR(startpc);
@@ -1522,6 +2131,25 @@ static void memory_protect_recompiled_code(u32 startpc, u32 size)
         case ProtMode_Write:
 			mmap_MarkCountedRamPage( inpage_ptr );
 			manual_page[inpage_ptr >> 12] = 0;
+
+			if (mmap_HasSubPageChecks( inpage_ptr ))
+			{
+				// Page shares code with data: a write fault only clears the blocks of the
+				// written chunk, so the others must check themselves while the page is dirty.
+				xCMP( ptr8[mmap_GetPageDirtyFlag( inpage_ptr )], 0 );
+				xForwardJE8 pageClean;
+
+				xFastCall((void*)recVerifyBlock, inpage_ptr);
+				xTEST( eax, eax );
+				xForwardJNZ8 blockIntact;
+
+				xMOV( ecx, inpage_ptr );
+				xMOV( edx, inpage_sz / 4 );
+				xJMP( (void*)DispatchBlockDiscard );
+
+				blockIntact.SetTarget();
+				pageClean.SetTarget();
+			}
 			break;
 
         case ProtMode_Manual:
@@ -1623,6 +2251,7 @@ static void __fastcall recRecompile( const u32 startpc )
 	u32 i = 0;
 	u32 willbranch3 = 0;
 	u32 usecop2;
+	recScopedRegFile<cpuRegisters> regFile( cpuRegs );
 
 #ifdef PCSX2_DEBUG
     if (dumplog & 4) iDumpRegisters(startpc, 0);
@@ -1630,17 +2259,17 @@ static void __fastcall recRecompile( const u32 startpc )
 
 	pxAssert( startpc );
 
-	// if recPtr reached the mem limit reset whole mem
-	if (recPtr >= (recMem->GetPtrEnd() - _64kb)) {
-		eeRecNeedsReset = true;
-	}
-	else if ((recConstBufPtr - recConstBuf) >= RECCONSTBUF_SIZE - 64) {
+	if ((recConstBufPtr - recConstBuf) >= RECCONSTBUF_SIZE - 64) {
 		Console.WriteLn("EE recompiler stack reset");
 		eeRecNeedsReset = true;
 	}
 
 	if (eeRecNeedsReset) recResetRaw();
 
+	// if recPtr reached the end of its segment, continue in the next free (or evicted) one
+	if (recPtr >= recSegmentPtr(s_recSegCurrent + 1) - RecSegmentHeadroom)
+		recSegmentAdvance();
+
 	xSetPtr( recPtr );
 	recPtr = xGetAlignedCallTarget();
 
@@ -1707,6 +2336,20 @@ static void __fastcall recRecompile( const u32 startpc )
 		// Apply patch as soon as possible. Normally it is done in
 		// eeGameStarting but first block is already compiled.
 		doPlace0Patches();
+
+		if (CHECK_EEREC_BLOCKCACHE)
+		{
+			// Blocks compiled so far belong to the BIOS/loader, which isn't cached.
+			s_blockCacheCRC = ElfCRC;
+			s_blockCacheWarmup = !EmuConfig.Gamefixes.GoemonTlbHack;
+		}
+
+		s_bootStatsStart = GetCPUTicks();
+		s_bootStatsCRC = ElfCRC;
+		s_bootStatsBlocks = 0;
+		s_bootStatsPrewarmed = 0;
+		s_bootStatsLastTicks = s_bootStatsStart;
+		s_bootStatsLastFrame = g_FrameCount;
 	}
 
 	g_branch = 0;
@@ -2024,14 +2667,10 @@ StartRecomp:
 #endif
 
 	pxAssert( (pc-startpc)>>2 <= 0xffff );
-	s_pCurBlockEx->size = (pc-startpc)>>2;
+	recBlocks.SetSize(s_pCurBlockEx, (pc-startpc)>>2);
 
 	if (HWADDR(pc) <= Ps2MemSize::MainRam) {
-		BASEBLOCKEX *oldBlock;
-		int i;
-
-		i = recBlocks.LastIndex(HWADDR(pc) - 4);
-		while (oldBlock = recBlocks[i--]) {
+		for (BASEBLOCKEX* oldBlock = recBlocks.Last(HWADDR(pc) - 4); oldBlock; oldBlock = recBlocks.Prev(oldBlock)) {
 			if (oldBlock == s_pCurBlockEx)
 				continue;
 			if (oldBlock->startpc >= HWADDR(pc))
@@ -2039,8 +2678,7 @@ StartRecomp:
 			if ((oldBlock->startpc + oldBlock->size * 4) <= HWADDR(startpc))
 				break;
 
-			if (memcmp(&recRAMCopy[oldBlock->startpc / 4], PSM(oldBlock->startpc),
-			           oldBlock->size * 4))
+			if (!recBlockIsIntact(oldBlock))
 			{
 				recClear(startpc, (pc - startpc) / 4);
 				s_pCurBlockEx = recBlocks.Get(HWADDR(startpc));
@@ -2049,7 +2687,10 @@ StartRecomp:
 			}
 		}
 
-		memcpy(&recRAMCopy[HWADDR(startpc) / 4], PSM(startpc), pc - startpc);
+		memcpy(&recRAMCopy[HWADDR(startpc)], PSM(startpc), pc - startpc);
+
+		if (pc > startpc)
+			mmap_MarkCodeChunks(HWADDR(startpc), pc - startpc);
 	}
 
 	s_pCurBlock->SetFnptr((uptr)recPtr);
@@ -2120,6 +2761,13 @@ StartRecomp:
 
 	s_pCurBlock = NULL;
 	s_pCurBlockEx = NULL;
+
+	recBootStatsUpdate();
+
+	// Compiling the cached blocks re-enters recRecompile; the flag is cleared first so it
+	// only happens once.
+	if (s_blockCacheWarmup)
+		recBlockCacheWarmup();
 }
 
 // The only *safe* way to throw exceptions from the context of recompiled code.
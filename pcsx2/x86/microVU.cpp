@@ -19,6 +19,12 @@
 #include "microVU.h"
 
 #include "Utilities/Perf.h"
+#include "Elfheader.h"
+#include "AppConfig.h"
+
+#include <map>
+#include <wx/ffile.h>
+#include <zlib.h>
 
 //------------------------------------------------------------------
 // Micro VU - Main Functions
@@ -71,6 +77,14 @@ void mVUinit(microVU& mVU, uint vuIndex) {
 	mVU.regAlloc.reset(new microRegAlloc(mVU.index));
 }
 
+// Points the program rec-cache limits at a segment
+static void mVUsegmentSet(microVU& mVU, u32 seg) {
+	u8* z = mVU.cache + seg * mVU.prog.segSize;
+	mVU.prog.x86start	= z;
+	mVU.prog.x86ptr		= z;
+	mVU.prog.x86end		= z + mVU.prog.segSize - (mVUcacheSafeZone * _1mb);
+}
+
 // Resets Rec Data
 void mVUreset(microVU& mVU, bool resetReserve) {
 
@@ -98,12 +112,22 @@ void mVUreset(microVU& mVU, bool resetReserve) {
 	mVU.prog.curFrame	=  0;
 
 	// Setup Dynarec Cache Limits for Each Program
-	u8* z = mVU.cache;
-	mVU.prog.x86start	= z;
-	mVU.prog.x86ptr		= z;
-	mVU.prog.x86end		= z + ((mVU.cacheSize - mVUcacheSafeZone) * _1mb);
+	// (the cache is split into segments of at least 16mb, each with its own safe-zone)
+	mVU.prog.segCount	= std::max(1u, std::min(mVUcacheSegments, mVU.cacheSize / 16));
+	mVU.prog.segSize	= (mVU.cacheSize * _1mb) / mVU.prog.segCount;
+	mVU.prog.segCur		= 0;
+	mVU.prog.segUsed	= 1;
+	memzero(mVU.prog.segReferenced);
+	memzero(mVU.prog.segFill);
+	mVUsegmentSet(mVU, 0);
 	//memset(mVU.prog.x86start, 0xcc, mVU.cacheSize*_1mb);
 
+	if (mVU.prog.stats.evictions) {
+		DevCon.WriteLn(mVU.index ? Color_Orange : Color_Magenta, "microVU%d: %u cache segments evicted (%u programs, %u mb reclaimed), %u full resets",
+			mVU.index, mVU.prog.stats.evictions, mVU.prog.stats.progsEvicted,
+			(u32)(mVU.prog.stats.bytesReclaimed / _1mb), mVU.prog.stats.fullResets);
+	}
+
 	for(u32 i = 0; i < (mVU.progSize / 2); i++) {
 		if(!mVU.prog.prog[i]) {
 			mVU.prog.prog[i] = new std::deque<microProgram*>();
@@ -170,6 +194,101 @@ __ri void mVUdeleteProg(microVU& mVU, microProgram*& prog) {
 	safe_aligned_free(prog);
 }
 
+// Deletes every program with code in the segment.  Programs are linked by the jump caches
+// of other programs' JR/JALR blocks, so those are scrubbed too (the freed pointers may be
+// reused by a new program).
+static void mVUsegmentEvict(microVU& mVU, u32 seg) {
+	const uptr begin = (uptr)mVU.cache + seg * mVU.prog.segSize;
+	const uptr end   = begin + mVU.prog.segSize;
+
+	std::vector<microProgram*> victims;
+	for (u32 i = 0; i < (mVU.progSize / 2); i++) {
+		microProgramList* list = mVU.prog.prog[i];
+		for (std::deque<microProgram*>::iterator it(list->begin()); it != list->end(); ) {
+			bool inSegment = false;
+			for (u32 j = 0; j < (mVU.progSize / 2) && !inSegment; j++) {
+				if (!it[0]->block[j]) continue;
+				it[0]->block[j]->forEach([&](microBlock& block) {
+					if ((uptr)block.x86ptrStart >= begin && (uptr)block.x86ptrStart < end) inSegment = true;
+				});
+			}
+			if (inSegment) { victims.push_back(it[0]); it = list->erase(it); }
+			else ++it;
+		}
+	}
+	sortVector(victims);
+
+	auto isVictim = [&](microProgram* prog) {
+		return std::binary_search(victims.begin(), victims.end(), prog);
+	};
+
+	for (u32 i = 0; i < (mVU.progSize / 2); i++) {
+		for (microProgram* prog : *mVU.prog.prog[i]) {
+			for (u32 j = 0; j < (mVU.progSize / 2); j++) {
+				if (!prog->block[j]) continue;
+				prog->block[j]->forEach([&](microBlock& block) {
+					if (!block.jumpCache) return;
+					for (u32 k = 0; k < (mProgSize / 2); k++) {
+						if (block.jumpCache[k].prog && isVictim(block.jumpCache[k].prog))
+							block.jumpCache[k] = microJumpCache();
+					}
+				});
+			}
+		}
+		if (isVictim(mVU.prog.quick[i].prog)) {
+			mVU.prog.quick[i].block = NULL;
+			mVU.prog.quick[i].prog  = NULL;
+		}
+	}
+	if (isVictim(mVU.prog.cur)) {
+		mVU.prog.cur	=  NULL;
+		mVU.prog.isSame	= -1;
+	}
+
+	for (microProgram* prog : victims) mVUdeleteProg(mVU, prog);
+
+	const uptr bytes = mVU.prog.segFill[seg] ? (uptr)mVU.prog.segFill[seg] - begin : 0;
+	mVU.prog.stats.evictions++;
+	mVU.prog.stats.progsEvicted   += victims.size();
+	mVU.prog.stats.bytesReclaimed += bytes;
+	DevCon.WriteLn(mVU.index ? Color_Orange : Color_Magenta, "microVU%d: Evicted cache segment %u (%u programs, %3.1fmb)",
+		mVU.index, seg, (u32)victims.size(), (double)bytes / _1mb);
+}
+
+// Called when the current rec-cache segment is full: continues in a free segment, or
+// evicts the least recently entered one (clock over segReferenced).  With a single
+// segment the whole cache is reset, as there's no older code to reclaim separately.
+void mVUcacheAdvance(microVU& mVU) {
+	if (mVU.prog.segCount == 1) {
+		Console.WriteLn(mVU.index ? Color_Orange : Color_Magenta, "microVU%d: Program cache limit reached.", mVU.index);
+		mVU.prog.stats.fullResets++;
+		mVUreset(mVU, false);
+		return;
+	}
+
+	mVU.prog.segFill[mVU.prog.segCur] = mVU.prog.x86ptr;
+
+	u32 seg;
+	if (mVU.prog.segUsed < mVU.prog.segCount) {
+		seg = mVU.prog.segUsed++;
+	}
+	else {
+		seg = mVU.prog.segCur;
+		for (;;) {
+			seg = (seg + 1) % mVU.prog.segCount;
+			if (seg == mVU.prog.segCur) continue;
+			if (!mVU.prog.segReferenced[seg]) break;
+			mVU.prog.segReferenced[seg] = 0;
+		}
+		mVUsegmentEvict(mVU, seg);
+	}
+
+	mVU.prog.segCur = seg;
+	mVU.prog.segReferenced[seg] = 1;
+	mVU.prog.segFill[seg] = NULL;
+	mVUsegmentSet(mVU, seg);
+}
+
 // Creates a new Micro Program
 __ri microProgram* mVUcreateProg(microVU& mVU, int startPC) {
 	microProgram* prog = (microProgram*)_aligned_malloc(sizeof(microProgram), 64);
@@ -254,53 +373,71 @@ __fi bool mVUcmpProg(microVU& mVU, microProgram& prog, const bool cmpWholeProg)
 	return false;
 }
 
-// Searches for Cached Micro Program and sets prog.cur to it (returns entry-point to program)
-_mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState) {
+// Searches the cached programs for one matching mVU.regs().Micro at startPC, and sets
+// prog.cur and the quick reference to it (returns false if none matches)
+_mVUt __fi bool mVUfindProg(u32 startPC) {
 	microVU& mVU = mVUx;
 	microProgramQuick& quick = mVU.prog.quick[startPC/8];
 	microProgramList*  list  = mVU.prog.prog [startPC/8];
-	if(!quick.prog) { // If null, we need to search for new program
-		std::deque<microProgram*>::iterator it(list->begin());
-		for ( ; it != list->end(); ++it) {
-			bool b = mVUcmpProg(mVU, *it[0], 0);
-			if (EmuConfig.Gamefixes.ScarfaceIbit) {
-				if (isVU1 && ((((u32*)mVU.regs().Micro)[startPC / 4 + 1]) == 0x80200118) &&
-						     ((((u32*)mVU.regs().Micro)[startPC / 4 + 3]) == 0x81000062)) {
-					b = true;
-					mVU.prog.cleared = 0;
-					mVU.prog.cur = it[0];
-					mVU.prog.isSame = 1;
-				}
-            } else if (EmuConfig.Gamefixes.CrashTagTeamRacingIbit) {
-				// Crash tag team tends to make changes to the I register settings in the addresses 0x2bd0 - 0x3ff8
-				// so detect when the code is only changed in this region and don't recompile. Use the same Scarface hack
-				// to access the new I regsiter settings (Look at doIbit() in microVU_Compile.inl
-                if (isVU1 && (memcmp_mmx((u8 *)(it[0]->data), (u8 *)(mVU.regs().Micro), 0x2bd0) == 0)) {
-                    b = true;
-                    mVU.prog.cleared = 0;
-                    mVU.prog.cur = it[0];
-                    mVU.prog.isSame = 1;
-                }
-            }
-			if (b) {
-				quick.block = it[0]->block[startPC/8];
-				quick.prog  = it[0];
-				list->erase(it);
-				list->push_front(quick.prog);
-				return mVUentryGet(mVU, quick.block, startPC, pState);
+	std::deque<microProgram*>::iterator it(list->begin());
+	for ( ; it != list->end(); ++it) {
+		bool b = mVUcmpProg(mVU, *it[0], 0);
+		if (EmuConfig.Gamefixes.ScarfaceIbit) {
+			if (isVU1 && ((((u32*)mVU.regs().Micro)[startPC / 4 + 1]) == 0x80200118) &&
+					     ((((u32*)mVU.regs().Micro)[startPC / 4 + 3]) == 0x81000062)) {
+				b = true;
+				mVU.prog.cleared = 0;
+				mVU.prog.cur = it[0];
+				mVU.prog.isSame = 1;
+			}
+		} else if (EmuConfig.Gamefixes.CrashTagTeamRacingIbit) {
+			// Crash tag team tends to make changes to the I register settings in the addresses 0x2bd0 - 0x3ff8
+			// so detect when the code is only changed in this region and don't recompile. Use the same Scarface hack
+			// to access the new I regsiter settings (Look at doIbit() in microVU_Compile.inl
+			if (isVU1 && (memcmp_mmx((u8 *)(it[0]->data), (u8 *)(mVU.regs().Micro), 0x2bd0) == 0)) {
+				b = true;
+				mVU.prog.cleared = 0;
+				mVU.prog.cur = it[0];
+				mVU.prog.isSame = 1;
 			}
 		}
+		if (b) {
+			quick.block = it[0]->block[startPC/8];
+			quick.prog  = it[0];
+			list->erase(it);
+			list->push_front(quick.prog);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Makes a new program instance from mVU.regs().Micro and compiles it from startPC
+// (returns entry-point to program)
+_mVUt __fi void* mVUcompileProg(u32 startPC, uptr pState) {
+	microVU& mVU = mVUx;
+	microProgramQuick& quick = mVU.prog.quick[startPC/8];
+	mVU.prog.cleared	= 0;
+	mVU.prog.isSame		= 1;
+	mVU.prog.cur		= mVUcreateProg(mVU,  startPC/8);
+	void* entryPoint	= mVUblockFetch(mVU,  startPC, pState);
+	quick.block			= mVU.prog.cur->block[startPC/8];
+	quick.prog			= mVU.prog.cur;
+	mVU.prog.prog[startPC/8]->push_front(mVU.prog.cur);
+	//mVUprintUniqueRatio(mVU);
+	return entryPoint;
+}
+
+// Searches for Cached Micro Program and sets prog.cur to it (returns entry-point to program)
+_mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState) {
+	microVU& mVU = mVUx;
+	microProgramQuick& quick = mVU.prog.quick[startPC/8];
+	if(!quick.prog) { // If null, we need to search for new program
+		if (mVUfindProg<vuIndex>(startPC))
+			return mVUentryGet(mVU, quick.block, startPC, pState);
 
 		// If cleared and program not found, make a new program instance
-		mVU.prog.cleared	= 0;
-		mVU.prog.isSame		= 1;
-		mVU.prog.cur		= mVUcreateProg(mVU,  startPC/8);
-		void* entryPoint	= mVUblockFetch(mVU,  startPC, pState);
-		quick.block			= mVU.prog.cur->block[startPC/8];
-		quick.prog			= mVU.prog.cur;
-		list->push_front(mVU.prog.cur);
-		//mVUprintUniqueRatio(mVU);
-		return entryPoint;
+		return mVUcompileProg<vuIndex>(startPC, pState);
 	}
 	// If list.quick, then we've already found and recompiled the program ;)
 	mVU.prog.isSame	= -1;
@@ -308,6 +445,310 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState) {
 	return mVUentryGet(mVU, quick.block, startPC, pState);
 }
 
+//------------------------------------------------------------------
+// Background Compilation (VU1)
+//------------------------------------------------------------------
+// When a VU1 program isn't cached yet, it is compiled on a worker thread while VU1 runs
+// it on the interpreter, instead of stalling the EE until it is compiled.  The worker owns
+// microVU1 while it compiles, so every VU1 program is interpreted until it's done, and the
+// two cores only trade places between programs (their mid-program state isn't compatible).
+// VU0 can't do this since the EE rec uses microVU0 for COP2, and with MTVU the compiles
+// already happen off the EE thread.
+
+class mVUasyncCompiler : public pxThread {
+	Semaphore m_sem_job;
+	Semaphore m_sem_done;
+	std::atomic<bool> m_busy;	// set by the VU1 caller, cleared by the worker once compiled
+	u32 m_startPC;
+
+public:
+	microProgram* prog;			// Program compiled by the last job
+	u64 compileTicks;			// Time taken by the last job
+
+	mVUasyncCompiler() : m_busy(false), m_startPC(0), prog(NULL), compileTicks(0) {
+		m_name = L"mVU1 Compiler";
+	}
+
+	virtual ~mVUasyncCompiler() {
+		try {
+			pxThread::Cancel();
+		}
+		DESTRUCTOR_CATCHALL
+	}
+
+	bool IsBusy() const { return m_busy.load(std::memory_order_acquire); }
+
+	void Compile(u32 startPC) {
+		pxAssert(!IsBusy());
+		m_startPC = startPC;
+		m_busy.store(true, std::memory_order_release);
+		if (!IsRunning()) Start();
+		m_sem_job.Post();
+	}
+
+	// Waits for the current job, so microVU1 can be touched by the caller again
+	void Wait() {
+		while (IsBusy()) m_sem_done.WaitWithoutYield();
+	}
+
+protected:
+	void ExecuteTaskInThread() {
+		for(;;) {
+			m_sem_job.WaitWithoutYield();
+
+			microVU& mVU = microVU1;
+			u64 start = GetCPUTicks();
+
+			xSetPtr(mVU.prog.x86ptr);
+			mVUcompileProg<1>(m_startPC, (uptr)&mVU.prog.lpState);
+			prog = mVU.prog.cur;
+			mVU.prog.x86ptr = x86Ptr;
+
+			if ((xGetPtr() < mVU.prog.x86start) || (xGetPtr() >= mVU.prog.x86end)) {
+				mVUcacheAdvance(mVU);
+				if (!mVU.prog.cur) prog = NULL; // Evicted (or reset)
+			}
+
+			compileTicks = GetCPUTicks() - start;
+			m_busy.store(false, std::memory_order_release);
+			m_sem_done.Post();
+		}
+	}
+};
+
+static mVUasyncCompiler mVU1async;
+
+struct mVUasyncStats {
+	bool interpreting;		// VU1 program is being run by the interpreter
+	bool pending;			// A compile was started and not swapped in yet
+	u32  interpCycles;		// VU cycles interpreted while waiting for the pending compile
+	u32  swaps;				// Compiled programs swapped in
+	u32  totalInterpCycles;
+	u64  totalCompileTicks;
+};
+
+static mVUasyncStats mVU1asyncStats;
+
+static void mVUasyncReset() {
+	mVU1async.Wait();
+	if (mVU1asyncStats.swaps) {
+		DevCon.WriteLn(Color_Orange, "microVU1: Background compiles: %u programs, %u ms compiling, %u VU cycles interpreted",
+			mVU1asyncStats.swaps, (u32)(mVU1asyncStats.totalCompileTicks * 1000 / GetTickFrequency()), mVU1asyncStats.totalInterpCycles);
+	}
+	memzero(mVU1asyncStats);
+}
+
+// True if the rec left VU1 in the middle of a program: an early exit saves the pipeline
+// state to resume from in lpState, which an E-bit end (and mVUclear) zeroes again
+static bool mVUisResuming(microVU& mVU) {
+	for (size_t i = 0; i < ArraySize(mVU.prog.lpState.full32); i++) {
+		if (mVU.prog.lpState.full32[i]) return true;
+	}
+	return false;
+}
+
+// Runs VU1 on the interpreter if the program can't use the recompiler right now, starting
+// a background compile for it if needed (returns false if the recompiler should run it)
+static bool mVUasyncExecute(u32 cycles) {
+	mVUasyncStats& stats = mVU1asyncStats;
+
+	// Finish the program on the core which started it
+	if (!stats.interpreting) {
+		if (!stats.pending) {
+			if (!CHECK_MICROVU1_ASYNC || (VU0.VI[REG_VPU_STAT].UL & 0x100) == 0)
+				return false;
+
+			// A new program (not resuming one the rec left off) that isn't cached yet
+			if (mVUisResuming(microVU1))
+				return false;
+
+			u32 startPC = (VU1.VI[REG_TPC].UL << 3) & 0x3ff8;
+			if (microVU1.prog.quick[startPC/8].prog || mVUfindProg<1>(startPC))
+				return false;
+
+			stats.pending = true;
+			stats.interpCycles = 0;
+			mVU1async.Compile(startPC);
+		}
+		else if (!mVU1async.IsBusy()) {
+			stats.pending = false;
+			stats.swaps++;
+			stats.totalInterpCycles += stats.interpCycles;
+			stats.totalCompileTicks += mVU1async.compileTicks;
+			if (mVU1async.prog) {
+				DevCon.WriteLn(Color_Orange, "microVU1: Swapped in prog [%03d] [PC=%04x] (compile = %u us, interpreted = %u cycles)",
+					mVU1async.prog->idx, mVU1async.prog->startPC * 8,
+					(u32)(mVU1async.compileTicks * 1000000 / GetTickFrequency()), stats.interpCycles);
+			}
+			return false;
+		}
+	}
+
+	u32 startCycle = VU1.cycle;
+	CpuIntVU1->Execute(cycles);
+	stats.interpCycles += VU1.cycle - startCycle;
+	stats.interpreting  = (VU0.VI[REG_VPU_STAT].UL & 0x100) != 0;
+	return true;
+}
+
+//------------------------------------------------------------------
+// Persistent Program Cache (VU1)
+//------------------------------------------------------------------
+// The x86 code can't be reused across sessions (it embeds host addresses), so the cache
+// stores the microcode image, entry pc and entry pipeline state of every VU1 program that
+// was compiled.  On the next boot of the same game, these programs are compiled up front
+// by temporarily loading each image into micro memory, so known programs don't stall on
+// their first use; mVUcmpProg then matches them against what the game actually uploads.
+
+struct mVUcachedProg {
+	u32				hash;		// crc32 of data
+	u32				startPC;	// Entry pc (in bytes)
+	microRegInfo	state;		// Pipeline state at entry
+	u32				data[mProgSize];
+};
+
+static const u32 ProgCacheMagic		= 0x4355564d; // 'MVUC'
+static const u32 ProgCacheVersion	= 1;
+static const u32 ProgCacheMaxProgs	= 256;
+
+static u32  mVU1cacheCRC	= 0;		// ElfCRC the cached programs belong to
+static bool mVU1cacheWarmed	= false;	// set once the game's programs have been compiled
+
+static wxString mVUprogCacheFilename(u32 crc) {
+	return Path::Combine(GetCacheFolder(), wxsFormat(L"%08X.mvu1", crc));
+}
+
+typedef std::map<std::pair<u32, u32>, std::unique_ptr<mVUcachedProg>> mVUcachedProgMap;
+
+static void mVUprogCacheLoad(u32 crc, mVUcachedProgMap& dest) {
+	const wxString filename(mVUprogCacheFilename(crc));
+	if (!wxFileExists(filename)) return;
+
+	wxFFile fp(filename, L"rb");
+	if (!fp.IsOpened()) return;
+
+	u32 header[4];
+	if (fp.Read(header, sizeof(header)) != sizeof(header)) return;
+	if (header[0] != ProgCacheMagic || header[1] != ProgCacheVersion || header[2] != sizeof(mVUcachedProg)) return;
+
+	const u32 count = std::min(header[3], ProgCacheMaxProgs);
+	for (u32 i = 0; i < count; i++) {
+		std::unique_ptr<mVUcachedProg> prog(new mVUcachedProg);
+		if (fp.Read(prog.get(), sizeof(mVUcachedProg)) != sizeof(mVUcachedProg)) return;
+		if (prog->hash != crc32(0, (u8*)prog->data, sizeof(prog->data))) continue;
+		dest[std::make_pair(prog->hash, prog->startPC)] = std::move(prog);
+	}
+}
+
+// Merges the programs compiled this session into the game's cache file
+static void mVUprogCacheSave() {
+	if (!mVU1cacheCRC || !CHECK_MICROVU1_PROGCACHE) return;
+
+	microVU& mVU = microVU1;
+	mVUcachedProgMap progs;
+	mVUprogCacheLoad(mVU1cacheCRC, progs);
+
+	const size_t oldcount = progs.size();
+
+	for (u32 i = 0; i < (mVU.progSize / 2); i++) {
+		if (!mVU.prog.prog[i]) continue;
+		std::deque<microProgram*>::iterator it(mVU.prog.prog[i]->begin());
+		for ( ; it != mVU.prog.prog[i]->end() && progs.size() < ProgCacheMaxProgs; ++it) {
+			microProgram& prog = *it[0];
+			microBlockManager* entry = prog.block[prog.startPC];
+			if (!entry || !entry->getFirst() || prog.ranges->empty()) continue;
+
+			const u32 hash = crc32(0, (u8*)prog.data, sizeof(prog.data));
+			std::unique_ptr<mVUcachedProg>& cached = progs[std::make_pair(hash, prog.startPC * 8)];
+			if (cached) continue;
+
+			cached.reset(new mVUcachedProg);
+			cached->hash	= hash;
+			cached->startPC	= prog.startPC * 8;
+			cached->state	= entry->getFirst()->pState;
+			memcpy(cached->data, prog.data, sizeof(prog.data));
+		}
+	}
+
+	if (progs.size() == oldcount) return;
+
+	GetCacheFolder().Mkdir();
+
+	const wxString filename(mVUprogCacheFilename(mVU1cacheCRC));
+	wxFFile fp(filename, L"wb");
+	if (!fp.IsOpened()) {
+		Console.Warning(L"microVU1: Could not write program cache %s", WX_STR(filename));
+		return;
+	}
+
+	const u32 header[4] = { ProgCacheMagic, ProgCacheVersion, sizeof(mVUcachedProg), (u32)progs.size() };
+	fp.Write(header, sizeof(header));
+	for (const auto& it : progs)
+		fp.Write(it.second.get(), sizeof(mVUcachedProg));
+
+	DevCon.WriteLn(Color_Orange, L"microVU1: Program cache %08X saved (%u programs, %u new)",
+		mVU1cacheCRC, (u32)progs.size(), (u32)(progs.size() - oldcount));
+}
+
+// Compiles the cached programs of the running game.  Micro memory and the pipeline state
+// are restored afterwards, so this can run between any two VU1 executions.
+static void mVUprogCacheWarmup() {
+	mVU1cacheWarmed = true;
+	mVU1cacheCRC    = ElfCRC;
+
+	mVUcachedProgMap progs;
+	mVUprogCacheLoad(mVU1cacheCRC, progs);
+	if (progs.empty()) return;
+
+	microVU& mVU = microVU1;
+	const u64 start = GetCPUTicks();
+	u32 compiled = 0;
+
+	std::unique_ptr<u8[]> micro(new u8[mVU.microMemSize]);
+	memcpy(micro.get(), mVU.regs().Micro, mVU.microMemSize);
+	microRegInfo lpState = mVU.prog.lpState;
+
+	// Leave room for the game's own compiles: stay in the current segment, and with a single
+	// segment in the first half of it (a cache reset here would lose everything)
+	u8* limit = mVU.prog.x86end;
+	if (mVU.prog.segCount == 1) limit = mVU.prog.x86start + (mVU.prog.x86end - mVU.prog.x86start) / 2;
+
+	xSetPtr(mVU.prog.x86ptr);
+	for (const auto& it : progs) {
+		if (xGetPtr() >= limit) break;
+		const mVUcachedProg& cached = *it.second;
+		memcpy(mVU.regs().Micro, cached.data, mVU.microMemSize);
+		if (mVUfindProg<1>(cached.startPC)) continue;
+		microRegInfo state = cached.state;
+		mVUcompileProg<1>(cached.startPC, (uptr)&state);
+		compiled++;
+	}
+	mVU.prog.x86ptr = x86Ptr;
+
+	// None of these programs is the one in micro memory
+	memcpy(mVU.regs().Micro, micro.get(), mVU.microMemSize);
+	mVU.prog.cleared = 0;
+	mVUclear(mVU, 0, 0);
+	mVU.prog.lpState = lpState;
+
+	const u64 ms = (GetCPUTicks() - start) * 1000 / GetTickFrequency();
+	Console.WriteLn(Color_Orange, "microVU1: Precompiled %u of %u cached programs in %u ms",
+		compiled, (u32)progs.size(), (u32)ms);
+}
+
+// Called before VU1 runs a program; warms the cache once the game's CRC is known
+static __fi void mVUprogCacheUpdate() {
+	if (mVU1cacheWarmed || !ElfCRC || !CHECK_MICROVU1_PROGCACHE) return;
+	if (mVU1asyncStats.pending) return; // The worker owns microVU1
+	mVUprogCacheWarmup();
+}
+
+static void mVUprogCacheReset() {
+	mVUprogCacheSave();
+	if (ElfCRC != mVU1cacheCRC) mVU1cacheCRC = 0;
+	mVU1cacheWarmed = false;
+}
+
 //------------------------------------------------------------------
 // recMicroVU0 / recMicroVU1
 //------------------------------------------------------------------
@@ -334,6 +775,8 @@ void recMicroVU0::Shutdown() noexcept {
 void recMicroVU1::Shutdown() noexcept {
 	if (m_Reserved.exchange(0) == 1) {
 		vu1Thread.WaitVU();
+		mVU1async.Wait();
+		mVUprogCacheSave();
 		mVUclose(microVU1);
 	}
 }
@@ -345,6 +788,8 @@ void recMicroVU0::Reset() {
 void recMicroVU1::Reset() {
 	if(!pxAssertDev(m_Reserved, "MicroVU1 CPU Provider has not been reserved prior to reset!")) return;
 	vu1Thread.WaitVU();
+	mVUasyncReset();
+	mVUprogCacheReset();
 	mVUreset(microVU1, true);
 }
 
@@ -370,9 +815,12 @@ void recMicroVU1::Execute(u32 cycles) {
 	if (!THREAD_VU1) {
 		if(!(VU0.VI[REG_VPU_STAT].UL & 0x100)) return;
 	}
-	VU1.VI[REG_TPC].UL <<= 3;
-	((mVUrecCall)microVU1.startFunct)(VU1.VI[REG_TPC].UL, cycles);
-	VU1.VI[REG_TPC].UL >>= 3;
+	mVUprogCacheUpdate();
+	if (!mVUasyncExecute(cycles)) {
+		VU1.VI[REG_TPC].UL <<= 3;
+		((mVUrecCall)microVU1.startFunct)(VU1.VI[REG_TPC].UL, cycles);
+		VU1.VI[REG_TPC].UL >>= 3;
+	}
 	if(microVU1.regs().flags & 0x4)
 	{
 		microVU1.regs().flags &= ~0x4;
@@ -386,6 +834,7 @@ void recMicroVU0::Clear(u32 addr, u32 size) {
 }
 void recMicroVU1::Clear(u32 addr, u32 size) {
 	pxAssert(m_Reserved); // please allocate me first! :|
+	mVU1async.Wait(); // The worker may be reading micro memory
 	mVUclear(microVU1, addr, size);
 }
 
@@ -404,6 +853,7 @@ void recMicroVU0::SetCacheReserve(uint reserveInMegs) const {
 }
 void recMicroVU1::SetCacheReserve(uint reserveInMegs) const {
 	DevCon.WriteLn("microVU1: Changing cache size [%dmb]", reserveInMegs);
+	mVU1async.Wait();
 	microVU1.cacheSize = std::min(reserveInMegs, mVU1cacheReserve);
 	safe_delete(microVU1.cache_reserve); // I assume this unmaps the memory
 	mVUreserveCache(microVU1); // Need rec-reset after this
@@ -50,12 +50,21 @@ private:
 
 public:
 	inline int getFullListCount() const { return fListI; }
+	// First block compiled at this pc (NULL if none)
+	inline microBlock* getFirst() const {
+		return qBlockList ? &qBlockList->block : (fBlockList ? &fBlockList->block : NULL);
+	}
 	microBlockManager() {
 		qListI = fListI = 0;
 		qBlockEnd = qBlockList = NULL;
 		fBlockEnd = fBlockList = NULL;
 	}
 	~microBlockManager() { reset(); }
+	// Calls f(microBlock&) for every block compiled at this pc
+	template<typename F> void forEach(F f) {
+		for(microBlockLink* linkI = qBlockList; linkI != NULL; linkI = linkI->next) f(linkI->block);
+		for(microBlockLink* linkI = fBlockList; linkI != NULL; linkI = linkI->next) f(linkI->block);
+	}
 	void reset() {
 		for(microBlockLink* linkI = qBlockList; linkI != NULL; ) {
 			microBlockLink* freeI = linkI;
@@ -158,6 +167,15 @@ struct microProgramQuick {
 	microProgram*		  prog;	 // The microProgram who is the owner of 'block'
 };
 
+static const uint mVUcacheSegments = 4; // Max number of rec-cache segments (see mVUcacheAdvance)
+
+struct microCacheStats {
+	u32 evictions;		// Segments reclaimed
+	u32 progsEvicted;	// Programs deleted by those evictions
+	u64 bytesReclaimed;
+	u32 fullResets;		// Cache limit reached with a single segment
+};
+
 struct microProgManager {
 	microIR<mProgSize>	IRinfo;				// IR information
 	microProgramList*	prog [mProgSize/2];	// List of microPrograms indexed by startPC values
@@ -170,6 +188,13 @@ struct microProgManager {
 	u8*					x86ptr;				// Pointer to program's recompilation code
 	u8*					x86start;			// Start of program's rec-cache
 	u8*					x86end;				// Limit of program's rec-cache
+	uptr				segSize;			// Size of a rec-cache segment (x86start/x86end are the current one's bounds)
+	u32					segCount;			// Number of rec-cache segments
+	u32					segCur;				// Segment being compiled into
+	u32					segUsed;			// Segments filled since the last reset
+	u8					segReferenced[mVUcacheSegments]; // Set when a program is entered in the segment
+	u8*					segFill[mVUcacheSegments];		 // Where the code of each segment ends
+	microCacheStats		stats;
 	microRegInfo		lpState;			// Pipeline state from where program left off (useful for continuing execution)
 };
 
@@ -250,6 +275,7 @@ mVUop(mVUopL);
 // Private Functions
 extern void  mVUcacheProg (microVU& mVU, microProgram&  prog);
 extern void  mVUdeleteProg(microVU& mVU, microProgram*& prog);
+extern void  mVUcacheAdvance(microVU& mVU);
 _mVUt extern void* mVUsearchProg(u32 startPC, uptr pState);
 extern void* __fastcall mVUexecuteVU0(u32 startPC, u32 cycles);
 extern void* __fastcall mVUexecuteVU1(u32 startPC, u32 cycles);
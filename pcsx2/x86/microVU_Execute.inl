@@ -117,6 +117,12 @@ void mVUdispatcherCD(mV) {
 // Execution Functions
 //------------------------------------------------------------------
 
+// Marks the rec-cache segment of the entry point as used
+__fi void mVUsegmentTouch(microVU& mVU, void* ptr) {
+	uptr seg = ((uptr)ptr - (uptr)mVU.cache) / mVU.prog.segSize;
+	if (seg < mVU.prog.segCount) mVU.prog.segReferenced[seg] = 1;
+}
+
 // Executes for number of cycles
 _mVUt void* __fastcall mVUexecute(u32 startPC, u32 cycles) {
 
@@ -130,7 +136,9 @@ _mVUt void* __fastcall mVUexecute(u32 startPC, u32 cycles) {
 	mVU.totalCycles = cycles;
 
 	xSetPtr(mVU.prog.x86ptr); // Set x86ptr to where last program left off
-	return mVUsearchProg<vuIndex>(startPC & vuLimit, (uptr)&mVU.prog.lpState); // Find and set correct program
+	void* entry = mVUsearchProg<vuIndex>(startPC & vuLimit, (uptr)&mVU.prog.lpState); // Find and set correct program
+	mVUsegmentTouch(mVU, entry);
+	return entry;
 }
 
 //------------------------------------------------------------------
@@ -146,8 +154,7 @@ _mVUt void mVUcleanUp() {
 	mVU.prog.x86ptr = x86Ptr;
 
 	if ((xGetPtr() < mVU.prog.x86start) || (xGetPtr() >= mVU.prog.x86end)) {
-		Console.WriteLn(vuIndex ? Color_Orange : Color_Magenta, "microVU%d: Program cache limit reached.", mVU.index);
-		mVUreset(mVU, false);
+		mVUcacheAdvance(mVU);
 	}
 
 	mVU.cycles = mVU.totalCycles - mVU.cycles;
@@ -58,6 +58,7 @@ static void (*s_irq)() = NULL;
 static uint8* s_basemem = NULL;
 static int s_vsync = 0;
 static bool s_exclusive = true;
+static bool s_headless = false; // no window, SW and Null renderers draw on the null device
 static const char *s_renderer_name = "";
 static const char *s_renderer_type = "";
 bool gsopen_done = false; // crash guard for GSgetTitleInfo2 and GSKeyEvent (replace with lock?)
@@ -228,7 +229,9 @@ static int _GSopen(void** dsp, const char* title, GSRendererType renderer, int t
 		{
 			// Select the window first to detect the GL requirement
 			std::vector<std::shared_ptr<GSWnd>> wnds;
-			switch (renderer)
+			if (s_headless)
+				wnds.push_back(std::make_shared<GSWndNull>());
+			else switch (renderer)
 			{
 				case GSRendererType::OGL_HW:
 				case GSRendererType::OGL_SW:
@@ -332,7 +335,13 @@ static int _GSopen(void** dsp, const char* title, GSRendererType renderer, int t
 			break;
 		}
 
-		switch (renderer)
+		if (s_headless)
+		{
+			dev = new GSDeviceNull();
+			s_renderer_name = " Null";
+			renderer_fullname = "Null";
+		}
+		else switch (renderer)
 		{
 		default:
 #ifdef _WIN32
@@ -926,6 +935,317 @@ EXPORT_C GSsetExclusive(int enabled)
 	}
 }
 
+// GSLocalMemory throughput per format, readImage being the block path of the format and readImageX the per pixel one
+
+static int Rate(int size, int count, clock_t ticks)
+{
+	return (int)((double)size * count * CLOCKS_PER_SEC / std::max<clock_t>(ticks, 1) / 1000000);
+}
+
+// The block readers go through the SSE2/SSSE3/AVX2 column kernels of GSBlock, ReadImageX and
+// ReadPixel* are scalar. Any difference between them means a kernel of this build is wrong.
+
+static int VerifyReadImage(GSLocalMemory* mem, int psm, int count)
+{
+	const GSLocalMemory::psm_t& p = GSLocalMemory::m_psm[psm];
+
+	if(p.ri == &GSLocalMemory::ReadImageX) return 0;
+
+	std::vector<uint8> a(256 * 256 * 4 + 64);
+	std::vector<uint8> b(a.size());
+
+	int errors = 0;
+
+	for(int k = 0; k < count; k++)
+	{
+		GIFRegBITBLTBUF BITBLTBUF;
+
+		BITBLTBUF.SBP = rand() & 0x1fff;
+		BITBLTBUF.SBW = 1 << (rand() % 4);
+		BITBLTBUF.SPSM = psm;
+
+		GIFRegTRXPOS TRXPOS;
+
+		TRXPOS.SSAX = rand() % (BITBLTBUF.SBW * 64);
+		TRXPOS.SSAY = rand() % 256;
+
+		GIFRegTRXREG TRXREG;
+
+		TRXREG.RRW = 1 + rand() % 256;
+		TRXREG.RRH = 1 + rand() % 256;
+
+		if(p.trbpp == 4)
+		{
+			// ReadImageX only reads whole bytes of 4 bit rows
+
+			TRXPOS.SSAX &= ~1;
+			TRXREG.RRW = (TRXREG.RRW + 1) & ~1;
+		}
+
+		int len = (int)(TRXREG.RRW * TRXREG.RRH * p.trbpp) >> 3;
+		int offset = rand() & 31;
+
+		memset(a.data(), 0, a.size());
+		memset(b.data(), 0, b.size());
+
+		// both readers get the same fifo sized pieces, misaligned by the same offset
+
+		int ax = (int)TRXPOS.SSAX, ay = (int)TRXPOS.SSAY;
+		int bx = (int)TRXPOS.SSAX, by = (int)TRXPOS.SSAY;
+
+		for(int i = 0; i < len; )
+		{
+			int n = rand() & 1 ? len - i : std::min(len - i, 48 * (1 + rand() % 256));
+
+			(mem->*p.ri)(ax, ay, &a[offset + i], n, BITBLTBUF, TRXPOS, TRXREG);
+			mem->ReadImageX(bx, by, &b[offset + i], n, BITBLTBUF, TRXPOS, TRXREG);
+
+			i += n;
+		}
+
+		if(memcmp(a.data(), b.data(), a.size()) != 0)
+		{
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+static int VerifyReadTextureP(GSLocalMemory* mem, int psm, int count)
+{
+	const GSLocalMemory::psm_t& p = GSLocalMemory::m_psm[psm];
+
+	if(p.pal == 0) return 0;
+
+	std::vector<uint8> a(256 * 256);
+
+	GIFRegTEXA TEXA;
+
+	TEXA.u64 = 0;
+
+	int errors = 0;
+
+	for(int k = 0; k < count; k++)
+	{
+		GIFRegTEX0 TEX0;
+
+		TEX0.u64 = 0;
+		TEX0.TBP0 = rand() & 0x1fff;
+		TEX0.TBW = 1 << (rand() % 3);
+		TEX0.PSM = psm;
+
+		int w = std::min<int>(TEX0.TBW * 64, 256);
+		int h = 256;
+
+		const GSOffset* off = mem->GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM);
+
+		(mem->*p.rtxP)(off, GSVector4i(0, 0, w, h), a.data(), w, TEXA);
+
+		bool same = true;
+
+		for(int y = 0; y < h && same; y++)
+		{
+			for(int x = 0; x < w && same; x++)
+			{
+				same = a[y * w + x] == (uint8)(mem->*p.rp)(x, y, TEX0.TBP0, TEX0.TBW);
+			}
+		}
+
+		if(!same)
+		{
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+static void GSBenchmarkLocalMemory()
+{
+	GSLocalMemory* mem = new GSLocalMemory();
+
+	static struct {int psm; const char* name;} s_format[] =
+	{
+		{PSM_PSMCT32, "32"},
+		{PSM_PSMCT24, "24"},
+		{PSM_PSMCT16, "16"},
+		{PSM_PSMCT16S, "16S"},
+		{PSM_PSMT8, "8"},
+		{PSM_PSMT4, "4"},
+		{PSM_PSMT8H, "8H"},
+		{PSM_PSMT4HL, "4HL"},
+		{PSM_PSMT4HH, "4HH"},
+		{PSM_PSMZ32, "32Z"},
+		{PSM_PSMZ24, "24Z"},
+		{PSM_PSMZ16, "16Z"},
+		{PSM_PSMZ16S, "16ZS"},
+	};
+
+	uint8* ptr = (uint8*)_aligned_malloc(1024 * 1024 * 4, 32);
+
+	for(int i = 0; i < 1024 * 1024 * 4; i++) ptr[i] = (uint8)i;
+
+	//
+
+	for(int i = 0; i < GSLocalMemory::m_vmsize; i++) mem->m_vm8[i] = (uint8)rand();
+
+	printf("Mismatches against the per pixel readers (500 random reads)\n\n");
+	printf("[psm]  readImage | readTexture (pal)\n\n");
+
+	for(size_t i = 0; i < countof(s_format); i++)
+	{
+		int ri = VerifyReadImage(mem, s_format[i].psm, 500);
+		int rtxP = VerifyReadTextureP(mem, s_format[i].psm, 500);
+
+		printf("[%4s] %9d | %9d\n", s_format[i].name, ri, rtxP);
+	}
+
+	printf("\n");
+
+	//
+
+	for(int tbw = 5; tbw <= 10; tbw++)
+	{
+		int n = 256 << ((10 - tbw) * 2);
+
+		int w = 1 << tbw;
+		int h = 1 << tbw;
+
+		printf("%d x %d\n\n", w, h);
+		printf("[psm]  writeImage    | readImage     | readImageX    | readTexture   | readTexture (pal)\n");
+		printf("       MB/s   Mp/s   | MB/s   Mp/s   | MB/s   Mp/s   | MB/s   Mp/s   | MB/s   Mp/s\n\n");
+
+		for(size_t i = 0; i < countof(s_format); i++)
+		{
+			const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[s_format[i].psm];
+
+			GSLocalMemory::writeImage wi = psm.wi;
+			GSLocalMemory::readImage ri = psm.ri;
+			GSLocalMemory::readTexture rtx = psm.rtx;
+			GSLocalMemory::readTexture rtxP = psm.rtxP;
+
+			GIFRegBITBLTBUF BITBLTBUF;
+
+			BITBLTBUF.SBP = 0;
+			BITBLTBUF.SBW = w / 64;
+			BITBLTBUF.SPSM = s_format[i].psm;
+			BITBLTBUF.DBP = 0;
+			BITBLTBUF.DBW = w / 64;
+			BITBLTBUF.DPSM = s_format[i].psm;
+
+			GIFRegTRXPOS TRXPOS;
+
+			TRXPOS.SSAX = 0;
+			TRXPOS.SSAY = 0;
+			TRXPOS.DSAX = 0;
+			TRXPOS.DSAY = 0;
+
+			GIFRegTRXREG TRXREG;
+
+			TRXREG.RRW = w;
+			TRXREG.RRH = h;
+
+			GSVector4i r(0, 0, w, h);
+
+			GIFRegTEX0 TEX0;
+
+			TEX0.TBP0 = 0;
+			TEX0.TBW = w / 64;
+
+			GIFRegTEXA TEXA;
+
+			TEXA.TA0 = 0;
+			TEXA.TA1 = 0x80;
+			TEXA.AEM = 0;
+
+			int trlen = w * h * psm.trbpp / 8;
+			int len = w * h * psm.bpp / 8;
+
+			clock_t start, end;
+
+			printf("[%4s] ", s_format[i].name);
+
+			start = clock();
+
+			for(int j = 0; j < n; j++)
+			{
+				int x = 0;
+				int y = 0;
+
+				(mem->*wi)(x, y, ptr, trlen, BITBLTBUF, TRXPOS, TRXREG);
+			}
+
+			end = clock();
+
+			printf("%6d %6d | ", Rate(trlen, n, end - start), Rate(w * h, n, end - start));
+
+			start = clock();
+
+			for(int j = 0; j < n; j++)
+			{
+				int x = 0;
+				int y = 0;
+
+				(mem->*ri)(x, y, ptr, trlen, BITBLTBUF, TRXPOS, TRXREG);
+			}
+
+			end = clock();
+
+			printf("%6d %6d | ", Rate(trlen, n, end - start), Rate(w * h, n, end - start));
+
+			start = clock();
+
+			for(int j = 0; j < n; j++)
+			{
+				int x = 0;
+				int y = 0;
+
+				mem->ReadImageX(x, y, ptr, trlen, BITBLTBUF, TRXPOS, TRXREG);
+			}
+
+			end = clock();
+
+			printf("%6d %6d | ", Rate(trlen, n, end - start), Rate(w * h, n, end - start));
+
+			const GSOffset* off = mem->GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM);
+
+			start = clock();
+
+			for(int j = 0; j < n; j++)
+			{
+				(mem->*rtx)(off, r, ptr, w * 4, TEXA);
+			}
+
+			end = clock();
+
+			printf("%6d %6d ", Rate(len, n, end - start), Rate(w * h, n, end - start));
+
+			if(psm.pal > 0)
+			{
+				start = clock();
+
+				for(int j = 0; j < n; j++)
+				{
+					(mem->*rtxP)(off, r, ptr, w, TEXA);
+				}
+
+				end = clock();
+
+				printf("| %6d %6d ", Rate(len, n, end - start), Rate(w * h, n, end - start));
+			}
+
+			printf("\n");
+		}
+
+		printf("\n");
+	}
+
+	_aligned_free(ptr);
+
+	delete mem;
+}
+
 #ifdef _WIN32
 
 #include <io.h>
@@ -1143,154 +1463,7 @@ EXPORT_C GSBenchmark(HWND hwnd, HINSTANCE hinst, LPSTR lpszCmdLine, int nCmdShow
 
 	if(1)
 	{
-		GSLocalMemory* mem = new GSLocalMemory();		
-
-		static struct {int psm; const char* name;} s_format[] =
-		{
-			{PSM_PSMCT32, "32"},
-			{PSM_PSMCT24, "24"},
-			{PSM_PSMCT16, "16"},
-			{PSM_PSMCT16S, "16S"},
-			{PSM_PSMT8, "8"},
-			{PSM_PSMT4, "4"},
-			{PSM_PSMT8H, "8H"},
-			{PSM_PSMT4HL, "4HL"},
-			{PSM_PSMT4HH, "4HH"},
-			{PSM_PSMZ32, "32Z"},
-			{PSM_PSMZ24, "24Z"},
-			{PSM_PSMZ16, "16Z"},
-			{PSM_PSMZ16S, "16ZS"},
-		};
-
-		uint8* ptr = (uint8*)_aligned_malloc(1024 * 1024 * 4, 32);
-
-		for(int i = 0; i < 1024 * 1024 * 4; i++) ptr[i] = (uint8)i;
-
-		//
-
-		for(int tbw = 5; tbw <= 10; tbw++)
-		{
-			int n = 256 << ((10 - tbw) * 2);
-
-			int w = 1 << tbw;
-			int h = 1 << tbw;
-
-			printf("%d x %d\n\n", w, h);
-
-			for(size_t i = 0; i < countof(s_format); i++)
-			{
-				const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[s_format[i].psm];
-
-				GSLocalMemory::writeImage wi = psm.wi;
-				GSLocalMemory::readImage ri = psm.ri;
-				GSLocalMemory::readTexture rtx = psm.rtx;
-				GSLocalMemory::readTexture rtxP = psm.rtxP;
-
-				GIFRegBITBLTBUF BITBLTBUF;
-
-				BITBLTBUF.SBP = 0;
-				BITBLTBUF.SBW = w / 64;
-				BITBLTBUF.SPSM = s_format[i].psm;
-				BITBLTBUF.DBP = 0;
-				BITBLTBUF.DBW = w / 64;
-				BITBLTBUF.DPSM = s_format[i].psm;
-
-				GIFRegTRXPOS TRXPOS;
-
-				TRXPOS.SSAX = 0;
-				TRXPOS.SSAY = 0;
-				TRXPOS.DSAX = 0;
-				TRXPOS.DSAY = 0;
-
-				GIFRegTRXREG TRXREG;
-
-				TRXREG.RRW = w;
-				TRXREG.RRH = h;
-
-				GSVector4i r(0, 0, w, h);
-
-				GIFRegTEX0 TEX0;
-
-				TEX0.TBP0 = 0;
-				TEX0.TBW = w / 64;
-
-				GIFRegTEXA TEXA;
-
-				TEXA.TA0 = 0;
-				TEXA.TA1 = 0x80;
-				TEXA.AEM = 0;
-
-				int trlen = w * h * psm.trbpp / 8;
-				int len = w * h * psm.bpp / 8;
-
-				clock_t start, end;
-
-				printf("[%4s] ", s_format[i].name);
-
-				start = clock();
-
-				for(int j = 0; j < n; j++)
-				{
-					int x = 0;
-					int y = 0;
-
-					(mem->*wi)(x, y, ptr, trlen, BITBLTBUF, TRXPOS, TRXREG);
-				}
-
-				end = clock();
-
-				printf("%6d %6d | ", (int)((float)trlen * n / (end - start) / 1000), (int)((float)(w * h) * n / (end - start) / 1000));
-
-				start = clock();
-
-				for(int j = 0; j < n; j++)
-				{
-					int x = 0;
-					int y = 0;
-
-					(mem->*ri)(x, y, ptr, trlen, BITBLTBUF, TRXPOS, TRXREG);
-				}
-
-				end = clock();
-
-				printf("%6d %6d | ", (int)((float)trlen * n / (end - start) / 1000), (int)((float)(w * h) * n / (end - start) / 1000));
-
-				const GSOffset* off = mem->GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM);
-
-				start = clock();
-
-				for(int j = 0; j < n; j++)
-				{
-					(mem->*rtx)(off, r, ptr, w * 4, TEXA);
-				}
-
-				end = clock();
-
-				printf("%6d %6d ", (int)((float)len * n / (end - start) / 1000), (int)((float)(w * h) * n / (end - start) / 1000));
-
-				if(psm.pal > 0)
-				{
-					start = clock();
-
-					for(int j = 0; j < n; j++)
-					{
-						(mem->*rtxP)(off, r, ptr, w, TEXA);
-					}
-
-					end = clock();
-
-					printf("| %6d %6d ", (int)((float)len * n / (end - start) / 1000), (int)((float)(w * h) * n / (end - start) / 1000));
-				}
-
-				printf("\n");
-			}
-
-			printf("\n");
-		}
-
-		_aligned_free(ptr);
-
-		delete mem;
+		GSBenchmarkLocalMemory();
 	}
 
 	//
@@ -1562,4 +1735,189 @@ EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 	GSclose();
 	GSshutdown();
 }
+
+// Replays a dump without any display, for benchmarking the SW (or Null) renderer on machines
+// without a GPU. Packets are streamed from the file, and only the time spent in the GS calls
+// is measured, so decompressing the dump doesn't count.
+EXPORT_C GSReplayHeadless(char* lpszCmdLine, int renderer)
+{
+	GLLoader::in_replayer = true;
+
+	GSinit();
+
+	GSRendererType m_renderer = static_cast<GSRendererType>(theApp.GetConfigI("Renderer"));
+
+	switch (m_renderer)
+	{
+		case GSRendererType::OGL_SW:
+		case GSRendererType::DX1011_SW:
+		case GSRendererType::Null:
+			break;
+		default:
+			fprintf(stderr, "headless replay only supports the SW and Null renderers, selected %d\n", static_cast<int>(m_renderer));
+			return;
+	}
+
+	std::vector<uint8> buff;
+	uint8 regs[0x2000];
+
+	GSsetBaseMem(regs);
+
+	s_vsync = 0;
+	s_headless = true;
+
+	int loops = std::max(theApp.GetConfigI("linux_replay"), 1);
+
+	void* hWnd = NULL;
+	int err = _GSopen((void**)&hWnd, "", m_renderer);
+	s_headless = false;
+	if (err != 0) {
+		fprintf(stderr, "Error failed to GSopen\n");
+		return;
+	}
+
+	std::string f(lpszCmdLine);
+	bool is_xz = (f.size() >= 3) && (f.compare(f.size()-3, 3, ".xz") == 0);
+
+	std::vector<double> frame_times; // ms
+	double frame_time = 0;
+
+	for (int loop = 0; loop < loops; loop++)
+	{
+		GSDumpFile* file = is_xz
+			? (GSDumpFile*) new GSDumpLzma(lpszCmdLine, nullptr)
+			: (GSDumpFile*) new GSDumpRaw(lpszCmdLine, nullptr);
+
+		uint32 crc;
+		file->Read(&crc, 4);
+		GSsetGameCRC(crc, 0);
+
+		GSFreezeData fd;
+		file->Read(&fd.size, 4);
+		fd.data = new uint8[fd.size];
+		file->Read(fd.data, fd.size);
+
+		GSfreeze(FREEZE_LOAD, &fd);
+		delete [] fd.data;
+
+		file->Read(regs, 0x2000);
+
+		if (loop == 0)
+			GSvsync(1);
+
+		uint8 type, param;
+		uint32 size;
+
+		while (file->Read(&type, 1))
+		{
+			switch (type)
+			{
+			case 0:
+				file->Read(&param, 1);
+				file->Read(&size, 4);
+
+				if (param == 0)
+				{
+					// path 1 transfers wrap around the end of VU1 memory
+					if (buff.size() < 0x4000) buff.resize(0x4000);
+					file->Read(&buff[0x4000 - size], size);
+				}
+				else
+				{
+					if (buff.size() < size) buff.resize(size);
+					file->Read(&buff[0], size);
+				}
+				break;
+
+			case 1:
+				file->Read(&param, 1);
+				break;
+
+			case 2:
+				file->Read(&size, 4);
+				if (buff.size() < size) buff.resize(size);
+				break;
+
+			case 3:
+				file->Read(regs, 0x2000);
+				break;
+			}
+
+			auto start = std::chrono::steady_clock::now();
+
+			switch (type)
+			{
+			case 0:
+				switch (param)
+				{
+					case 0: GSgifTransfer1(&buff[0], 0x4000 - size); break;
+					case 1: GSgifTransfer2(&buff[0], size / 16); break;
+					case 2: GSgifTransfer3(&buff[0], size / 16); break;
+					case 3: GSgifTransfer(&buff[0], size / 16); break;
+				}
+				break;
+
+			case 1:
+				GSvsync(param);
+				break;
+
+			case 2:
+				GSreadFIFO2(&buff[0], size / 16);
+				break;
+			}
+
+			frame_time += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			if (type == 1)
+			{
+				frame_times.push_back(frame_time);
+				frame_time = 0;
+			}
+		}
+
+		delete file;
+	}
+
+	if (!frame_times.empty())
+	{
+		double total = 0;
+
+		for (double t : frame_times)
+			total += t;
+
+		std::vector<double> sorted(frame_times);
+		std::sort(sorted.begin(), sorted.end());
+
+		auto percentile = [&](int p) { return sorted[std::min(sorted.size() - 1, sorted.size() * p / 100)]; };
+
+		size_t frames = frame_times.size();
+		GSPerfMon& pm = s_gs->m_perfmon;
+
+		fprintf(stdout, "GSdx replay: %zu frames in %.3f s, %.2f fps\n", frames, total / 1000, frames * 1000 / total);
+		fprintf(stdout, "GSdx replay: frame time ms min %.3f avg %.3f p50 %.3f p90 %.3f p99 %.3f max %.3f\n",
+			sorted.front(), total / frames, percentile(50), percentile(90), percentile(99), sorted.back());
+		// GSPerfMon keeps its totals in every build type, including the unix release builds
+		// that define DISABLE_PERF_MON. Syncs and fillrate are only counted by the SW renderer.
+
+		fprintf(stdout, "GSdx replay: per frame %.0f prims, %.0f draws, %.1f syncs, %.0f swizzle KB, %.0f unswizzle KB, %.0f fillrate\n",
+			pm.GetTotal(GSPerfMon::Prim) / frames,
+			pm.GetTotal(GSPerfMon::Draw) / frames,
+			pm.GetTotal(GSPerfMon::SyncPoint) / frames,
+			pm.GetTotal(GSPerfMon::Swizzle) / frames / 1024,
+			pm.GetTotal(GSPerfMon::Unswizzle) / frames / 1024,
+			pm.GetTotal(GSPerfMon::Fillrate) / frames);
+	}
+
+	GSclose();
+	GSshutdown();
+}
+
+EXPORT_C GSBenchmark(char* lpszCmdLine, int renderer)
+{
+	if(GSinit() != 0) return;
+
+	GSBenchmarkLocalMemory();
+
+	GSshutdown();
+}
 #endif
@@ -556,7 +556,7 @@ public:
 	{
 		//for(int j = 0; j < 64; j++) ((uint8*)src)[j] = (uint8)j;
 
-		#if 0//_M_SSE >= 0x501
+		#if _M_SSE >= 0x501
 
 		const GSVector8i* s = (const GSVector8i*)src;
 		
@@ -571,7 +571,17 @@ public:
 
 		v0 = v0.acbd();
 		v1 = v1.acbd();
-		v1 = v1.yxwz();
+
+		// odd columns have the 32-bit groups of every row swapped in pairs
+
+		if((i & 1) == 0)
+		{
+			v1 = v1.yxwz();
+		}
+		else
+		{
+			v0 = v0.yxwz();
+		}
 
 		GSVector8i::storel(&dst[dstpitch * 0], v0);
 		GSVector8i::storeh(&dst[dstpitch * 1], v0);
@@ -651,7 +661,52 @@ public:
 	{
 		//printf("ReadColumn4\n");
 
-		#if _M_SSE >= 0x301
+		#if _M_SSE >= 0x501
+
+		// same steps as below, two of the four vectors per register
+
+		const GSVector4i* s = (const GSVector4i*)src;
+
+		GSVector8i v0 = GSVector8i::load(&s[i * 4 + 0], &s[i * 4 + 2]).xzyw();
+		GSVector8i v1 = GSVector8i::load(&s[i * 4 + 1], &s[i * 4 + 3]).xzyw();
+
+		GSVector8i::sw64(v0, v1);
+
+		const __m256i epi32_0f0f0f0f = _mm256_set1_epi32(0x0f0f0f0f);
+
+		GSVector8i mask(epi32_0f0f0f0f);
+
+		GSVector8i e = (v1 << 4).blend(v0, mask);
+		GSVector8i f = v1.blend(v0 >> 4, mask);
+
+		v0 = e.upl8(f);
+		v1 = e.uph8(f);
+
+		GSVector8i::sw8(v0, v1);
+		GSVector8i::sw128(v0, v1);
+
+		GSVector8i r4mask = GSVector8i::broadcast128(m_r4mask);
+
+		v0 = v0.shuffle8(r4mask);
+		v1 = v1.shuffle8(r4mask);
+
+		if((i & 1) == 0)
+		{
+			e = v0.upl16(v1);
+			f = v1.uph16(v0);
+		}
+		else
+		{
+			e = v1.upl16(v0);
+			f = v0.uph16(v1);
+		}
+
+		GSVector8i::storel(&dst[dstpitch * 0], e);
+		GSVector8i::storeh(&dst[dstpitch * 1], e);
+		GSVector8i::storel(&dst[dstpitch * 2], f);
+		GSVector8i::storeh(&dst[dstpitch * 3], f);
+
+		#elif _M_SSE >= 0x301
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
@@ -1417,6 +1472,42 @@ public:
 		#endif
 	}
 
+	__forceinline static void ReadAndPackBlock24(const uint8* RESTRICT src, uint8* RESTRICT dst, int dstpitch)
+	{
+		alignas(32) uint32 block[8 * 8];
+
+		ReadBlock32(src, (uint8*)block, sizeof(block) / 8);
+
+		#if _M_SSE >= 0x301
+
+		const GSVector4i mask(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128);
+
+		for(int j = 0; j < 8; j++, dst += dstpitch)
+		{
+			GSVector4i v0 = GSVector4i::load<true>(&block[j * 8 + 0]).shuffle8(mask);
+			GSVector4i v1 = GSVector4i::load<true>(&block[j * 8 + 4]).shuffle8(mask);
+
+			GSVector4i::store<false>(&dst[0], v0 | v1.sll<12>());
+			GSVector4i::storel(&dst[16], v1.srl<4>());
+		}
+
+		#else
+
+		for(int j = 0; j < 8; j++, dst += dstpitch)
+		{
+			for(int i = 0; i < 8; i++)
+			{
+				uint32 c = block[j * 8 + i];
+
+				dst[i * 3 + 0] = (uint8)(c);
+				dst[i * 3 + 1] = (uint8)(c >> 8);
+				dst[i * 3 + 2] = (uint8)(c >> 16);
+			}
+		}
+
+		#endif
+	}
+
 	__forceinline static void UnpackAndWriteBlock8H(const uint8* RESTRICT src, int srcpitch, uint8* RESTRICT dst)
 	{
 		GSVector4i v4, v5, v6, v7;
@@ -231,7 +231,7 @@ GSLocalMemory::GSLocalMemory()
 		m_psm[i].rta = &GSLocalMemory::ReadTexel32;
 		m_psm[i].wfa = &GSLocalMemory::WritePixel32;
 		m_psm[i].wi = &GSLocalMemory::WriteImage<PSM_PSMCT32, 8, 8, 32>;
-		m_psm[i].ri = &GSLocalMemory::ReadImageX; // TODO
+		m_psm[i].ri = &GSLocalMemory::ReadImageX;
 		m_psm[i].rtx = &GSLocalMemory::ReadTexture32;
 		m_psm[i].rtxP = &GSLocalMemory::ReadTexture32;
 		m_psm[i].rtxb = &GSLocalMemory::ReadTextureBlock32;
@@ -365,6 +365,17 @@ GSLocalMemory::GSLocalMemory()
 	m_psm[PSM_PSMZ16].wi = &GSLocalMemory::WriteImage<PSM_PSMZ16, 16, 8, 16>;
 	m_psm[PSM_PSMZ16S].wi = &GSLocalMemory::WriteImage<PSM_PSMZ16S, 16, 8, 16>;
 
+	m_psm[PSM_PSMCT32].ri = &GSLocalMemory::ReadImage<PSM_PSMCT32, 8, 8, 32>;
+	m_psm[PSM_PSMCT24].ri = &GSLocalMemory::ReadImage<PSM_PSMCT24, 8, 8, 24>;
+	m_psm[PSM_PSMCT16].ri = &GSLocalMemory::ReadImage<PSM_PSMCT16, 16, 8, 16>;
+	m_psm[PSM_PSMCT16S].ri = &GSLocalMemory::ReadImage<PSM_PSMCT16S, 16, 8, 16>;
+	m_psm[PSM_PSMT8].ri = &GSLocalMemory::ReadImage<PSM_PSMT8, 16, 16, 8>;
+	m_psm[PSM_PSMT4].ri = &GSLocalMemory::ReadImage<PSM_PSMT4, 32, 16, 4>;
+	m_psm[PSM_PSMZ32].ri = &GSLocalMemory::ReadImage<PSM_PSMZ32, 8, 8, 32>;
+	m_psm[PSM_PSMZ24].ri = &GSLocalMemory::ReadImage<PSM_PSMZ24, 8, 8, 24>;
+	m_psm[PSM_PSMZ16].ri = &GSLocalMemory::ReadImage<PSM_PSMZ16, 16, 8, 16>;
+	m_psm[PSM_PSMZ16S].ri = &GSLocalMemory::ReadImage<PSM_PSMZ16S, 16, 8, 16>;
+
 	m_psm[PSM_PSMCT24].rtx = &GSLocalMemory::ReadTexture24;
 	m_psm[PSM_PSGPU24].rtx = &GSLocalMemory::ReadTextureGPU24;
 	m_psm[PSM_PSMCT16].rtx = &GSLocalMemory::ReadTexture16;
@@ -1420,6 +1431,221 @@ void GSLocalMemory::WriteImageX(int& tx, int& ty, const uint8* src, int len, GIF
 
 //
 
+template<int psm, int bsx, int bsy, int alignment>
+void GSLocalMemory::ReadImageBlock(int l, int r, int y, int h, uint8* dst, int dstpitch, const GIFRegBITBLTBUF& BITBLTBUF) const
+{
+	alignas(32) uint8 buff[256]; // one block, if dst cannot take the column stores directly
+
+	uint32 bp = BITBLTBUF.SBP;
+	uint32 bw = BITBLTBUF.SBW;
+
+	// 32/16 bit columns are stored as 32 byte rows with avx2, the rest as 16 byte rows
+
+	const int rowsize = psm == PSM_PSMT8 || psm == PSM_PSMT4 ? 16 : 32;
+	const bool direct = alignment >= (rowsize == 32 && _M_SSE >= 0x501 ? 32 : 16);
+
+	for(int offset = dstpitch * bsy; h >= bsy; h -= bsy, y += bsy, dst += offset)
+	{
+		for(int x = l; x < r; x += bsx)
+		{
+			uint8* d = NULL;
+
+			switch(psm)
+			{
+			case PSM_PSMCT32: d = &dst[x * 4]; break;
+			case PSM_PSMCT24: d = &dst[x * 3]; break;
+			case PSM_PSMCT16: d = &dst[x * 2]; break;
+			case PSM_PSMCT16S: d = &dst[x * 2]; break;
+			case PSM_PSMT8: d = &dst[x]; break;
+			case PSM_PSMT4: d = &dst[x >> 1]; break;
+			case PSM_PSMZ32: d = &dst[x * 4]; break;
+			case PSM_PSMZ24: d = &dst[x * 3]; break;
+			case PSM_PSMZ16: d = &dst[x * 2]; break;
+			case PSM_PSMZ16S: d = &dst[x * 2]; break;
+			default: __assume(0);
+			}
+
+			uint8* RESTRICT o = direct ? d : buff;
+			int opitch = direct ? dstpitch : rowsize;
+
+			switch(psm)
+			{
+			case PSM_PSMCT32: GSBlock::ReadBlock32(BlockPtr32(x, y, bp, bw), o, opitch); break;
+			case PSM_PSMCT24: GSBlock::ReadAndPackBlock24(BlockPtr32(x, y, bp, bw), d, dstpitch); continue;
+			case PSM_PSMCT16: GSBlock::ReadBlock16(BlockPtr16(x, y, bp, bw), o, opitch); break;
+			case PSM_PSMCT16S: GSBlock::ReadBlock16(BlockPtr16S(x, y, bp, bw), o, opitch); break;
+			case PSM_PSMT8: GSBlock::ReadBlock8(BlockPtr8(x, y, bp, bw), o, opitch); break;
+			case PSM_PSMT4: GSBlock::ReadBlock4(BlockPtr4(x, y, bp, bw), o, opitch); break;
+			case PSM_PSMZ32: GSBlock::ReadBlock32(BlockPtr32Z(x, y, bp, bw), o, opitch); break;
+			case PSM_PSMZ24: GSBlock::ReadAndPackBlock24(BlockPtr32Z(x, y, bp, bw), d, dstpitch); continue;
+			case PSM_PSMZ16: GSBlock::ReadBlock16(BlockPtr16Z(x, y, bp, bw), o, opitch); break;
+			case PSM_PSMZ16S: GSBlock::ReadBlock16(BlockPtr16SZ(x, y, bp, bw), o, opitch); break;
+			default: __assume(0);
+			}
+
+			if(!direct)
+			{
+				for(int i = 0; i < bsy; i++, d += dstpitch)
+				{
+					for(int j = 0; j < rowsize; j += 16)
+					{
+						GSVector4i::store<false>(&d[j], GSVector4i::load<true>(&buff[i * rowsize + j]));
+					}
+				}
+			}
+		}
+	}
+}
+
+template<int psm>
+void GSLocalMemory::ReadImageLeftRight(int l, int r, int y, int h, uint8* dst, int dstpitch, const GIFRegBITBLTBUF& BITBLTBUF) const
+{
+	uint32 bp = BITBLTBUF.SBP;
+	uint32 bw = BITBLTBUF.SBW;
+
+	for(; h > 0; y++, h--, dst += dstpitch)
+	{
+		for(int x = l; x < r; x++)
+		{
+			uint32 c;
+
+			switch(psm)
+			{
+			case PSM_PSMCT32: *(uint32*)&dst[x * 4] = ReadPixel32(x, y, bp, bw); break;
+			case PSM_PSMCT24: c = ReadPixel24(x, y, bp, bw); dst[x * 3 + 0] = (uint8)c; dst[x * 3 + 1] = (uint8)(c >> 8); dst[x * 3 + 2] = (uint8)(c >> 16); break;
+			case PSM_PSMCT16: *(uint16*)&dst[x * 2] = (uint16)ReadPixel16(x, y, bp, bw); break;
+			case PSM_PSMCT16S: *(uint16*)&dst[x * 2] = (uint16)ReadPixel16S(x, y, bp, bw); break;
+			case PSM_PSMT8: dst[x] = (uint8)ReadPixel8(x, y, bp, bw); break;
+			case PSM_PSMT4: c = (x & 1) << 2; dst[x >> 1] = (uint8)((dst[x >> 1] & (0xf0 >> c)) | (ReadPixel4(x, y, bp, bw) << c)); break;
+			case PSM_PSMZ32: *(uint32*)&dst[x * 4] = ReadPixel32Z(x, y, bp, bw); break;
+			case PSM_PSMZ24: c = ReadPixel24Z(x, y, bp, bw); dst[x * 3 + 0] = (uint8)c; dst[x * 3 + 1] = (uint8)(c >> 8); dst[x * 3 + 2] = (uint8)(c >> 16); break;
+			case PSM_PSMZ16: *(uint16*)&dst[x * 2] = (uint16)ReadPixel16Z(x, y, bp, bw); break;
+			case PSM_PSMZ16S: *(uint16*)&dst[x * 2] = (uint16)ReadPixel16SZ(x, y, bp, bw); break;
+			default: __assume(0);
+			}
+		}
+	}
+}
+
+template<int psm, int bsx, int bsy, int trbpp>
+void GSLocalMemory::ReadImage(int& tx, int& ty, uint8* dst, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG) const
+{
+	if(TRXREG.RRW == 0) return;
+
+	int l = (int)TRXPOS.SSAX;
+	int r = l + (int)TRXREG.RRW;
+
+	// finish the incomplete row first
+
+	if(tx != l)
+	{
+		int n = std::min(len, (r - tx) * trbpp >> 3);
+		ReadImageX(tx, ty, dst, n, BITBLTBUF, TRXPOS, TRXREG);
+		dst += n;
+		len -= n;
+	}
+
+	int la = (l + (bsx - 1)) & ~(bsx - 1);
+	int ra = r & ~(bsx - 1);
+	int dstpitch = (r - l) * trbpp >> 3;
+	int h = 0;
+
+	// 4 bit rows must start and end on a byte (a single 4 bit pixel wide transfer has no pitch)
+
+	if(dstpitch > 0 && !(trbpp == 4 && ((l | r) & 1)))
+	{
+		h = len / dstpitch;
+	}
+
+	if(ra - la >= bsx && h > 0) // "transfer width" >= "block width" && there is at least one full row
+	{
+		uint8* d = &dst[-l * trbpp >> 3];
+
+		dst += dstpitch * h;
+		len -= dstpitch * h;
+
+		// left part
+
+		if(l < la)
+		{
+			ReadImageLeftRight<psm>(l, la, ty, h, d, dstpitch, BITBLTBUF);
+		}
+
+		// right part
+
+		if(ra < r)
+		{
+			ReadImageLeftRight<psm>(ra, r, ty, h, d, dstpitch, BITBLTBUF);
+		}
+
+		// horizontally aligned part
+
+		if(la < ra)
+		{
+			// top part
+
+			{
+				int h2 = std::min(h, bsy - (ty & (bsy - 1)));
+
+				if(h2 < bsy)
+				{
+					ReadImageLeftRight<psm>(la, ra, ty, h2, d, dstpitch, BITBLTBUF);
+
+					d += dstpitch * h2;
+					ty += h2;
+					h -= h2;
+				}
+			}
+
+			// horizontally and vertically aligned part, whole pages included
+
+			{
+				int h2 = h & ~(bsy - 1);
+
+				if(h2 > 0)
+				{
+					size_t addr = (size_t)&d[la * trbpp >> 3];
+
+					if((addr & 31) == 0 && (dstpitch & 31) == 0)
+					{
+						ReadImageBlock<psm, bsx, bsy, 32>(la, ra, ty, h2, d, dstpitch, BITBLTBUF);
+					}
+					else if((addr & 15) == 0 && (dstpitch & 15) == 0)
+					{
+						ReadImageBlock<psm, bsx, bsy, 16>(la, ra, ty, h2, d, dstpitch, BITBLTBUF);
+					}
+					else
+					{
+						ReadImageBlock<psm, bsx, bsy, 0>(la, ra, ty, h2, d, dstpitch, BITBLTBUF);
+					}
+
+					d += dstpitch * h2;
+					ty += h2;
+					h -= h2;
+				}
+			}
+
+			// bottom part
+
+			if(h > 0)
+			{
+				ReadImageLeftRight<psm>(la, ra, ty, h, d, dstpitch, BITBLTBUF);
+
+				// d += dstpitch * h;
+				ty += h;
+				// h -= h;
+			}
+		}
+	}
+
+	// the rest
+
+	if(len > 0)
+	{
+		ReadImageX(tx, ty, dst, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+}
+
 void GSLocalMemory::ReadImageX(int& tx, int& ty, uint8* dst, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG) const
 {
 	if(len <= 0) return;
@@ -29,12 +29,18 @@ GSPerfMon::GSPerfMon()
 {
 	memset(m_counters, 0, sizeof(m_counters));
 	memset(m_stats, 0, sizeof(m_stats));
+	memset(m_totals, 0, sizeof(m_totals));
 	memset(m_total, 0, sizeof(m_total));
 	memset(m_begin, 0, sizeof(m_begin));
 }
 
 void GSPerfMon::Put(counter_t c, double val)
 {
+	// the totals are kept even with DISABLE_PERF_MON (unix release builds), it is only an add
+	// and the headless replay reports them
+
+	m_totals[c] += c == Frame ? 1 : val;
+
 #ifndef DISABLE_PERF_MON
 	if(c == Frame)
 	{
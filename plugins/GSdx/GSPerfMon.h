@@ -42,6 +42,7 @@ public:
 protected:
 	double m_counters[CounterLast];
 	double m_stats[CounterLast];
+	double m_totals[CounterLast]; // never reset, the frame counter counts frames, counted in every build
 	uint64 m_begin[TimerLast], m_total[TimerLast], m_start[TimerLast];
 	uint64 m_frame;
 	clock_t m_lastframe;
@@ -57,6 +58,7 @@ public:
 
 	void Put(counter_t c, double val = 0);
 	double Get(counter_t c) {return m_stats[c];}
+	double GetTotal(counter_t c) {return m_totals[c];}
 	void Update();
 
 	void Start(int timer = Main);
@@ -24,49 +24,88 @@
 #include "GSdx.h"
 #include "Utilities/boost_spsc_queue.hpp"
 
+// Single producer, single consumer job queue.
+//
+// Neither side takes a lock unless the other one is (about to be) asleep: the worker and a
+// thread in Wait() announce themselves in m_sleeping/m_waiting before blocking, and the
+// other side only does the lock/notify round-trip when it sees the flag. The seq_cst fences
+// pair the flag with the ring indices, so either the sleeper sees the new state or the
+// waker sees the flag.
+
 template<class T, int CAPACITY> class GSJobQueue final
 {
 private:
+	enum {SPIN_COUNT = 1024}; // polls before going to sleep
+
 	std::thread m_thread;
 	std::function<void(T&)> m_func;
-	bool m_exit;
+	std::atomic<bool> m_exit;
 	ringbuffer_base<T, CAPACITY> m_queue;
 
+	std::atomic<bool> m_sleeping;
+	std::atomic<bool> m_waiting;
+
 	std::mutex m_lock;
 	std::mutex m_wait_lock;
 	std::condition_variable m_empty;
 	std::condition_variable m_notempty;
 
 	void ThreadProc() {
-		std::unique_lock<std::mutex> l(m_lock);
-
 		while (true) {
 
+			while (m_queue.consume_one(*this))
+				;
+
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (m_waiting.load(std::memory_order_relaxed)) {
+				{
+					std::lock_guard<std::mutex> wait_guard(m_wait_lock);
+				}
+				m_empty.notify_one();
+			}
+
+			for (int i = 0; i < SPIN_COUNT && m_queue.empty() && !m_exit; i++)
+				_mm_pause();
+
+			if (!m_queue.empty())
+				continue;
+
+			std::unique_lock<std::mutex> l(m_lock);
+
+			m_sleeping.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
 			while (m_queue.empty()) {
-				if (m_exit)
+				if (m_exit) {
+					m_sleeping = false;
 					return;
+				}
 
 				m_notempty.wait(l);
 			}
 
-			l.unlock();
+			m_sleeping = false;
+		}
+	}
 
-			while (m_queue.consume_one(*this))
-				;
+	void Wake() {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
 
+		if (m_sleeping.load(std::memory_order_relaxed)) {
 			{
-				std::lock_guard<std::mutex> wait_guard(m_wait_lock);
+				std::lock_guard<std::mutex> l(m_lock);
 			}
-			m_empty.notify_one();
-
-			l.lock();
+			m_notempty.notify_one();
 		}
 	}
 
 public:
 	GSJobQueue(std::function<void(T&)> func) :
 		m_func(func),
-		m_exit(false)
+		m_exit(false),
+		m_sleeping(false),
+		m_waiting(false)
 	{
 		m_thread = std::thread(&GSJobQueue::ThreadProc, this);
 	}
@@ -88,24 +127,40 @@ public:
 	}
 
 	void Push(const T& item) {
-		while(!m_queue.push(item))
-			std::this_thread::yield();
+		Push(&item, 1);
+	}
 
-		{
-			std::lock_guard<std::mutex> l(m_lock);
+	// Queues count items, the worker is woken up once for all of them
+	void Push(const T* items, size_t count) {
+		for (size_t i = 0; i < count; i++) {
+			while (!m_queue.push(items[i])) {
+				Wake();
+				std::this_thread::yield();
+			}
 		}
-		m_notempty.notify_one();
+
+		Wake();
 	}
 
 	void Wait()
 	{
-		if (IsEmpty())
-			return;
+		for (int i = 0; i < SPIN_COUNT; i++) {
+			if (IsEmpty())
+				return;
+
+			_mm_pause();
+		}
 
 		std::unique_lock<std::mutex> l(m_wait_lock);
+
+		m_waiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
 		while (!IsEmpty())
 			m_empty.wait(l);
 
+		m_waiting = false;
+
 		assert(IsEmpty());
 	}
 
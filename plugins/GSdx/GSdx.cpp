@@ -344,7 +344,9 @@ void GSdxApp::Init()
 	m_default_configuration["dithering_ps2"]                              = "1";
 	m_default_configuration["dump"]                                       = "0";
 	m_default_configuration["extrathreads"]                               = "2";
+	m_default_configuration["extrathreads_binning"]                       = "0";
 	m_default_configuration["extrathreads_height"]                        = "4";
+	m_default_configuration["extrathreads_stats"]                         = "0";
 	m_default_configuration["filter"]                                     = std::to_string(static_cast<int8>(BiFiltering::PS2));
 	m_default_configuration["force_texture_clear"]                        = "0";
 	m_default_configuration["fxaa"]                                       = "0";
@@ -408,6 +410,8 @@ void GSdxApp::Init()
 	m_default_configuration["shaderfx"]                                   = "0";
 	m_default_configuration["shaderfx_conf"]                              = "shaders/GSdx_FX_Settings.ini";
 	m_default_configuration["shaderfx_glsl"]                              = "shaders/GSdx.fx";
+	m_default_configuration["sw_jit_cache"]                               = "1";
+	m_default_configuration["texture_block_hash"]                         = "0";
 	m_default_configuration["TVShader"]                                   = "0";
 	m_default_configuration["upscale_multiplier"]                         = "1";
 	m_default_configuration["UserHacks"]                                  = "0";
@@ -511,6 +515,13 @@ void GSdxApp::SetConfigDir(const char* dir)
 	}
 }
 
+std::string GSdxApp::GetConfigDir()
+{
+	size_t i = m_ini.find_last_of("/\\");
+
+	return i != std::string::npos ? m_ini.substr(0, i + 1) : std::string();
+}
+
 std::string GSdxApp::GetConfigS(const char* entry)
 {
 	char buff[4096] = {0};
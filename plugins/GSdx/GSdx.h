@@ -64,6 +64,7 @@ public:
 	GSRendererType GetCurrentRendererType();
 
 	void SetConfigDir(const char* dir);
+	std::string GetConfigDir();
 
 	std::vector<GSSetting> m_gs_renderers;
 	std::vector<GSSetting> m_gs_interlace;
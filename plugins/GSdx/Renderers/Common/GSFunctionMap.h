@@ -162,6 +162,8 @@ class GSCodeGeneratorFunctionMap : public GSFunctionMap<KEY, VALUE>
 	std::unordered_map<uint64, VALUE> m_cgmap;
 	GSCodeBuffer m_cb;
 	size_t m_total_code_size;
+	std::mutex m_lock; // functions may be precompiled from another thread
+	std::atomic<int> m_misses; // functions generated on first use, outside of Precompile
 
 	enum {MAX_SIZE = 8192};
 
@@ -170,6 +172,7 @@ public:
 		: m_name(name)
 		, m_param(param)
 		, m_total_code_size(0)
+		, m_misses(0)
 	{
 	}
 
@@ -182,6 +185,24 @@ public:
 
 	VALUE GetDefaultFunction(KEY key)
 	{
+		return Generate(key, true);
+	}
+
+	void Precompile(KEY key)
+	{
+		Generate(key, false);
+	}
+
+	int GetMisses(bool reset)
+	{
+		return reset ? m_misses.exchange(0) : (int)m_misses;
+	}
+
+protected:
+	VALUE Generate(KEY key, bool miss)
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+
 		VALUE ret = NULL;
 
 		auto i = m_cgmap.find(key);
@@ -192,6 +213,11 @@ public:
 		}
 		else
 		{
+			if(miss)
+			{
+				m_misses++;
+			}
+
 			void* code_ptr = m_cb.GetBuffer(MAX_SIZE);
 
 			CG* cg = new CG(m_param, key, code_ptr, MAX_SIZE);
@@ -26,6 +26,8 @@
 
 bool GSTextureCache::m_disable_partial_invalidation = false;
 bool GSTextureCache::m_wrap_gs_mem = false;
+bool GSTextureCache::m_block_hash = false;
+GSTextureCache::BlockHashStats GSTextureCache::m_block_hash_stats;
 
 GSTextureCache::GSTextureCache(GSRenderer* r)
 	: m_renderer(r)
@@ -50,6 +52,8 @@ GSTextureCache::GSTextureCache(GSRenderer* r)
 	}
 
 	m_paltex = theApp.GetConfigB("paltex");
+	m_block_hash = theApp.GetConfigB("texture_block_hash");
+	memset(&m_block_hash_stats, 0, sizeof(m_block_hash_stats));
 	m_crc_hack_level = theApp.GetConfigT<CRCHackLevel>("crc_hack_level");
 	if (m_crc_hack_level == CRCHackLevel::Automatic)
 		m_crc_hack_level = GSUtil::GetRecommendedCRCHackLevel(theApp.GetCurrentRendererType());
@@ -1579,7 +1583,15 @@ void GSTextureCache::PrintMemoryUsage()
 	}
 
 	GL_PERF("MEM: RO Tex %dMB. RW Tex %dMB. Target %dMB. Depth %dMB", tex >> 20u, tex_rt >> 20u, rt >> 20u, dss >> 20u);
+
+	if(m_block_hash)
+	{
+		GL_PERF("HASH: %llu blocks unchanged, %llu blocks uploaded again, %lluKB upload saved",
+				m_block_hash_stats.hits, m_block_hash_stats.misses, m_block_hash_stats.saved >> 10u);
+	}
 #endif
+
+	memset(&m_block_hash_stats, 0, sizeof(m_block_hash_stats));
 }
 
 // GSTextureCache::Surface
@@ -1626,6 +1638,37 @@ bool GSTextureCache::Surface::Overlaps(uint32 bp, uint32 bw, uint32 psm, const G
 
 // GSTextureCache::Source
 
+// 64 bit hash of a 256 byte block, four xxhash64 style lanes to keep the multipliers busy
+
+static uint64 HashBlock(const uint8* RESTRICT block)
+{
+	const uint64 prime1 = 0x9E3779B185EBCA87ull;
+	const uint64 prime2 = 0xC2B2AE3D27D4EB4Full;
+
+	const uint64* RESTRICT p = (const uint64*)block;
+
+	uint64 a = prime1 + prime2;
+	uint64 b = prime2;
+	uint64 c = 0;
+	uint64 d = 0 - prime1;
+
+	for(int i = 0; i < 32; i += 4)
+	{
+		a += p[i + 0] * prime2; a = ((a << 31) | (a >> 33)) * prime1;
+		b += p[i + 1] * prime2; b = ((b << 31) | (b >> 33)) * prime1;
+		c += p[i + 2] * prime2; c = ((c << 31) | (c >> 33)) * prime1;
+		d += p[i + 3] * prime2; d = ((d << 31) | (d >> 33)) * prime1;
+	}
+
+	uint64 h = ((a << 1) | (a >> 63)) + ((b << 7) | (b >> 57)) + ((c << 12) | (c >> 52)) + ((d << 18) | (d >> 46));
+
+	h ^= h >> 33;
+	h *= prime2;
+	h ^= h >> 29;
+
+	return h | 1; // 0 is "never uploaded"
+}
+
 GSTextureCache::Source::Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint8* temp, bool dummy_container)
 	: Surface(r, temp)
 	, m_palette_obj(nullptr)
@@ -1698,6 +1741,24 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 
 	uint32 blocks = 0;
 
+	// Blocks invalidated by a transfer are often rewritten with the same data (textures uploaded again every
+	// frame), hashing the GS memory of the block is much cheaper than unswizzling and uploading it again
+
+	uint64* hash = NULL;
+	int hash_pitch = tw / bs.x;
+
+	if(m_block_hash && layer == 0 && !m_repeating)
+	{
+		if(m_hash.empty())
+		{
+			m_hash.resize(hash_pitch * (th / bs.y), 0);
+		}
+
+		hash = m_hash.data();
+	}
+
+	uint32 hash_hits = 0;
+
 	if(m_repeating)
 	{
 		for(int y = r.top; y < r.bottom; y += bs.y)
@@ -1748,6 +1809,26 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 					{
 						m_valid[row] |= col;
 
+						if(hash && x < tw && y < th)
+						{
+							uint64 h = HashBlock(m_renderer->m_mem.BlockPtr(block));
+							uint64& old = hash[(y / bs.y) * hash_pitch + x / bs.x];
+
+							if(old == h)
+							{
+								hash_hits++;
+
+								continue;
+							}
+
+							if(old != 0)
+							{
+								m_block_hash_stats.misses++;
+							}
+
+							old = h;
+						}
+
 						Write(GSVector4i(x, y, x + bs.x, y + bs.y), layer);
 
 						blocks++;
@@ -1757,6 +1838,12 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 		}
 	}
 
+	if(hash_hits > 0)
+	{
+		m_block_hash_stats.hits += hash_hits;
+		m_block_hash_stats.saved += bs.x * bs.y * hash_hits << (m_palette ? 0 : 2);
+	}
+
 	if(blocks > 0)
 	{
 		m_renderer->m_perfmon.Put(GSPerfMon::Unswizzle, bs.x * bs.y * blocks << (m_palette ? 2 : 0));
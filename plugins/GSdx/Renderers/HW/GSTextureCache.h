@@ -121,6 +121,7 @@ public:
 		// Keep a GSTextureCache::SourceMap::m_map iterator to allow fast erase
 		std::array<uint16, MAX_PAGES> m_erase_it;
 		uint32* m_pages_as_bit;
+		std::vector<uint64> m_hash; // content of each block of the texture when it was last uploaded, 0 if never
 
 	public:
 		Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint8* temp, bool dummy_container = false);
@@ -213,6 +214,8 @@ protected:
 	static bool m_disable_partial_invalidation;
 	bool m_texture_inside_rt;
 	static bool m_wrap_gs_mem;
+	static bool m_block_hash;
+	static struct BlockHashStats {uint64 hits, misses, saved;} m_block_hash_stats; // reused/re-uploaded blocks, upload bytes saved
 	uint8 m_texture_inside_rt_cache_size = 255;
 	std::vector<TexInsideRtCacheEntry> m_texture_inside_rt_cache;
 
@@ -26,6 +26,39 @@
 // Lack of a better home
 std::unique_ptr<GSScanlineConstantData> g_const(new GSScanlineConstantData());
 
+static GSScanlineSelector GetEdgeSelector(const GSScanlineSelector& global)
+{
+	GSScanlineSelector sel;
+
+	sel.key = global.key;
+	sel.zwrite = 0;
+	sel.edge = 1;
+
+	return sel;
+}
+
+static GSScanlineSelector GetSetupPrimSelector(const GSScanlineSelector& global)
+{
+	// doesn't need all bits => less functions generated
+
+	GSScanlineSelector sel;
+
+	sel.key = 0;
+
+	sel.iip = global.iip;
+	sel.tfx = global.tfx;
+	sel.tcc = global.tcc;
+	sel.fst = global.fst;
+	sel.fge = global.fge;
+	sel.prim = global.prim;
+	sel.fb = global.fb;
+	sel.zb = global.zb;
+	sel.zoverflow = global.zoverflow;
+	sel.notest = global.notest;
+
+	return sel;
+}
+
 GSDrawScanline::GSDrawScanline()
 	: m_sp_map("GSSetupPrim", &m_local)
 	, m_ds_map("GSDrawScanline", &m_local)
@@ -67,13 +100,7 @@ void GSDrawScanline::BeginDraw(const GSRasterizerData* data)
 
 	if(m_global.sel.aa1)
 	{
-		GSScanlineSelector sel;
-
-		sel.key = m_global.sel.key;
-		sel.zwrite = 0;
-		sel.edge = 1;
-
-		m_de = m_ds_map[sel];
+		m_de = m_ds_map[GetEdgeSelector(m_global.sel)];
 	}
 	else
 	{
@@ -89,24 +116,25 @@ void GSDrawScanline::BeginDraw(const GSRasterizerData* data)
 		m_dr = NULL;
 	}
 
-	// doesn't need all bits => less functions generated
+	m_sp = m_sp_map[GetSetupPrimSelector(m_global.sel)];
+}
+
+void GSDrawScanline::Precompile(uint64 key)
+{
+	// Generates the functions BeginDraw would look up for this selector, without touching the active ones
 
 	GSScanlineSelector sel;
 
-	sel.key = 0;
+	sel.key = key;
+
+	m_ds_map.Precompile(sel);
+
+	if(sel.aa1)
+	{
+		m_ds_map.Precompile(GetEdgeSelector(sel));
+	}
 
-	sel.iip = m_global.sel.iip;
-	sel.tfx = m_global.sel.tfx;
-	sel.tcc = m_global.sel.tcc;
-	sel.fst = m_global.sel.fst;
-	sel.fge = m_global.sel.fge;
-	sel.prim = m_global.sel.prim;
-	sel.fb = m_global.sel.fb;
-	sel.zb = m_global.sel.zb;
-	sel.zoverflow = m_global.sel.zoverflow;
-	sel.notest = m_global.sel.notest;
-
-	m_sp = m_sp_map[sel];
+	m_sp_map.Precompile(GetSetupPrimSelector(sel));
 }
 
 void GSDrawScanline::EndDraw(uint64 frame, uint64 ticks, int actual, int total)
@@ -86,5 +86,8 @@ public:
 
 #endif
 
+	void Precompile(uint64 sel);
+	int GetJITMisses(bool reset) {return m_ds_map.GetMisses(reset) + m_sp_map.GetMisses(reset);}
+
 	void PrintStats() {m_ds_map.PrintStats();}
 };
@@ -39,13 +39,16 @@ static int compute_best_thread_height(int threads) {
 		return 4;
 }
 
-GSRasterizer::GSRasterizer(IDrawScanline* ds, int id, int threads, GSPerfMon* perfmon)
+GSRasterizer::GSRasterizer(IDrawScanline* ds, int id, int threads, GSPerfMon* perfmon, bool all_scanlines)
 	: m_perfmon(perfmon)
 	, m_ds(ds)
 	, m_id(id)
-	, m_threads(threads)
+	, m_threads(all_scanlines ? 1 : threads)
 {
 	memset(&m_pixels, 0, sizeof(m_pixels));
+	memset(&m_work, 0, sizeof(m_work));
+
+	m_done = 0;
 
 	m_thread_height = compute_best_thread_height(threads);
 
@@ -61,7 +64,7 @@ GSRasterizer::GSRasterizer(IDrawScanline* ds, int id, int threads, GSPerfMon* pe
 	{
 		for(int i = 0; i < threads; i++, row++)
 		{
-			m_scanline[row] = i == id ? 1 : 0;
+			m_scanline[row] = i == id || all_scanlines ? 1 : 0;
 		}
 	}
 }
@@ -117,6 +120,7 @@ int GSRasterizer::FindMyNextScanline(int top) const
 void GSRasterizer::Queue(const std::shared_ptr<GSRasterizerData>& data)
 {
 	Draw(data.get());
+	EndDraw(data.get());
 }
 
 int GSRasterizer::GetPixels(bool reset)
@@ -131,6 +135,18 @@ int GSRasterizer::GetPixels(bool reset)
 	return pixels;
 }
 
+void GSRasterizer::GetWorkStats(uint64& ticks, int& tiles, int& prims, bool reset)
+{
+	ticks = m_work.ticks;
+	tiles = m_work.tiles;
+	prims = m_work.prims;
+
+	if(reset)
+	{
+		memset(&m_work, 0, sizeof(m_work));
+	}
+}
+
 void GSRasterizer::Draw(GSRasterizerData* data)
 {
 	GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerDraw0 + m_id);
@@ -140,7 +156,10 @@ void GSRasterizer::Draw(GSRasterizerData* data)
 	m_pixels.actual = 0;
 	m_pixels.total = 0;
 
-	data->start = __rdtsc();
+	uint64 start = __rdtsc();
+	uint64 first = 0;
+
+	data->start.compare_exchange_strong(first, start);
 
 	m_ds->BeginDraw(data);
 
@@ -226,13 +245,105 @@ void GSRasterizer::Draw(GSRasterizerData* data)
 	_mm256_zeroupper();
 	#endif
 
-	data->pixels = m_pixels.actual;
+	uint64 ticks = __rdtsc() - start;
+
+	m_pixels.sum += m_pixels.actual;
+	m_work.ticks += ticks;
+
+	data->ticks += ticks;
+	data->actual += m_pixels.actual;
+	data->total += m_pixels.total;
+}
+
+void GSRasterizer::Draw(GSRasterizerData* data, const GSVector4i& clip, const uint32* prims, int count)
+{
+	// Draws the listed primitives of data, clipped to one tile of the binning mode.
+	// The scanlines are interpolated from the primitives themselves, so the result is
+	// the same as drawing the whole list through the tile's scissor.
+
+	GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerDraw0 + m_id);
+
+	m_pixels.actual = 0;
+	m_pixels.total = 0;
+
+	uint64 start = __rdtsc();
+	uint64 first = 0;
+
+	data->start.compare_exchange_strong(first, start);
+
+	// always begun, the thread drawing the last tile of the draw calls EndDraw
+
+	m_ds->BeginDraw(data);
+
+	m_scissor = data->scissor.rintersect(clip);
+
+	if(m_scissor.rempty()) count = 0;
+
+	m_fscissor_x = GSVector4(m_scissor).xzxz();
+	m_fscissor_y = GSVector4(m_scissor).ywyw();
+
+	uint32 tmp_index[] = {0, 1, 2};
+
+	int n = 0;
+
+	switch(data->primclass)
+	{
+	case GS_POINT_CLASS: n = 1; break;
+	case GS_LINE_CLASS: n = 2; break;
+	case GS_TRIANGLE_CLASS: n = 3; break;
+	case GS_SPRITE_CLASS: n = 2; break;
+	default: __assume(0);
+	}
 
-	uint64 ticks = __rdtsc() - data->start;
+	for(int i = 0; i < count; i++)
+	{
+		const GSVertexSW* vertex = data->vertex;
+		const uint32* index = tmp_index;
+
+		if(data->index != NULL)
+		{
+			index = data->index + prims[i] * n;
+		}
+		else
+		{
+			vertex += prims[i] * n;
+		}
+
+		switch(data->primclass)
+		{
+		case GS_POINT_CLASS: DrawPoint<true>(vertex, 1, index, 1); break;
+		case GS_LINE_CLASS: DrawLine(vertex, index); break;
+		case GS_TRIANGLE_CLASS: DrawTriangle(vertex, index); break;
+		case GS_SPRITE_CLASS: DrawSprite(vertex, index); break;
+		default: __assume(0);
+		}
+	}
+
+	#if _M_SSE >= 0x501
+	_mm256_zeroupper();
+	#endif
+
+	uint64 ticks = __rdtsc() - start;
 
 	m_pixels.sum += m_pixels.actual;
+	m_work.ticks += ticks;
 
-	m_ds->EndDraw(data->frame, ticks, m_pixels.actual, m_pixels.total);
+	data->ticks += ticks;
+	data->actual += m_pixels.actual;
+	data->total += m_pixels.total;
+}
+
+void GSRasterizer::EndDraw(GSRasterizerData* data)
+{
+	// Reports a draw once, with the time and pixels of all its bands or tiles, so both thread
+	// list modes count the same draws. Called by the thread which drew its last part, the
+	// scanline function it has active is the one of this draw.
+
+	if(data->ticks == 0) return; // nothing drawn, see the vertex count test of Draw
+
+	data->pixels = data->actual;
+
+	m_ds->EndDraw(data->frame, data->ticks, data->actual, data->total);
 }
 
 template<bool scissor_test>
@@ -1137,8 +1248,10 @@ void GSRasterizer::DrawEdge(int pixels, int left, int top, const GSVertexSW& sca
 
 //
 
-GSRasterizerList::GSRasterizerList(int threads, GSPerfMon* perfmon)
+GSRasterizerList::GSRasterizerList(int threads, GSPerfMon* perfmon, bool binning)
 	: m_perfmon(perfmon)
+	, m_cur(0)
+	, m_binning(binning)
 {
 	m_thread_height = compute_best_thread_height(threads);
 
@@ -1154,6 +1267,15 @@ GSRasterizerList::GSRasterizerList(int threads, GSPerfMon* perfmon)
 			m_scanline[row] = (uint8)i;
 		}
 	}
+
+	for(auto& batch : m_batch)
+	{
+		batch.bins.resize(2048 >> m_thread_height);
+		batch.next = 0;
+		batch.prims = 0;
+	}
+
+	m_stats_start = __rdtsc();
 }
 
 GSRasterizerList::~GSRasterizerList()
@@ -1163,6 +1285,13 @@ GSRasterizerList::~GSRasterizerList()
 
 void GSRasterizerList::Queue(const std::shared_ptr<GSRasterizerData>& data)
 {
+	if(m_binning)
+	{
+		BinDraw(data);
+
+		return;
+	}
+
 	GSVector4i r = data->bbox.rintersect(data->scissor);
 
 	ASSERT(r.top >= 0 && r.top < 2048 && r.bottom >= 0 && r.bottom < 2048);
@@ -1170,9 +1299,208 @@ void GSRasterizerList::Queue(const std::shared_ptr<GSRasterizerData>& data)
 	int top = r.top >> m_thread_height;
 	int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, top + m_workers.size());
 
+	if(top >= bottom) return;
+
+	// the threads share a single reference instead of copying the shared_ptr into each queue
+
+	data->jobs = bottom - top;
+	data->self = data;
+
 	while(top < bottom)
 	{
-		m_workers[m_scanline[top++]]->Push(data);
+		m_workers[m_scanline[top++]]->Push(data.get());
+	}
+}
+
+void GSRasterizerList::BinDraw(const std::shared_ptr<GSRasterizerData>& data)
+{
+	static const int max_batch_draws = 256;
+	static const int max_batch_prims = 65536;
+
+	if(data->vertex != NULL && data->vertex_count == 0 || data->index != NULL && data->index_count == 0) return;
+
+	Batch& batch = m_batch[m_cur];
+
+	int draw = (int)batch.draws.size();
+
+	int n = 0;
+
+	switch(data->primclass)
+	{
+	case GS_POINT_CLASS: n = 1; break;
+	case GS_LINE_CLASS: n = 2; break;
+	case GS_TRIANGLE_CLASS: n = 3; break;
+	case GS_SPRITE_CLASS: n = 2; break;
+	default: __assume(0);
+	}
+
+	int count = (data->index != NULL ? data->index_count : data->vertex_count) / n;
+
+	const GSVector4i& scissor = data->scissor;
+
+	int prims = 0;
+
+	for(int i = 0; i < count; i++)
+	{
+		const GSVertexSW* v = data->vertex;
+		const uint32* index = data->index;
+
+		// conservative row range of the primitive, the rasterizer does the exact clipping
+
+		float ymin, ymax;
+
+		if(index != NULL)
+		{
+			index += i * n;
+
+			ymin = ymax = v[index[0]].p.y;
+
+			for(int j = 1; j < n; j++)
+			{
+				ymin = std::min(ymin, v[index[j]].p.y);
+				ymax = std::max(ymax, v[index[j]].p.y);
+			}
+		}
+		else
+		{
+			v += i * n;
+
+			ymin = ymax = v[0].p.y;
+
+			for(int j = 1; j < n; j++)
+			{
+				ymin = std::min(ymin, v[j].p.y);
+				ymax = std::max(ymax, v[j].p.y);
+			}
+		}
+
+		int top = std::max<int>((int)floor(ymin), scissor.top);
+		int bottom = std::min<int>((int)ceil(ymax) + 1, scissor.bottom);
+
+		if(top >= bottom) continue;
+
+		top = std::max<int>(top, 0) >> m_thread_height;
+		bottom = (std::min<int>(bottom, 2048) - 1) >> m_thread_height;
+
+		for(int tile = top; tile <= bottom; tile++)
+		{
+			Bin& bin = batch.bins[tile];
+
+			if(bin.spans.empty())
+			{
+				batch.tiles.push_back(tile);
+			}
+
+			if(bin.spans.empty() || bin.spans.back().first != draw)
+			{
+				bin.spans.push_back(std::make_pair(draw, 0));
+
+				data->jobs++;
+			}
+
+			bin.prims.push_back((uint32)i);
+			bin.spans.back().second = (int)bin.prims.size();
+		}
+
+		prims++;
+	}
+
+	if(prims == 0) return;
+
+	batch.draws.push_back(data);
+	batch.prims += prims;
+
+	// keep the threads fed, but let the batch grow while they are busy with the previous one
+
+	bool idle = true;
+
+	for(size_t i = 0; i < m_bin_workers.size(); i++)
+	{
+		if(!m_bin_workers[i]->IsEmpty())
+		{
+			idle = false;
+
+			break;
+		}
+	}
+
+	if(idle || batch.draws.size() >= max_batch_draws || batch.prims >= max_batch_prims)
+	{
+		DispatchBins();
+	}
+}
+
+void GSRasterizerList::DispatchBins()
+{
+	Batch& batch = m_batch[m_cur];
+
+	if(batch.draws.empty()) return;
+
+	WaitBins();
+
+	batch.next = 0;
+
+	Batch* p = &batch;
+
+	for(size_t i = 0; i < m_bin_workers.size(); i++)
+	{
+		m_bin_workers[i]->Push(p);
+	}
+
+	m_cur ^= 1;
+}
+
+void GSRasterizerList::WaitBins()
+{
+	for(size_t i = 0; i < m_bin_workers.size(); i++)
+	{
+		m_bin_workers[i]->Wait();
+	}
+
+	// the batch drawn last holds the page references of its draws until it is released here
+
+	Batch& batch = m_batch[m_cur ^ 1];
+
+	for(int tile : batch.tiles)
+	{
+		batch.bins[tile].prims.clear();
+		batch.bins[tile].spans.clear();
+	}
+
+	batch.tiles.clear();
+	batch.draws.clear();
+	batch.prims = 0;
+}
+
+void GSRasterizerList::DrawBins(GSRasterizer& r, Batch& batch)
+{
+	int count = (int)batch.tiles.size();
+
+	for(int i = batch.next.fetch_add(1); i < count; i = batch.next.fetch_add(1))
+	{
+		int tile = batch.tiles[i];
+
+		const Bin& bin = batch.bins[tile];
+
+		GSVector4i clip(0, tile << m_thread_height, 2048, (tile + 1) << m_thread_height);
+
+		int begin = 0;
+
+		for(const auto& span : bin.spans)
+		{
+			GSRasterizerData* data = batch.draws[span.first].get();
+
+			r.Draw(data, clip, &bin.prims[begin], span.second - begin);
+
+			if(data->jobs.fetch_sub(1) == 1)
+			{
+				r.EndDraw(data);
+			}
+
+			begin = span.second;
+		}
+
+		r.CountTile((int)bin.prims.size());
 	}
 }
 
@@ -1180,6 +1508,12 @@ void GSRasterizerList::Sync()
 {
 	if(!IsSynced())
 	{
+		if(m_binning)
+		{
+			DispatchBins();
+			WaitBins();
+		}
+
 		for(size_t i = 0; i < m_workers.size(); i++)
 		{
 			m_workers[i]->Wait();
@@ -1189,8 +1523,52 @@ void GSRasterizerList::Sync()
 	}
 }
 
+void GSRasterizerList::SyncDraws(uint64 seq)
+{
+	if(m_binning)
+	{
+		// draws are completed in batches, a partial wait wouldn't gain much
+
+		Sync();
+
+		return;
+	}
+
+	// A thread whose queue is empty or which already finished draw seq cannot be working on
+	// anything older, the queues are in order. The newer draws may keep running meanwhile.
+
+	bool waited = false;
+
+	for(size_t i = 0; i < m_workers.size(); i++)
+	{
+		for(int spin = 0; !m_workers[i]->IsEmpty() && m_r[i]->GetDone() < seq; spin++)
+		{
+			if(spin < 1024)
+			{
+				_mm_pause();
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+
+			waited = true;
+		}
+	}
+
+	if(waited)
+	{
+		m_perfmon->Put(GSPerfMon::SyncPoint, 1);
+	}
+}
+
 bool GSRasterizerList::IsSynced() const
 {
+	if(m_binning)
+	{
+		return m_batch[0].draws.empty() && m_batch[1].draws.empty();
+	}
+
 	for(size_t i = 0; i < m_workers.size(); i++)
 	{
 		if(!m_workers[i]->IsEmpty())
@@ -1206,10 +1584,55 @@ int GSRasterizerList::GetPixels(bool reset)
 {
 	int pixels = 0;
 
-	for(size_t i = 0; i < m_workers.size(); i++)
+	for(size_t i = 0; i < m_r.size(); i++)
 	{
 		pixels += m_r[i]->GetPixels(reset);
 	}
 
 	return pixels;
 }
+
+void GSRasterizerList::Precompile(uint64 sel)
+{
+	for(size_t i = 0; i < m_r.size(); i++)
+	{
+		m_r[i]->Precompile(sel);
+	}
+}
+
+int GSRasterizerList::GetJITMisses(bool reset)
+{
+	int misses = 0;
+
+	for(size_t i = 0; i < m_r.size(); i++)
+	{
+		misses += m_r[i]->GetJITMisses(reset);
+	}
+
+	return misses;
+}
+
+void GSRasterizerList::PrintStats()
+{
+	uint64 now = __rdtsc();
+	uint64 elapsed = std::max<uint64>(now - m_stats_start, 1);
+
+	m_stats_start = now;
+
+	for(size_t i = 0; i < m_r.size(); i++)
+	{
+		uint64 ticks;
+		int tiles, prims;
+
+		m_r[i]->GetWorkStats(ticks, tiles, prims);
+
+		if(m_binning)
+		{
+			printf("GSdx: rasterizer %d busy %.1f%%, %d tiles, %.1f prims/tile\n", (int)i, (double)ticks * 100 / elapsed, tiles, tiles > 0 ? (double)prims / tiles : 0.0);
+		}
+		else
+		{
+			printf("GSdx: rasterizer %d busy %.1f%%\n", (int)i, (double)ticks * 100 / elapsed);
+		}
+	}
+}
@@ -42,9 +42,14 @@ public:
 	uint32* index;
 	int index_count;
 	uint64 frame;
-	uint64 start;
+	std::atomic<uint64> start; // when the first thread (or tile) started drawing it
 	int pixels;
 	int counter;
+	uint64 seq; // increasing in queue order, see IRasterizer::SyncDraws
+	std::shared_ptr<GSRasterizerData> self; // one reference for all the queued jobs
+	std::atomic<int> jobs; // the thread drawing the last job reports the draw and releases self
+	std::atomic<uint64> ticks; // summed over the jobs, see GSRasterizer::EndDraw
+	std::atomic<int> actual, total;
 
 	GSRasterizerData() 
 		: scissor(GSVector4i::zero())
@@ -58,6 +63,11 @@ public:
 		, frame(0)
 		, start(0)
 		, pixels(0)
+		, seq(0)
+		, jobs(0)
+		, ticks(0)
+		, actual(0)
+		, total(0)
 	{
 		counter = s_counter++;
 	}
@@ -104,6 +114,9 @@ public:
 	
 #endif
 
+	virtual void Precompile(uint64 sel) = 0;
+	virtual int GetJITMisses(bool reset) = 0;
+
 	virtual void PrintStats() = 0;
 
 	__forceinline bool HasEdge() const {return m_de != NULL;}
@@ -117,8 +130,11 @@ public:
 
 	virtual void Queue(const std::shared_ptr<GSRasterizerData>& data) = 0;
 	virtual void Sync() = 0;
+	virtual void SyncDraws(uint64 seq) = 0; // waits for the draws queued up to seq only
 	virtual bool IsSynced() const = 0;
 	virtual int GetPixels(bool reset = true) = 0;
+	virtual void Precompile(uint64 sel) = 0;
+	virtual int GetJITMisses(bool reset = true) = 0;
 	virtual void PrintStats() = 0;
 };
 
@@ -136,6 +152,8 @@ protected:
 	GSVector4 m_fscissor_y;
 	struct {GSVertexSW* buff; int count;} m_edge;
 	struct {int sum, actual, total;} m_pixels;
+	struct {uint64 ticks; int tiles, prims;} m_work;
+	std::atomic<uint64> m_done; // seq of the last draw finished by the worker thread
 
 	typedef void (GSRasterizer::*DrawPrimPtr)(const GSVertexSW* v, int count);
 
@@ -160,7 +178,7 @@ protected:
 	__forceinline void DrawEdge(int pixels, int left, int top, const GSVertexSW& scan);
 
 public:
-	GSRasterizer(IDrawScanline* ds, int id, int threads, GSPerfMon* perfmon);
+	GSRasterizer(IDrawScanline* ds, int id, int threads, GSPerfMon* perfmon, bool all_scanlines = false);
 	virtual ~GSRasterizer();
 
 	__forceinline bool IsOneOfMyScanlines(int top) const;
@@ -168,29 +186,70 @@ public:
 	__forceinline int FindMyNextScanline(int top) const;
 
 	void Draw(GSRasterizerData* data);
+	void Draw(GSRasterizerData* data, const GSVector4i& clip, const uint32* prims, int count);
+	void EndDraw(GSRasterizerData* data);
+
+	void CountTile(int prims) {m_work.tiles++; m_work.prims += prims;}
+	void SetDone(uint64 seq) {m_done.store(seq, std::memory_order_release);}
+	uint64 GetDone() const {return m_done.load(std::memory_order_acquire);}
+	void GetWorkStats(uint64& ticks, int& tiles, int& prims, bool reset = true);
 
 	// IRasterizer
 
 	void Queue(const std::shared_ptr<GSRasterizerData>& data);
 	void Sync() {}
+	void SyncDraws(uint64 seq) {}
 	bool IsSynced() const {return true;}
 	int GetPixels(bool reset);
+	void Precompile(uint64 sel) {m_ds->Precompile(sel);}
+	int GetJITMisses(bool reset) {return m_ds->GetJITMisses(reset);}
 	void PrintStats() {m_ds->PrintStats();}
 };
 
 class GSRasterizerList : public IRasterizer
 {
 protected:
-	using GSWorker = GSJobQueue<std::shared_ptr<GSRasterizerData>, 65536>;
+	// Binning mode: instead of every thread walking every primitive of a draw and keeping
+	// its own interleaved bands, the queued draws are binned into full-width tiles of
+	// 1 << m_thread_height rows, and the threads take whole tiles (every primitive of a
+	// batch of draws that touches it) until none is left.
+
+	struct Bin
+	{
+		std::vector<uint32> prims;
+		std::vector<std::pair<int, int>> spans; // draw index, end of its primitives in prims
+	};
+
+	struct Batch
+	{
+		std::vector<std::shared_ptr<GSRasterizerData>> draws;
+		std::vector<Bin> bins;
+		std::vector<int> tiles; // bins which aren't empty
+		std::atomic<int> next; // next entry of tiles to be drawn
+		int prims;
+	};
+
+	using GSWorker = GSJobQueue<GSRasterizerData*, 65536>;
+	using GSBinWorker = GSJobQueue<Batch*, 4>;
 
 	GSPerfMon* m_perfmon;
+	Batch m_batch[2]; // one being binned, one being drawn
+	int m_cur;
+	bool m_binning;
+	uint64 m_stats_start;
 	// Worker threads depend on the rasterizers, so don't change the order.
 	std::vector<std::unique_ptr<GSRasterizer>> m_r;
 	std::vector<std::unique_ptr<GSWorker>> m_workers;
+	std::vector<std::unique_ptr<GSBinWorker>> m_bin_workers;
 	uint8* m_scanline;
 	int m_thread_height;
 
-	GSRasterizerList(int threads, GSPerfMon* perfmon);
+	GSRasterizerList(int threads, GSPerfMon* perfmon, bool binning);
+
+	void BinDraw(const std::shared_ptr<GSRasterizerData>& data);
+	void DispatchBins();
+	void WaitBins();
+	void DrawBins(GSRasterizer& r, Batch& batch);
 
 public:
 	virtual ~GSRasterizerList();
@@ -204,14 +263,31 @@ public:
 			return new GSRasterizer(new DS(), 0, 1, perfmon);
 		}
 
-		GSRasterizerList* rl = new GSRasterizerList(threads, perfmon);
+		bool binning = theApp.GetConfigB("extrathreads_binning");
+
+		GSRasterizerList* rl = new GSRasterizerList(threads, perfmon, binning);
 
 		for(int i = 0; i < threads; i++)
 		{
-			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i, threads, perfmon)));
+			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i, threads, perfmon, binning)));
 			auto &r = *rl->m_r[i];
-			rl->m_workers.push_back(std::unique_ptr<GSWorker>(new GSWorker(
-				[&r](std::shared_ptr<GSRasterizerData> &item) { r.Draw(item.get()); })));
+
+			if(binning)
+			{
+				rl->m_bin_workers.push_back(std::unique_ptr<GSBinWorker>(new GSBinWorker(
+					[rl, &r](Batch* &batch) { rl->DrawBins(r, *batch); })));
+			}
+			else
+			{
+				rl->m_workers.push_back(std::unique_ptr<GSWorker>(new GSWorker(
+					[&r](GSRasterizerData* &item)
+					{
+						uint64 seq = item->seq;
+						r.Draw(item);
+						if(item->jobs.fetch_sub(1) == 1) {r.EndDraw(item); item->self.reset();}
+						r.SetDone(seq);
+					})));
+			}
 		}
 
 		return rl;
@@ -221,7 +297,10 @@ public:
 
 	void Queue(const std::shared_ptr<GSRasterizerData>& data);
 	void Sync();
+	void SyncDraws(uint64 seq);
 	bool IsSynced() const;
 	int GetPixels(bool reset);
-	void PrintStats() {}
+	void Precompile(uint64 sel);
+	int GetJITMisses(bool reset);
+	void PrintStats();
 };
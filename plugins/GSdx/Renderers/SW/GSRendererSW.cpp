@@ -50,6 +50,13 @@ GSRendererSW::GSRendererSW(int threads)
 	memset(m_texture, 0, sizeof(m_texture));
 
 	m_rl = GSRasterizerList::Create<GSDrawScanline>(threads, &m_perfmon);
+	m_rl_stats = theApp.GetConfigB("extrathreads_stats");
+
+	m_jit.enabled = theApp.GetConfigB("sw_jit_cache");
+	m_jit.crc = 0;
+	m_jit.last = (uint64)-1;
+	m_jit.stop = false;
+	m_jit.misses = 0;
 
 	m_output = (uint8*)_aligned_malloc(1024 * 1024 * sizeof(uint32), 32);
 
@@ -60,6 +67,12 @@ GSRendererSW::GSRendererSW(int threads)
 		m_tex_pages[i] = 0;
 	}
 
+	memset(m_fzb_seq, 0, sizeof(m_fzb_seq));
+	memset(m_tex_seq, 0, sizeof(m_tex_seq));
+	memset(&m_sync_stats, 0, sizeof(m_sync_stats));
+
+	m_seq = 0;
+
 	#define InitCVB2(P, Q) \
 		m_cvb[P][0][0][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 0, Q>; \
 		m_cvb[P][0][1][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 1, Q>; \
@@ -87,6 +100,8 @@ GSRendererSW::GSRendererSW(int threads)
 
 GSRendererSW::~GSRendererSW()
 {
+	SaveJITCache();
+
 	delete m_tc;
 
 	for(size_t i = 0; i < countof(m_texture); i++)
@@ -99,6 +114,95 @@ GSRendererSW::~GSRendererSW()
 	_aligned_free(m_output);
 }
 
+static std::string GetJITCachePath(uint32 crc)
+{
+	return theApp.GetConfigDir() + format("GSdx_sw_%08X.jit", crc);
+}
+
+void GSRendererSW::LoadJITCache(uint32 crc)
+{
+	m_jit.crc = crc;
+	m_jit.last = (uint64)-1;
+	m_jit.keys.clear();
+	m_jit.misses = 0;
+
+	m_rl->GetJITMisses(true);
+
+	if(crc == 0) return;
+
+	std::vector<uint64> keys;
+
+	if(FILE* fp = fopen(GetJITCachePath(crc).c_str(), "r"))
+	{
+		unsigned long long key;
+
+		while(fscanf(fp, "%llx", &key) == 1)
+		{
+			if(m_jit.keys.insert(key).second)
+			{
+				keys.push_back(key);
+			}
+		}
+
+		fclose(fp);
+	}
+
+	if(keys.empty()) return;
+
+	printf("GSdx: precompiling %zu scanline functions for %08X\n", keys.size(), crc);
+
+	// The generated code refers to the local data of each rasterizer thread, so only the
+	// selectors are saved, and compiled again into every thread's code buffer.
+
+	m_jit.stop = false;
+
+	m_jit.thread = std::thread([this, keys]()
+	{
+		for(uint64 key : keys)
+		{
+			if(m_jit.stop) break;
+
+			m_rl->Precompile(key);
+		}
+	});
+}
+
+void GSRendererSW::SaveJITCache()
+{
+	if(m_jit.thread.joinable())
+	{
+		m_jit.stop = true;
+		m_jit.thread.join();
+	}
+
+	m_jit.misses += m_rl->GetJITMisses(true);
+
+	if(m_jit.crc == 0 || m_jit.keys.empty()) return;
+
+	if(FILE* fp = fopen(GetJITCachePath(m_jit.crc).c_str(), "w"))
+	{
+		for(uint64 key : m_jit.keys)
+		{
+			fprintf(fp, "%016llx\n", (unsigned long long)key);
+		}
+
+		fclose(fp);
+
+		printf("GSdx: saved %zu scanline selectors for %08X, %d functions were compiled on first use\n", m_jit.keys.size(), m_jit.crc, m_jit.misses);
+	}
+}
+
+void GSRendererSW::SetGameCRC(uint32 crc, int options)
+{
+	GSRenderer::SetGameCRC(crc, options);
+
+	if(m_jit.enabled && crc != m_jit.crc)
+	{
+		SaveJITCache();
+		LoadJITCache(crc);
+	}
+}
+
 void GSRendererSW::Reset()
 {
 	Sync(-1);
@@ -149,7 +253,33 @@ void GSRendererSW::VSync(int field)
 
 	m_tc->IncAge();
 
-	// if((m_perfmon.GetFrame() & 255) == 0) m_rl->PrintStats();
+	if(int misses = m_rl->GetJITMisses(true))
+	{
+		m_jit.misses += misses;
+
+		if(m_rl_stats)
+		{
+			printf("GSdx: %d scanline functions compiled on first use in frame %llu\n", misses, m_perfmon.GetFrame());
+		}
+	}
+
+	m_sync_stats.frames++;
+
+	if(m_rl_stats && (m_perfmon.GetFrame() & 255) == 0)
+	{
+		m_rl->PrintStats();
+
+		std::string s;
+
+		for(int i = 0; i < (int)countof(m_sync_stats.count); i++)
+		{
+			s += format(" %d: %.2f/%.2f", i, (float)m_sync_stats.count[i] / m_sync_stats.frames, (float)m_sync_stats.partial[i] / m_sync_stats.frames);
+		}
+
+		printf("GSdx: syncs per frame by reason (full/partial)%s\n", s.c_str());
+
+		memset(&m_sync_stats, 0, sizeof(m_sync_stats));
+	}
 }
 
 void GSRendererSW::ResetDevice()
@@ -471,18 +601,22 @@ void GSRendererSW::Draw()
 		zb_pages = m_context->offset.zb->GetPages(r);
 	}
 
+	sd->seq = ++m_seq;
+
 	// check if there is an overlap between this and previous targets
 
-	if(CheckTargetPages(fb_pages, zb_pages, r))
+	if(uint64 seq = CheckTargetPages(fb_pages, zb_pages, r))
 	{
 		sd->m_syncpoint = SharedData::SyncTarget;
+		sd->m_syncseq = seq;
 	}
 
 	// check if the texture is not part of a target currently in use
 
-	if(CheckSourcePages(sd))
+	if(uint64 seq = CheckSourcePages(sd))
 	{
 		sd->m_syncpoint = SharedData::SyncSource;
+		sd->m_syncseq = std::max(sd->m_syncseq, seq);
 	}
 
 	// addref source and target pages
@@ -594,7 +728,7 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 
 	if(sd->m_syncpoint == SharedData::SyncSource) 
 	{
-		Sync(4);
+		Sync(4, sd->m_syncseq);
 	}
 
 	// update previously invalidated parts
@@ -603,7 +737,7 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 
 	if(sd->m_syncpoint == SharedData::SyncTarget)
 	{
-		Sync(5);
+		Sync(5, sd->m_syncseq);
 	}
 
 	if(LOG)
@@ -620,6 +754,12 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 		fflush(s_fp);
 	}
 
+	if(sd->global.sel.key != m_jit.last)
+	{
+		m_jit.last = sd->global.sel.key;
+		m_jit.keys.insert(m_jit.last);
+	}
+
 	m_rl->Queue(item);
 
 	// invalidate new parts rendered onto
@@ -637,10 +777,29 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 	}
 }
 
+void GSRendererSW::Sync(int reason, uint64 seq)
+{
+	// only waits for the queued draws up to seq, the ones touching the conflicting pages
+
+	if(reason >= 0 && reason < (int)countof(m_sync_stats.partial)) m_sync_stats.partial[reason]++;
+
+	GSPerfMonAutoTimer pmat(&m_perfmon, GSPerfMon::Sync);
+
+	uint64 t = __rdtsc();
+
+	m_rl->SyncDraws(seq);
+
+	t = __rdtsc() - t;
+
+	if(LOG) {fprintf(s_fp, "sync n=%d r=%d seq=%llu/%llu t=%llu\n", s_n, reason, seq, m_seq, t); fflush(s_fp);}
+}
+
 void GSRendererSW::Sync(int reason)
 {
 	//printf("sync %d\n", reason);
 
+	if(reason >= 0 && reason < (int)countof(m_sync_stats.count)) m_sync_stats.count[reason]++;
+
 	GSPerfMonAutoTimer pmat(&m_perfmon, GSPerfMon::Sync);
 
 	uint64 t = __rdtsc();
@@ -687,14 +846,16 @@ void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 
 	if(!m_rl->IsSynced())
 	{
+		uint64 seq = 0;
+
 		for(uint32* RESTRICT p = m_tmp_pages; *p != GSOffset::EOP; p++)
 		{
-			if(m_fzb_pages[*p] | m_tex_pages[*p])
-			{
-				Sync(6);
+			seq = std::max(seq, std::max(GetTargetSeq(*p), GetSourceSeq(*p)));
+		}
 
-				break;
-			}
+		if(seq)
+		{
+			Sync(6, seq);
 		}
 	}
 
@@ -711,14 +872,16 @@ void GSRendererSW::InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 
 		off->GetPages(r, m_tmp_pages);
 
+		uint64 seq = 0;
+
 		for(uint32* RESTRICT p = m_tmp_pages; *p != GSOffset::EOP; p++)
 		{
-			if(m_fzb_pages[*p])
-			{
-				Sync(7);
+			seq = std::max(seq, GetTargetSeq(*p));
+		}
 
-				break;
-			}
+		if(seq)
+		{
+			Sync(7, seq);
 		}
 	}
 }
@@ -730,14 +893,17 @@ void GSRendererSW::UsePages(const uint32* pages, const int type)
 			case 0:
 				ASSERT((m_fzb_pages[*p] & 0xFFFF) < USHRT_MAX);
 				m_fzb_pages[*p] += 1;
+				m_fzb_seq[*p] = m_seq;
 				break;
 			case 1:
 				ASSERT((m_fzb_pages[*p] >> 16) < USHRT_MAX);
 				m_fzb_pages[*p] += 0x10000;
+				m_fzb_seq[*p] = m_seq;
 				break;
 			case 2:
 				ASSERT(m_tex_pages[*p] < USHRT_MAX);
 				m_tex_pages[*p] += 1;
+				m_tex_seq[*p] = m_seq;
 				break;
 			default:break;
 		}
@@ -765,14 +931,16 @@ void GSRendererSW::ReleasePages(const uint32* pages, const int type)
 	}
 }
 
-bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r)
+uint64 GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r)
 {
+	// returns the last queued draw which must be done before this one, or 0
+
 	bool synced = m_rl->IsSynced();
 
 	bool fb = fb_pages != NULL;
 	bool zb = zb_pages != NULL;
 
-	bool res = false;
+	uint64 res = 0;
 
 	if(m_fzb != m_context->offset.fzb4)
 	{
@@ -786,7 +954,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 		memset(m_fzb_cur_pages, 0, sizeof(m_fzb_cur_pages));
 
-		uint32 used = 0;
+		uint64 used = 0;
 
 		for(const uint32* p = fb_pages; *p != GSOffset::EOP; p++)
 		{
@@ -797,8 +965,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 			m_fzb_cur_pages[row] |= col;
 
-			used |= m_fzb_pages[i];
-			used |= m_tex_pages[i];
+			used = std::max(used, std::max(GetTargetSeq(i), GetSourceSeq(i)));
 		}
 
 		for(const uint32* p = zb_pages; *p != GSOffset::EOP; p++)
@@ -810,8 +977,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 			m_fzb_cur_pages[row] |= col;
 
-			used |= m_fzb_pages[i];
-			used |= m_tex_pages[i];
+			used = std::max(used, std::max(GetTargetSeq(i), GetSourceSeq(i)));
 		}
 
 		if(!synced)
@@ -820,7 +986,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 			{
 				if(LOG) {fprintf(s_fp, "syncpoint 0\n"); fflush(s_fp);}
 
-				res = true;
+				res = used;
 			}
 
 			//if(LOG) {fprintf(s_fp, "no syncpoint *\n"); fflush(s_fp);}
@@ -843,7 +1009,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 			if(fb_pages == NULL) fb_pages = m_context->offset.fb->GetPages(r);
 			if(zb_pages == NULL) zb_pages = m_context->offset.zb->GetPages(r);
 
-			uint32 used = 0;
+			uint64 used = 0;
 
 			for(const uint32* p = fb_pages; *p != GSOffset::EOP; p++)
 			{
@@ -856,7 +1022,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 				{
 					m_fzb_cur_pages[row] |= col;
 
-					used |= m_fzb_pages[i];
+					used = std::max(used, GetTargetSeq(i));
 				}
 			}
 
@@ -871,7 +1037,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 				{
 					m_fzb_cur_pages[row] |= col;
 
-					used |= m_fzb_pages[i];
+					used = std::max(used, GetTargetSeq(i));
 				}
 			}
 
@@ -881,7 +1047,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 				{
 					if(LOG) {fprintf(s_fp, "syncpoint 1\n"); fflush(s_fp);}
 
-					res = true;
+					res = used;
 				}
 			}
 		}
@@ -891,34 +1057,30 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 			// chross-check frame and z-buffer pages, they cannot overlap with eachother and with previous batches in queue,
 			// have to be careful when the two buffers are mutually enabled/disabled and alternating (Bully FBP/ZBP = 0x2300)
 
-			if(fb && !res)
+			if(fb)
 			{
 				for(const uint32* p = fb_pages; *p != GSOffset::EOP; p++)
 				{
 					if(m_fzb_pages[*p] & 0xffff0000)
 					{
-						if(LOG) {fprintf(s_fp, "syncpoint 2\n"); fflush(s_fp);}
-
-						res = true;
-
-						break;
+						res = std::max(res, m_fzb_seq[*p]);
 					}
 				}
+
+				if(res && LOG) {fprintf(s_fp, "syncpoint 2\n"); fflush(s_fp);}
 			}
 
-			if(zb && !res)
+			if(zb)
 			{
 				for(const uint32* p = zb_pages; *p != GSOffset::EOP; p++)
 				{
 					if(m_fzb_pages[*p] & 0x0000ffff)
 					{
-						if(LOG) {fprintf(s_fp, "syncpoint 3\n"); fflush(s_fp);}
-
-						res = true;
-
-						break;
+						res = std::max(res, m_fzb_seq[*p]);
 					}
 				}
+
+				if(res && LOG) {fprintf(s_fp, "syncpoint 3\n"); fflush(s_fp);}
 			}
 		}
 	}
@@ -929,8 +1091,10 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 	return res;
 }
 
-bool GSRendererSW::CheckSourcePages(SharedData* sd)
+uint64 GSRendererSW::CheckSourcePages(SharedData* sd)
 {
+	uint64 seq = 0;
+
 	if(!m_rl->IsSynced())
 	{
 		for(size_t i = 0; sd->m_tex[i].t != NULL; i++)
@@ -943,15 +1107,12 @@ bool GSRendererSW::CheckSourcePages(SharedData* sd)
 			{
 				// TODO: 8H 4HL 4HH texture at the same place as the render target (24 bit, or 32-bit where the alpha channel is masked, Valkyrie Profile 2)
 
-				if(m_fzb_pages[*p]) // currently being drawn to? => sync
-				{
-					return true;
-				}
+				seq = std::max(seq, GetTargetSeq(*p)); // currently being drawn to? => sync
 			}
 		}
 	}
 
-	return false;
+	return seq;
 }
 
 #include "GSTextureSW.h"
@@ -1432,6 +1593,7 @@ GSRendererSW::SharedData::SharedData(GSRendererSW* parent)
 	, m_zpsm(0)
 	, m_using_pages(false)
 	, m_syncpoint(SyncNone)
+	, m_syncseq(0)
 {
 	m_tex[0].t = NULL;
 
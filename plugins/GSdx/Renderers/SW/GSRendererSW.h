@@ -48,6 +48,7 @@ class GSRendererSW : public GSRenderer
 		bool m_using_pages;
 		TextureLevel m_tex[7 + 1]; // NULL terminated
 		enum {SyncNone, SyncSource, SyncTarget} m_syncpoint;
+		uint64 m_syncseq; // the queued draws up to this one must be done first
 
 	public:
 		SharedData(GSRendererSW* parent);
@@ -69,6 +70,18 @@ class GSRendererSW : public GSRenderer
 
 protected:
 	IRasterizer* m_rl;
+	bool m_rl_stats;
+
+	struct
+	{
+		bool enabled;
+		uint32 crc;
+		uint64 last;
+		std::unordered_set<uint64> keys; // scanline selectors drawn with since the game was set
+		std::thread thread; // precompiles the selectors saved for the game
+		std::atomic<bool> stop;
+		int misses;
+	} m_jit;
 	GSTextureCacheSW* m_tc;
 	GSTexture* m_texture[2];
 	uint8* m_output;
@@ -77,10 +90,19 @@ protected:
 	uint32 m_fzb_cur_pages[16];
 	std::atomic<uint32> m_fzb_pages[512]; // uint16 frame/zbuf pages interleaved
 	std::atomic<uint16> m_tex_pages[512];
+	uint64 m_fzb_seq[512]; // last draw which used the page as frame/zbuf
+	uint64 m_tex_seq[512]; // last draw which used the page as texture
+	uint64 m_seq; // of the draw being set up
 	uint32 m_tmp_pages[512 + 1];
 
+	struct {int count[8], partial[8], frames;} m_sync_stats; // per reason
+
+	void LoadJITCache(uint32 crc);
+	void SaveJITCache();
+
 	void Reset();
 	void VSync(int field);
+	void SetGameCRC(uint32 crc, int options);
 	void ResetDevice();
 	GSTexture* GetOutput(int i, int& y_offset);
 	GSTexture* GetFeedbackOutput();
@@ -88,14 +110,17 @@ protected:
 	void Draw();
 	void Queue(std::shared_ptr<GSRasterizerData>& item);
 	void Sync(int reason);
+	void Sync(int reason, uint64 seq);
 	void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r);
 	void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false);
 
 	void UsePages(const uint32* pages, const int type);
+	uint64 GetTargetSeq(uint32 page) const {return m_fzb_pages[page] ? m_fzb_seq[page] : 0;}
+	uint64 GetSourceSeq(uint32 page) const {return m_tex_pages[page] ? m_tex_seq[page] : 0;}
 	void ReleasePages(const uint32* pages, const int type);
 
-	bool CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r);
-	bool CheckSourcePages(SharedData* sd);
+	uint64 CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r);
+	uint64 CheckSourcePages(SharedData* sd);
 
 	bool GetScanlineGlobalData(SharedData* data);
 
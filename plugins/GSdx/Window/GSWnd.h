@@ -56,6 +56,30 @@ public:
 
 };
 
+// Window-less target of the null device, for headless replays. Nothing is ever displayed.
+
+class GSWndNull : public GSWnd
+{
+	GSVector4i m_rect;
+
+public:
+	GSWndNull() : m_rect(0, 0, 640, 480) {};
+	virtual ~GSWndNull() {};
+
+	bool Create(const std::string& title, int w, int h) {m_rect = GSVector4i(0, 0, w, h); return true;}
+	bool Attach(void* handle, bool managed = true) {m_managed = managed; return true;}
+	void Detach() {}
+
+	void* GetDisplay() {return NULL;}
+	void* GetHandle() {return NULL;}
+	GSVector4i GetClientRect() {return m_rect;}
+	bool SetWindowText(const char* title) {return true;}
+
+	void Show() {}
+	void Hide() {}
+	void HideFrame() {}
+};
+
 class GSWndGL : public GSWnd
 {
 protected:
@@ -28,6 +28,8 @@ static void* handle;
 void help()
 {
 	fprintf(stderr, "Loader gs file\n");
+	fprintf(stderr, "[--headless] replay with the SW or Null renderer without a display, and print timings\n");
+	fprintf(stderr, "[--benchmark] measure the local memory transfer speed of each format instead, no .gs file needed\n");
 	fprintf(stderr, "ARG1 GSdx plugin\n");
 	fprintf(stderr, "ARG2 .gs file\n");
 	fprintf(stderr, "ARG3 Ini directory\n");
@@ -50,9 +52,21 @@ int main ( int argc, char *argv[] )
 {
 	if (argc < 1) help();
 
+	bool headless = argc > 1 && std::string(argv[1]) == "--headless";
+	bool benchmark = argc > 1 && std::string(argv[1]) == "--benchmark";
+
+	if (headless || benchmark) {
+		argv++;
+		argc--;
+	}
+
 	char* plugin;
 	char* gs;
-	if (argc > 2) {
+	if (benchmark) {
+		// ARG1 GSdx plugin, ARG2 Ini directory
+		plugin = argc > 1 ? argv[1] : read_env("GSDUMP_SO");
+		gs = NULL;
+	} else if (argc > 2) {
 		plugin = argv[1];
 		gs = argv[2];
 	} else {
@@ -70,7 +84,20 @@ int main ( int argc, char *argv[] )
 	__attribute__((stdcall)) void (*GSReplay_ptr)(char*, int);
 
 	GSsetSettingsDir_ptr = reinterpret_cast<decltype(GSsetSettingsDir_ptr)>(dlsym(handle, "GSsetSettingsDir"));
-	GSReplay_ptr = reinterpret_cast<decltype(GSReplay_ptr)>(dlsym(handle, "GSReplay"));
+	GSReplay_ptr = reinterpret_cast<decltype(GSReplay_ptr)>(dlsym(handle, benchmark ? "GSBenchmark" : headless ? "GSReplayHeadless" : "GSReplay"));
+
+	if (GSReplay_ptr == NULL) {
+		fprintf(stderr, "Failed to find the replay function of plugin %s\n", plugin);
+		help();
+	}
+
+	if (benchmark) {
+		GSsetSettingsDir_ptr(argc > 2 ? argv[2] : read_env("GSDUMP_CONF"));
+		GSReplay_ptr(gs, 0);
+
+		dlclose(handle);
+		return 0;
+	}
 
 	if (argc == 2) {
 		char *ini = read_env("GSDUMP_CONF");
@@ -64,6 +64,7 @@ extern wxString RegDumpFileName;
 extern int Interpolation;
 extern int numSpeakers;
 extern bool EffectsDisabled;
+extern bool MixingThread;
 extern float FinalVolume; // Global / pre-scale
 extern bool AdvancedVolumeControl;
 extern float VolumeAdjustFLdb;
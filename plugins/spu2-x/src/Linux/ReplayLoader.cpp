@@ -0,0 +1,86 @@
+/* SPU2-X, A plugin for Emulating the Sound Processing Unit of the Playstation 2
+ * Developed and maintained by the Pcsx2 Development Team.
+ *
+ * SPU2-X is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Found-
+ * ation, either version 3 of the License, or (at your option) any later version.
+ *
+ * SPU2-X is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SPU2-X.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Command line front end of the headless .s2r replay (see s2r_replay_headless), to benchmark
+// and regression test the mixer without a sound device.
+
+#include <dlfcn.h>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static void *handle;
+
+static void help()
+{
+    fprintf(stderr, "Loader [--reverb-check] s2r file\n");
+    fprintf(stderr, "--reverb-check  compare the reverb with the scalar reverb on every sample\n");
+    fprintf(stderr, "ARG1 SPU2-X plugin\n");
+    fprintf(stderr, "ARG2 .s2r file\n");
+    fprintf(stderr, "ARG3 Ini directory (default: $HOME/.config/pcsx2/inis)\n");
+    fprintf(stderr, "[ARG4] .wav file to write the output to\n");
+    if (handle)
+        dlclose(handle);
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    int reverb_check = 0;
+    if (argc > 1 && strcmp(argv[1], "--reverb-check") == 0) {
+        reverb_check = 1;
+        argc--;
+        argv++;
+    }
+
+    if (argc < 3)
+        help();
+
+    handle = dlopen(argv[1], RTLD_LAZY | RTLD_GLOBAL);
+    if (handle == NULL) {
+        fprintf(stderr, "Failed to dlopen plugin %s: %s\n", argv[1], dlerror());
+        help();
+    }
+
+    __attribute__((stdcall)) void (*SPU2setSettingsDir_ptr)(const char *);
+    __attribute__((stdcall)) int (*s2r_replay_headless_ptr)(const char *, const char *, int);
+
+    SPU2setSettingsDir_ptr = reinterpret_cast<decltype(SPU2setSettingsDir_ptr)>(dlsym(handle, "SPU2setSettingsDir"));
+    s2r_replay_headless_ptr = reinterpret_cast<decltype(s2r_replay_headless_ptr)>(dlsym(handle, "s2r_replay_headless"));
+
+    if (SPU2setSettingsDir_ptr == NULL || s2r_replay_headless_ptr == NULL) {
+        fprintf(stderr, "Failed to find the replay function of plugin %s\n", argv[1]);
+        help();
+    }
+
+    std::string ini_dir;
+    if (argc > 3) {
+        ini_dir = argv[3];
+    } else {
+        const char *home = getenv("HOME");
+        if (!home) {
+            fprintf(stderr, "Failed to get HOME\n");
+            help();
+        }
+        ini_dir = std::string(home) + "/.config/pcsx2/inis";
+    }
+
+    SPU2setSettingsDir_ptr(ini_dir.c_str());
+    int ret = s2r_replay_headless_ptr(argv[2], argc > 4 ? argv[4] : NULL, reverb_check);
+
+    dlclose(handle);
+    return ret == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+/* SPU2-X, A plugin for Emulating the Sound Processing Unit of the Playstation 2
+ * Developed and maintained by the Pcsx2 Development Team.
+ *
+ * SPU2-X is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Found-
+ * ation, either version 3 of the License, or (at your option) any later version.
+ *
+ * SPU2-X is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SPU2-X.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Global.h"
+#include "PS2E-spu2.h"
+#include "MixThread.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern bool has_to_call_irq;
+
+// Ticks logged before waking up the thread (about 1.3ms of audio)
+static const uint BlockTicks = 64;
+
+// Ticks the thread may lag behind before the emulation waits for it (about 100ms)
+static const uint MaxPendingTicks = 4800;
+
+struct MixCommand
+{
+    u32 cycle; // Cycles when logged
+    u32 rmem;  // register, or 0 for a tick
+    u16 value;
+};
+
+static std::thread s_thread;
+static std::mutex s_lock;
+static std::condition_variable s_wake; // to the thread: commands queued, or exit
+static std::condition_variable s_done; // to the emulation: commands mixed
+
+// Shared, under s_lock
+static std::vector<MixCommand> s_queue;
+static uint s_queueTicks;
+static bool s_busy;
+static bool s_exit;
+
+// Emulation thread only
+static std::vector<MixCommand> s_block;
+static uint s_blockTicks;
+static u32 s_cycle;   // Cycles once everything logged so far is mixed
+static bool s_pending; // commands logged since the last Drain()
+
+// True if the next ticks can't raise an IRQ or call back the emulation.  The state checked
+// here is only ever changed by the emulation thread, through sync writes and DMAs.
+static bool IsQuiet()
+{
+    if (has_to_call_irq || PlayMode != 0)
+        return false;
+
+    for (int i = 0; i < 2; i++) {
+        const V_Core &core(Cores[i]);
+        if (core.IRQEnable || (core.AutoDMACtrl & (i + 1)) || core.AdmaInProgress || core.InputDataLeft >= 0x200)
+            return false;
+    }
+    return true;
+}
+
+// Writes which change what IsQuiet() checks, or which the mixer doesn't own
+static bool IsSyncWrite(u32 rmem)
+{
+    // PS1 registers
+    if (rmem >> 16 == 0x1f80)
+        return true;
+
+    const u32 mem = rmem & 0x7ff;
+
+    // SPDIF and the other shared registers
+    if (mem >= 0x7c0)
+        return true;
+
+    // IRQ enable and DMA mode, AutoDMA
+    const u32 omem = mem & 0x3ff;
+    return omem == REG_C_ATTR || omem == REG_S_ADMAS;
+}
+
+static void Run()
+{
+    std::vector<MixCommand> block;
+    std::unique_lock<std::mutex> lock(s_lock);
+
+    while (true) {
+        s_wake.wait(lock, [] { return s_exit || !s_queue.empty(); });
+        if (s_queue.empty())
+            break;
+
+        block.swap(s_queue);
+        s_queueTicks = 0;
+        s_busy = true;
+        lock.unlock();
+
+        for (const MixCommand &cmd : block) {
+            if (cmd.rmem) {
+                pxAssert(cmd.cycle == Cycles);
+                SPU2writeLog("write", cmd.rmem, cmd.value);
+                SPU2_FastWrite(cmd.rmem, cmd.value);
+            } else {
+                MixTick();
+            }
+        }
+        block.clear();
+
+        lock.lock();
+        s_busy = false;
+        s_done.notify_all();
+    }
+}
+
+// Hands the logged commands over to the thread
+static void Flush()
+{
+    if (s_block.empty())
+        return;
+
+    {
+        std::unique_lock<std::mutex> lock(s_lock);
+        s_done.wait(lock, [] { return s_queueTicks < MaxPendingTicks; });
+
+        s_queue.insert(s_queue.end(), s_block.begin(), s_block.end());
+        s_queueTicks += s_blockTicks;
+    }
+    s_wake.notify_one();
+
+    s_block.clear();
+    s_blockTicks = 0;
+}
+
+static void Log(u32 rmem, u16 value)
+{
+    MixCommand cmd = {s_cycle, rmem, value};
+    s_block.push_back(cmd);
+    s_pending = true;
+
+    if (!rmem) {
+        s_cycle++;
+        if (++s_blockTicks >= BlockTicks)
+            Flush();
+    }
+}
+
+void MixThread::Open()
+{
+    if (s_thread.joinable())
+        return;
+
+    s_exit = false;
+    s_busy = false;
+    s_pending = false;
+    s_queueTicks = s_blockTicks = 0;
+    s_block.reserve(BlockTicks * 2);
+    s_thread = std::thread(Run);
+
+    ConLog("* SPU2-X: Mixing on a separate thread.\n");
+}
+
+void MixThread::Close()
+{
+    if (!s_thread.joinable())
+        return;
+
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(s_lock);
+        s_exit = true;
+    }
+    s_wake.notify_one();
+    s_thread.join();
+
+    s_pending = false;
+}
+
+bool MixThread::Tick()
+{
+    if (!s_thread.joinable())
+        return false;
+
+    if (!IsQuiet()) {
+        Drain();
+        return false;
+    }
+
+    if (!s_pending)
+        s_cycle = Cycles;
+    Log(0, 0);
+    return true;
+}
+
+bool MixThread::Write(u32 rmem, u16 value)
+{
+    if (!s_thread.joinable())
+        return false;
+
+    if (IsSyncWrite(rmem) || !IsQuiet()) {
+        Drain();
+        return false;
+    }
+
+    if (!s_pending)
+        s_cycle = Cycles;
+    Log(rmem, value);
+    return true;
+}
+
+void MixThread::Drain()
+{
+    if (!s_pending)
+        return;
+
+    Flush();
+    {
+        std::unique_lock<std::mutex> lock(s_lock);
+        s_done.wait(lock, [] { return s_queue.empty() && !s_busy; });
+    }
+    s_pending = false;
+}
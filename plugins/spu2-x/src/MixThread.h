@@ -0,0 +1,42 @@
+/* SPU2-X, A plugin for Emulating the Sound Processing Unit of the Playstation 2
+ * Developed and maintained by the Pcsx2 Development Team.
+ *
+ * SPU2-X is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Found-
+ * ation, either version 3 of the License, or (at your option) any later version.
+ *
+ * SPU2-X is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SPU2-X.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// --------------------------------------------------------------------------------------
+//  MixThread
+// --------------------------------------------------------------------------------------
+// Optional mixing thread (MixingThread option).  While neither core can raise an IRQ or
+// run an AutoDMA, the ticks of TimeUpdate and the register writes in between are logged
+// in order, and mixed in blocks on the thread.  Anything that can raise an IRQ, and any
+// read of the SPU2 state from the emulator, drains the log first and runs inline, so the
+// emulation sees exactly what inline mixing would give.
+//
+// All of these are called from the emulation thread only.
+namespace MixThread
+{
+extern void Open();
+extern void Close();
+
+// Queues a tick and returns true, or waits for the thread to catch up and returns false,
+// in which case the caller mixes the tick itself.
+extern bool Tick();
+
+// Same for a register write, which the caller applies itself when false is returned.
+extern bool Write(u32 rmem, u16 value);
+
+// Waits until the thread has mixed everything queued so far.
+extern void Drain();
+}
@@ -16,6 +16,17 @@
  */
 
 #include "Global.h"
+#include "Spu2replay.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SPU2_MIX_LANES 8 // voices mixed at once by MixVoiceLanes
+#elif defined(__SSE4_1__) || defined(__AVX__)
+#include <smmintrin.h>
+#define SPU2_MIX_LANES 4
+#else
+#define SPU2_MIX_LANES 1
+#endif
 
 // Games have turned out to be surprisingly sensitive to whether a parked, silent voice is being fully emulated.
 // With Silent Hill: Shattered Memories requiring full processing for no obvious reason, we've decided to
@@ -132,10 +143,32 @@ static void __forceinline IncrementNextA(V_Core &thiscore, uint voiceidx)
 // multiple times.  Cache chunks are decoded when the mixer requests the blocks, and
 // invalided when DMA transfers and memory writes are performed.
 PcmCacheEntry *pcm_cache_data = NULL;
+u32 *pcm_BlockGen = NULL;
+
+// Totals since the plugin was loaded.  Ignores are misses on a block that was cached, but written since.
+u64 g_counter_cache_hits = 0;
+u64 g_counter_cache_misses = 0;
+u64 g_counter_cache_ignores = 0;
+
+void pcm_InvalidateRange(u32 addr, u32 end)
+{
+    const u32 blockEnd = (end + pcm_WordsPerBlock - 1) / pcm_WordsPerBlock;
+    for (u32 block = addr / pcm_WordsPerBlock; block < blockEnd; block++)
+        pcm_BlockGen[block]++;
+}
+
+void pcm_ResetCache()
+{
+    for (int i = 0; i < pcm_CacheEntries; i++)
+        pcm_cache_data[i].Block = pcm_BlockCount;
+}
 
-int g_counter_cache_hits = 0;
-int g_counter_cache_misses = 0;
-int g_counter_cache_ignores = 0;
+// Blocks played together are usually close in ram, the hash spreads them over the cache.
+static_assert(pcm_CacheEntries == 1 << 13, "The cache hash gives 13 bits");
+static __forceinline PcmCacheEntry &GetCacheEntry(u32 block)
+{
+    return pcm_cache_data[(block * 0x9E3779B1u) >> (32 - 13)];
+}
 
 // LOOP/END sets the ENDX bit and sets NAX to LSA, and the voice is muted if LOOP is not set
 // LOOP seems to only have any effect on the block with LOOP/END set, where it prevents muting the voice
@@ -186,34 +219,28 @@ static __forceinline s32 GetNextDataBuffered(V_Core &thiscore, uint voiceidx)
         if ((vc.LoopFlags & XAFLAG_LOOP_START) && !vc.LoopMode)
             vc.LoopStartA = vc.NextA & 0xFFFF8;
 
-        const int cacheIdx = vc.NextA / pcm_WordsPerBlock;
-        PcmCacheEntry &cacheLine = pcm_cache_data[cacheIdx];
-        vc.SBuffer = cacheLine.Sampledata;
+        const u32 block = vc.NextA / pcm_WordsPerBlock;
+        PcmCacheEntry &cacheLine = GetCacheEntry(block);
 
-        if (cacheLine.Validated) {
-            // Cached block!  Read from the cache directly.
-            // Make sure to propagate the prev1/prev2 ADPCM:
+        if (cacheLine.Block == block && cacheLine.Gen == pcm_BlockGen[block]) {
+            // Cached block!  Make sure to propagate the prev1/prev2 ADPCM:
+            memcpy(vc.SBuffer, cacheLine.Sampledata, sizeof(vc.SBuffer));
 
             vc.Prev1 = vc.SBuffer[27];
             vc.Prev2 = vc.SBuffer[26];
 
-            //ConLog( "* SPU2-X: Cache Hit! NextA=0x%x, cacheIdx=0x%x\n", vc.NextA, cacheIdx );
-
-            if (IsDevBuild)
-                g_counter_cache_hits++;
+            g_counter_cache_hits++;
         } else {
-            // Only flag the cache if it's a non-dynamic memory range.
-            if (vc.NextA >= SPU2_DYN_MEMLINE)
-                cacheLine.Validated = true;
-
-            if (IsDevBuild) {
-                if (vc.NextA < SPU2_DYN_MEMLINE)
-                    g_counter_cache_ignores++;
-                else
-                    g_counter_cache_misses++;
-            }
+            if (cacheLine.Block == block)
+                g_counter_cache_ignores++;
+            else
+                g_counter_cache_misses++;
 
             XA_decode_block(vc.SBuffer, memptr, vc.Prev1, vc.Prev2);
+
+            cacheLine.Block = block;
+            cacheLine.Gen = pcm_BlockGen[block];
+            memcpy(cacheLine.Sampledata, vc.SBuffer, sizeof(vc.SBuffer));
         }
     }
 
@@ -400,11 +427,11 @@ __forceinline static s32 CubicInterpolate(
     return (val + (y1 << 1));
 }
 
-// Returns a 16 bit result in Value.
+// Reads the samples up to the current pitch position into PV1..PV4.
 // Uses standard template-style optimization techniques to statically generate five different
 // versions of this function (one for each type of interpolation).
 template <int InterpType>
-static __forceinline s32 GetVoiceValues(V_Core &thiscore, uint voiceidx)
+static __forceinline void GetVoiceValues(V_Core &thiscore, uint voiceidx)
 {
     V_Voice &vc(thiscore.Voices[voiceidx]);
 
@@ -417,26 +444,6 @@ static __forceinline s32 GetVoiceValues(V_Core &thiscore, uint voiceidx)
         vc.PV1 = GetNextDataBuffered(thiscore, voiceidx);
         vc.SP -= 4096;
     }
-
-    const s32 mu = vc.SP + 4096;
-
-    switch (InterpType) {
-        case 0:
-            return vc.PV1 << 1;
-        case 1:
-            return (vc.PV1 << 1) - (((vc.PV2 - vc.PV1) * vc.SP) >> 11);
-
-        case 2:
-            return CubicInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-        case 3:
-            return HermiteInterpolate<16384>(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-        case 4:
-            return CatmullRomInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-
-            jNO_DEFAULT;
-    }
-
-    return 0; // technically unreachable!
 }
 
 // Noise values need to be mixed without going through interpolation, since it
@@ -466,7 +473,7 @@ static __forceinline s32 GetNoiseValues(V_Core &thiscore, uint voiceidx)
 //                                                                                     //
 
 // writes a signed value to the SPU2 ram
-// Performs no cache invalidation -- use only for dynamic memory ranges
+// Skips the address masking of spu2M_Write -- use only for dynamic memory ranges
 // of the SPU2 (between 0x0000 and SPU2_DYN_MEMLINE)
 static __forceinline void spu2M_WriteFast(u32 addr, s16 value)
 {
@@ -481,11 +488,43 @@ static __forceinline void spu2M_WriteFast(u32 addr, s16 value)
 #ifndef DEBUG_FAST
     pxAssume(addr < SPU2_DYN_MEMLINE);
 #endif
+    pcm_InvalidateBlock(addr);
     *GetMemPtr(addr) = value;
 }
 
 
-static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
+// --------------------------------------------------------------------------------------
+//  Voice Mixing
+// --------------------------------------------------------------------------------------
+// Voices are mixed in two passes.  StepVoice advances each voice in order: volume slides,
+// pitch (modulation needs the previous voice's OutX), ADPCM decoding with its loop and IRQ
+// side effects, noise and ADSR all branch per voice and stay scalar.  It leaves the
+// voice's samples, envelope, volumes and gates in VoiceLanes, from which MixVoiceLanes
+// interpolates, applies the envelope and volumes and sums the gated outputs of all the
+// voices of the core at once, SPU2_MIX_LANES at a time.
+
+struct __aligned32 VoiceLanes
+{
+    s32 PV4[V_Core::NumVoices];
+    s32 PV3[V_Core::NumVoices];
+    s32 PV2[V_Core::NumVoices];
+    s32 PV1[V_Core::NumVoices];
+    s32 Mu[V_Core::NumVoices];        // interpolation position (SP + 4096), 0.12
+    s32 Noise[V_Core::NumVoices];     // noise sample, used instead of PVx where NoiseMask is set
+    s32 NoiseMask[V_Core::NumVoices];
+    s32 Envelope[V_Core::NumVoices];  // ADSR value, 0 for voices that aren't playing
+    s32 VolL[V_Core::NumVoices];
+    s32 VolR[V_Core::NumVoices];
+    s32 DryL[V_Core::NumVoices];      // voice gates, 0 or -1
+    s32 DryR[V_Core::NumVoices];
+    s32 WetL[V_Core::NumVoices];
+    s32 WetR[V_Core::NumVoices];
+};
+
+static VoiceLanes s_VoiceLanes;
+
+template <int InterpType>
+static __forceinline void StepVoice(VoiceLanes &lanes, uint coreidx, uint voiceidx)
 {
     V_Core &thiscore(Cores[coreidx]);
     V_Voice &vc(thiscore.Voices[voiceidx]);
@@ -500,6 +539,13 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 
     vc.Volume.Update();
 
+    lanes.VolL[voiceidx] = vc.Volume.Left.Value;
+    lanes.VolR[voiceidx] = vc.Volume.Right.Value;
+    lanes.DryL[voiceidx] = thiscore.VoiceGates[voiceidx].DryL;
+    lanes.DryR[voiceidx] = thiscore.VoiceGates[voiceidx].DryR;
+    lanes.WetL[voiceidx] = thiscore.VoiceGates[voiceidx].WetL;
+    lanes.WetR[voiceidx] = thiscore.VoiceGates[voiceidx].WetR;
+
     // SPU2 Note: The spu2 continues to process voices for eternity, always, so we
     // have to run through all the motions of updating the voice regardless of it's
     // audible status.  Otherwise IRQs might not trigger and emulation might fail.
@@ -507,44 +553,29 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
     if (vc.ADSR.Phase > 0) {
         UpdatePitch(coreidx, voiceidx);
 
-        s32 Value = 0;
-
-        if (vc.Noise)
-            Value = GetNoiseValues(thiscore, voiceidx);
-        else {
-            // Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
-            // turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
-
-            switch (Interpolation) {
-                case 0:
-                    Value = GetVoiceValues<0>(thiscore, voiceidx);
-                    break;
-                case 1:
-                    Value = GetVoiceValues<1>(thiscore, voiceidx);
-                    break;
-                case 2:
-                    Value = GetVoiceValues<2>(thiscore, voiceidx);
-                    break;
-                case 3:
-                    Value = GetVoiceValues<3>(thiscore, voiceidx);
-                    break;
-                case 4:
-                    Value = GetVoiceValues<4>(thiscore, voiceidx);
-                    break;
-
-                    jNO_DEFAULT;
-            }
+        if (vc.Noise) {
+            lanes.Noise[voiceidx] = GetNoiseValues(thiscore, voiceidx);
+            lanes.NoiseMask[voiceidx] = -1;
+        } else {
+            GetVoiceValues<InterpType>(thiscore, voiceidx);
+            lanes.NoiseMask[voiceidx] = 0;
         }
 
-        // Update and Apply ADSR  (applies to normal and noise sources)
+        lanes.PV4[voiceidx] = vc.PV4;
+        lanes.PV3[voiceidx] = vc.PV3;
+        lanes.PV2[voiceidx] = vc.PV2;
+        lanes.PV1[voiceidx] = vc.PV1;
+        lanes.Mu[voiceidx] = vc.SP + 4096;
+
+        // Update ADSR  (applies to normal and noise sources)
         //
         // Note!  It's very important that ADSR stay as accurate as possible.  By the way
         // it is used, various sound effects can end prematurely if we truncate more than
-        // one or two bits.  Best result comes from no truncation at all, which is why we
-        // use a full 64-bit multiply/result here.
+        // one or two bits.  Best result comes from no truncation at all, which is why
+        // MixVoiceLanes uses a full 64-bit multiply/result.
 
         CalculateADSR(thiscore, voiceidx);
-        Value = MulShr32(Value, vc.ADSR.Value);
+        lanes.Envelope[voiceidx] = vc.ADSR.Value;
 
         // Store Value for eventual modulation later
         // Pseudonym's Crest calculation idea. Actually calculates a crest, unlike the old code which was just peak.
@@ -565,8 +596,6 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
             spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, vc.OutX);
         else if (voiceidx == 3)
             spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, vc.OutX);
-
-        return ApplyVolume(StereoOut32(Value, Value), vc.Volume);
     } else {
         // Continue processing voice, even if it's "off". Or else we miss interrupts! (Fatal Frame engine died because of this.)
         if (NEVER_SKIP_VOICES || (*GetMemPtr(vc.NextA & 0xFFFF8) >> 8 & 3) != 3 || vc.LoopStartA != (vc.NextA & ~7)    // not in a tight loop
@@ -579,31 +608,237 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
                 GetNextDataDummy(thiscore, voiceidx); // Dummy is enough
         }
 
+        // Silent: whatever the lanes interpolate to, it's multiplied by 0
+        lanes.Envelope[voiceidx] = 0;
+
         // Write-back of raw voice data (some zeros since the voice is "dead")
         if (voiceidx == 1)
             spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, 0);
         else if (voiceidx == 3)
             spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, 0);
+    }
+}
+
+#if SPU2_MIX_LANES > 1
+
+#if SPU2_MIX_LANES == 8
+typedef __m256i VoiceVec;
+
+static __forceinline VoiceVec vload(const s32 *p) { return _mm256_load_si256((const __m256i *)p); }
+static __forceinline VoiceVec vset1(s32 x) { return _mm256_set1_epi32(x); }
+static __forceinline VoiceVec vadd(VoiceVec a, VoiceVec b) { return _mm256_add_epi32(a, b); }
+static __forceinline VoiceVec vsub(VoiceVec a, VoiceVec b) { return _mm256_sub_epi32(a, b); }
+static __forceinline VoiceVec vmul(VoiceVec a, VoiceVec b) { return _mm256_mullo_epi32(a, b); }
+static __forceinline VoiceVec vand(VoiceVec a, VoiceVec b) { return _mm256_and_si256(a, b); }
+static __forceinline VoiceVec vsel(VoiceVec a, VoiceVec b, VoiceVec mask) { return _mm256_blendv_epi8(a, b, mask); }
+template <int n> static __forceinline VoiceVec vsra(VoiceVec a) { return _mm256_srai_epi32(a, n); }
+template <int n> static __forceinline VoiceVec vsll(VoiceVec a) { return _mm256_slli_epi32(a, n); }
+
+// MulShr32 for each lane: the high halves of the 64-bit products
+static __forceinline VoiceVec vmulshr32(VoiceVec a, VoiceVec b)
+{
+    VoiceVec even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), 32);
+    VoiceVec odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    return _mm256_blend_epi32(even, odd, 0xaa);
+}
+
+static __forceinline s32 vsum(VoiceVec a)
+{
+    __m128i x = _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+    x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(x);
+}
+#else
+typedef __m128i VoiceVec;
+
+static __forceinline VoiceVec vload(const s32 *p) { return _mm_load_si128((const __m128i *)p); }
+static __forceinline VoiceVec vset1(s32 x) { return _mm_set1_epi32(x); }
+static __forceinline VoiceVec vadd(VoiceVec a, VoiceVec b) { return _mm_add_epi32(a, b); }
+static __forceinline VoiceVec vsub(VoiceVec a, VoiceVec b) { return _mm_sub_epi32(a, b); }
+static __forceinline VoiceVec vmul(VoiceVec a, VoiceVec b) { return _mm_mullo_epi32(a, b); }
+static __forceinline VoiceVec vand(VoiceVec a, VoiceVec b) { return _mm_and_si128(a, b); }
+static __forceinline VoiceVec vsel(VoiceVec a, VoiceVec b, VoiceVec mask) { return _mm_blendv_epi8(a, b, mask); }
+template <int n> static __forceinline VoiceVec vsra(VoiceVec a) { return _mm_srai_epi32(a, n); }
+template <int n> static __forceinline VoiceVec vsll(VoiceVec a) { return _mm_slli_epi32(a, n); }
+
+// MulShr32 for each lane: the high halves of the 64-bit products
+static __forceinline VoiceVec vmulshr32(VoiceVec a, VoiceVec b)
+{
+    VoiceVec even = _mm_srli_epi64(_mm_mul_epi32(a, b), 32);
+    VoiceVec odd = _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_blend_epi16(even, odd, 0xcc);
+}
+
+static __forceinline s32 vsum(VoiceVec a)
+{
+    a = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)));
+    a = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(a);
+}
+#endif
+
+// Same arithmetic as the scalar interpolators above, lane by lane
+template <int InterpType>
+static __forceinline VoiceVec InterpolateLanes(const VoiceLanes &lanes, uint i)
+{
+    const VoiceVec y3 = vload(&lanes.PV1[i]);
+    const VoiceVec y2 = vload(&lanes.PV2[i]);
+    const VoiceVec mu = vload(&lanes.Mu[i]);
+
+    if (InterpType == 0)
+        return vsll<1>(y3);
+    if (InterpType == 1)
+        return vsub(vsll<1>(y3), vsra<11>(vmul(vsub(y2, y3), vsub(mu, vset1(4096)))));
+
+    const VoiceVec y1 = vload(&lanes.PV3[i]);
+    const VoiceVec y0 = vload(&lanes.PV4[i]);
+    VoiceVec val;
+
+    switch (InterpType) {
+        case 2: { // CubicInterpolate
+            const VoiceVec a0 = vadd(vsub(vsub(y3, y2), y0), y1);
+            const VoiceVec a1 = vsub(vsub(y0, y1), a0);
+            const VoiceVec a2 = vsub(y2, y0);
+
+            val = vsra<12>(vmul(a0, mu));
+            val = vsra<12>(vmul(vadd(val, a1), mu));
+            val = vsra<11>(vmul(vadd(val, a2), mu));
+            return vadd(val, vsll<1>(y1));
+        }
+        case 3: { // HermiteInterpolate<16384>
+            const VoiceVec m00 = vsra<16>(vsll<14>(vsub(y1, y0)));
+            const VoiceVec m01 = vsra<16>(vsll<14>(vsub(y2, y1)));
+            const VoiceVec m11 = vsra<16>(vsll<14>(vsub(y3, y2)));
+            const VoiceVec m0 = vadd(m00, m01);
+            const VoiceVec m1 = vadd(m01, m11);
+
+            val = vsra<12>(vmul(vsub(vadd(vadd(vsll<1>(y1), m0), m1), vsll<1>(y2)), mu));
+            val = vsub(vsub(vsub(val, vmul(y1, vset1(3))), vsll<1>(m0)), m1);
+            val = vsra<12>(vmul(vadd(val, vmul(y2, vset1(3))), mu));
+            val = vsra<11>(vmul(vadd(val, m0), mu));
+            return vadd(val, vsll<1>(y1));
+        }
+        case 4: { // CatmullRomInterpolate
+            const VoiceVec a3 = vadd(vsub(vmul(vsub(y1, y2), vset1(3)), y0), y3);
+            const VoiceVec a2 = vsub(vadd(vsub(vsll<1>(y0), vmul(y1, vset1(5))), vsll<2>(y2)), y3);
+            const VoiceVec a1 = vsub(y2, y0);
+
+            val = vsra<12>(vmul(a3, mu));
+            val = vsra<12>(vmul(vadd(a2, val), mu));
+            val = vsra<12>(vmul(vadd(a1, val), mu));
+            return vadd(vsll<1>(y1), val);
+        }
+
+            jNO_DEFAULT;
+    }
+
+    return y3; // technically unreachable!
+}
+
+template <int InterpType>
+static __forceinline void MixVoiceLanes(VoiceMixSet &dest, const VoiceLanes &lanes)
+{
+    VoiceVec dryL = vset1(0), dryR = vset1(0), wetL = vset1(0), wetR = vset1(0);
+
+    for (uint i = 0; i < V_Core::NumVoices; i += SPU2_MIX_LANES) {
+        VoiceVec value = vsel(InterpolateLanes<InterpType>(lanes, i), vload(&lanes.Noise[i]), vload(&lanes.NoiseMask[i]));
+        value = vsll<1>(vmulshr32(value, vload(&lanes.Envelope[i])));
+
+        // Note: Results are ranged at 16 bits.
+        const VoiceVec left = vmulshr32(value, vload(&lanes.VolL[i]));
+        const VoiceVec right = vmulshr32(value, vload(&lanes.VolR[i]));
+
+        dryL = vadd(dryL, vand(left, vload(&lanes.DryL[i])));
+        dryR = vadd(dryR, vand(right, vload(&lanes.DryR[i])));
+        wetL = vadd(wetL, vand(left, vload(&lanes.WetL[i])));
+        wetR = vadd(wetR, vand(right, vload(&lanes.WetR[i])));
+    }
+
+    dest.Dry.Left += vsum(dryL);
+    dest.Dry.Right += vsum(dryR);
+    dest.Wet.Left += vsum(wetL);
+    dest.Wet.Right += vsum(wetR);
+}
+
+#else
+
+template <int InterpType>
+static __forceinline s32 InterpolateLane(const VoiceLanes &lanes, uint i)
+{
+    switch (InterpType) {
+        case 0:
+            return lanes.PV1[i] << 1;
+        case 1:
+            return (lanes.PV1[i] << 1) - (((lanes.PV2[i] - lanes.PV1[i]) * (lanes.Mu[i] - 4096)) >> 11);
+
+        case 2:
+            return CubicInterpolate(lanes.PV4[i], lanes.PV3[i], lanes.PV2[i], lanes.PV1[i], lanes.Mu[i]);
+        case 3:
+            return HermiteInterpolate<16384>(lanes.PV4[i], lanes.PV3[i], lanes.PV2[i], lanes.PV1[i], lanes.Mu[i]);
+        case 4:
+            return CatmullRomInterpolate(lanes.PV4[i], lanes.PV3[i], lanes.PV2[i], lanes.PV1[i], lanes.Mu[i]);
+
+            jNO_DEFAULT;
+    }
+
+    return 0; // technically unreachable!
+}
 
-        return StereoOut32(0, 0);
+template <int InterpType>
+static __forceinline void MixVoiceLanes(VoiceMixSet &dest, const VoiceLanes &lanes)
+{
+    for (uint i = 0; i < V_Core::NumVoices; ++i) {
+        s32 Value = lanes.NoiseMask[i] ? lanes.Noise[i] : InterpolateLane<InterpType>(lanes, i);
+        Value = MulShr32(Value, lanes.Envelope[i]);
+
+        // Note: Results are ranged at 16 bits.
+        const s32 left = ApplyVolume(Value, lanes.VolL[i]);
+        const s32 right = ApplyVolume(Value, lanes.VolR[i]);
+
+        dest.Dry.Left += left & lanes.DryL[i];
+        dest.Dry.Right += right & lanes.DryR[i];
+        dest.Wet.Left += left & lanes.WetL[i];
+        dest.Wet.Right += right & lanes.WetR[i];
     }
 }
 
+#endif
+
 const VoiceMixSet VoiceMixSet::Empty((StereoOut32()), (StereoOut32())); // Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
 
+template <int InterpType>
 static __forceinline void MixCoreVoices(VoiceMixSet &dest, const uint coreidx)
 {
-    V_Core &thiscore(Cores[coreidx]);
+    for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+        StepVoice<InterpType>(s_VoiceLanes, coreidx, voiceidx);
 
-    for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx) {
-        StereoOut32 VVal(MixVoice(coreidx, voiceidx));
+    MixVoiceLanes<InterpType>(dest, s_VoiceLanes);
+}
+
+static __forceinline void MixCoreVoices(VoiceMixSet &dest, const uint coreidx)
+{
+    // Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
+    // turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
 
-        // Note: Results from MixVoice are ranged at 16 bits.
+    switch (Interpolation) {
+        case 0:
+            MixCoreVoices<0>(dest, coreidx);
+            break;
+        case 1:
+            MixCoreVoices<1>(dest, coreidx);
+            break;
+        case 2:
+            MixCoreVoices<2>(dest, coreidx);
+            break;
+        case 3:
+            MixCoreVoices<3>(dest, coreidx);
+            break;
+        case 4:
+            MixCoreVoices<4>(dest, coreidx);
+            break;
 
-        dest.Dry.Left += VVal.Left & thiscore.VoiceGates[voiceidx].DryL;
-        dest.Dry.Right += VVal.Right & thiscore.VoiceGates[voiceidx].DryR;
-        dest.Wet.Left += VVal.Left & thiscore.VoiceGates[voiceidx].WetL;
-        dest.Wet.Right += VVal.Right & thiscore.VoiceGates[voiceidx].WetR;
+            jNO_DEFAULT;
     }
 }
 
@@ -684,7 +919,7 @@ StereoOut32 V_Core::Mix(const VoiceMixSet &inVoices, const StereoOut32 &Input, c
 
     WaveDump::WriteCore(Index, CoreSrc_PreReverb, TW);
 
-    StereoOut32 RV = DoReverb(TW);
+    StereoOut32 RV = s2r_reverbcheck ? DoReverbChecked(TW) : DoReverb(TW);
 
     WaveDump::WriteCore(Index, CoreSrc_PostReverb, RV);
 
@@ -773,6 +1008,9 @@ StereoOut32 Apply_Dealias_Filter(StereoOut32 &SoundStream)
 
 // used to throttle the output rate of cache stat reports
 static int p_cachestat_counter = 0;
+static u64 p_cachestat_hits = 0;
+static u64 p_cachestat_misses = 0;
+static u64 p_cachestat_ignores = 0;
 
 // Gcc does not want to inline it when lto is enabled because some functions growth too much.
 // The function is big enought to see any speed impact. -- Gregory
@@ -862,19 +1100,17 @@ __forceinline
     if (OutPos >= 0x200)
         OutPos = 0;
 
-    if (IsDevBuild) {
-        p_cachestat_counter++;
-        if (p_cachestat_counter > (48000 * 10)) {
-            p_cachestat_counter = 0;
-            if (MsgCache())
-                ConLog(" * SPU2 > CacheStats > Hits: %d  Misses: %d  Ignores: %d\n",
-                       g_counter_cache_hits,
-                       g_counter_cache_misses,
-                       g_counter_cache_ignores);
-
-            g_counter_cache_hits =
-                g_counter_cache_misses =
-                    g_counter_cache_ignores = 0;
-        }
+    p_cachestat_counter++;
+    if (p_cachestat_counter > (48000 * 10)) {
+        p_cachestat_counter = 0;
+        if (MsgCache())
+            ConLog(" * SPU2 > CacheStats > Hits: %llu  Misses: %llu  Ignores: %llu\n",
+                   (unsigned long long)(g_counter_cache_hits - p_cachestat_hits),
+                   (unsigned long long)(g_counter_cache_misses - p_cachestat_misses),
+                   (unsigned long long)(g_counter_cache_ignores - p_cachestat_ignores));
+
+        p_cachestat_hits = g_counter_cache_hits;
+        p_cachestat_misses = g_counter_cache_misses;
+        p_cachestat_ignores = g_counter_cache_ignores;
     }
 }
@@ -19,6 +19,7 @@
 #include "PS2E-spu2.h"
 #include "Dma.h"
 #include "Dialogs.h"
+#include "MixThread.h"
 
 #ifdef __APPLE__
 #include "PS2Eext.h"
@@ -220,6 +221,7 @@ CALLBACK SPU2readDMA4Mem(u16 *pMem, u32 size) // size now in 16bit units
 {
     if (cyclePtr != NULL)
         TimeUpdate(*cyclePtr);
+    MixThread::Drain();
 
     FileLog("[%10d] SPU2 readDMA4Mem size %x\n", Cycles, size << 1);
     Cores[0].DoDMAread(pMem, size);
@@ -230,6 +232,7 @@ CALLBACK SPU2writeDMA4Mem(u16 *pMem, u32 size) // size now in 16bit units
 {
     if (cyclePtr != NULL)
         TimeUpdate(*cyclePtr);
+    MixThread::Drain();
 
     FileLog("[%10d] SPU2 writeDMA4Mem size %x at address %x\n", Cycles, size << 1, Cores[0].TSA);
 #ifdef S2R_ENABLE
@@ -242,6 +245,8 @@ CALLBACK SPU2writeDMA4Mem(u16 *pMem, u32 size) // size now in 16bit units
 EXPORT_C_(void)
 CALLBACK SPU2interruptDMA4()
 {
+    MixThread::Drain();
+
     FileLog("[%10d] SPU2 interruptDMA4\n", Cycles);
     Cores[0].Regs.STATX |= 0x80;
     //Cores[0].Regs.ATTR &= ~0x30;
@@ -250,6 +255,8 @@ CALLBACK SPU2interruptDMA4()
 EXPORT_C_(void)
 CALLBACK SPU2interruptDMA7()
 {
+    MixThread::Drain();
+
     FileLog("[%10d] SPU2 interruptDMA7\n", Cycles);
     Cores[1].Regs.STATX |= 0x80;
     //Cores[1].Regs.ATTR &= ~0x30;
@@ -260,6 +267,7 @@ CALLBACK SPU2readDMA7Mem(u16 *pMem, u32 size)
 {
     if (cyclePtr != NULL)
         TimeUpdate(*cyclePtr);
+    MixThread::Drain();
 
     FileLog("[%10d] SPU2 readDMA7Mem size %x\n", Cycles, size << 1);
     Cores[1].DoDMAread(pMem, size);
@@ -270,6 +278,7 @@ CALLBACK SPU2writeDMA7Mem(u16 *pMem, u32 size)
 {
     if (cyclePtr != NULL)
         TimeUpdate(*cyclePtr);
+    MixThread::Drain();
 
     FileLog("[%10d] SPU2 writeDMA7Mem size %x at address %x\n", Cycles, size << 1, Cores[1].TSA);
 #ifdef S2R_ENABLE
@@ -282,9 +291,12 @@ CALLBACK SPU2writeDMA7Mem(u16 *pMem, u32 size)
 EXPORT_C_(void)
 SPU2reset()
 {
+    MixThread::Drain();
+
     memset(spu2regs, 0, 0x010000);
     memset(_spu2mem, 0, 0x200000);
     memset(_spu2mem + 0x2800, 7, 0x10); // from BIOS reversal. Locks the voices so they don't run free.
+    pcm_ResetCache();
     Cores[0].Init(0);
     Cores[1].Init(1);
 }
@@ -316,15 +328,13 @@ SPU2init()
     _spu2mem = (s16 *)malloc(0x200000);
 
     // adpcm decoder cache:
-    //  the cache data size is determined by taking the number of adpcm blocks
-    //  (2MB / 16) and multiplying it by the decoded block size (28 samples).
-    //  Thus: pcm_cache_data = 7,340,032 bytes (ouch!)
-    //  Expanded: 16 bytes expands to 56 bytes [3.5:1 ratio]
-    //    Resulting in 2MB * 3.5.
+    //  a hashed cache of pcm_CacheEntries decoded blocks (512KB), validated against the
+    //  write generation of each of the 2MB / 16 blocks of SPU2 ram (another 512KB).
 
-    pcm_cache_data = (PcmCacheEntry *)calloc(pcm_BlockCount, sizeof(PcmCacheEntry));
+    pcm_cache_data = (PcmCacheEntry *)malloc(pcm_CacheEntries * sizeof(PcmCacheEntry));
+    pcm_BlockGen = (u32 *)calloc(pcm_BlockCount, sizeof(u32));
 
-    if ((spu2regs == NULL) || (_spu2mem == NULL) || (pcm_cache_data == NULL)) {
+    if ((spu2regs == NULL) || (_spu2mem == NULL) || (pcm_cache_data == NULL) || (pcm_BlockGen == NULL)) {
         SysMessage("SPU2-X: Error allocating Memory\n");
         return -1;
     }
@@ -428,6 +438,9 @@ SPU2open(void *pDsp)
         DspLoadLibrary(dspPlugin, dspPluginModule);
 #endif
         WaveDump::Open();
+
+        if (MixingThread)
+            MixThread::Open();
     } catch (std::exception &ex) {
         fprintf(stderr, "SPU2-X Error: Could not initialize device, or something.\nReason: %s", ex.what());
         SPU2close();
@@ -449,6 +462,7 @@ SPU2close()
     DspCloseLibrary();
 #endif
 
+    MixThread::Close();
     SndBuffer::Cleanup();
 }
 
@@ -484,6 +498,7 @@ SPU2shutdown()
     safe_free(spu2regs);
     safe_free(_spu2mem);
     safe_free(pcm_cache_data);
+    safe_free(pcm_BlockGen);
 
 
 #ifdef SPU2_LOG
@@ -580,10 +595,12 @@ SPU2read(u32 rmem)
     }
 
     if (omem == 0x1f9001AC) {
+        MixThread::Drain();
         ret = Cores[core].DmaRead();
     } else {
         if (cyclePtr != NULL)
             TimeUpdate(*cyclePtr);
+        MixThread::Drain();
 
         if (rmem >> 16 == 0x1f80) {
             ret = Cores[0].ReadRegPS1(rmem);
@@ -615,6 +632,10 @@ SPU2write(u32 rmem, u16 value)
     if (cyclePtr != NULL)
         TimeUpdate(*cyclePtr);
 
+    // Logged for the mixing thread, unless it has to take effect right away
+    if (MixThread::Write(rmem, value))
+        return;
+
     if (rmem >> 16 == 0x1f80)
         Cores[0].WriteRegPS1(rmem, value);
     else {
@@ -629,6 +650,8 @@ SPU2write(u32 rmem, u16 value)
 EXPORT_C_(int)
 SPU2setupRecording(int start, void *pData)
 {
+    MixThread::Drain();
+
     if (start == 0)
         RecordStop();
     else if (start == 1)
@@ -660,6 +683,8 @@ SPU2freeze(int mode, freezeData *data)
 
     Savestate::DataBlock &spud = (Savestate::DataBlock &)*(data->data);
 
+    MixThread::Drain();
+
     switch (mode) {
         case FREEZE_LOAD:
             return Savestate::ThawIt(spud);
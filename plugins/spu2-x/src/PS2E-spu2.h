@@ -115,6 +115,7 @@ extern u32 *cyclePtr;
 
 extern void SPU2writeLog(const char *action, u32 rmem, u16 value);
 extern void TimeUpdate(u32 cClocks);
+extern void MixTick();
 extern void SPU2_FastWrite(u32 rmem, u16 value);
 
 extern void LowPassFilterInit();
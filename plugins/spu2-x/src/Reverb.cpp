@@ -16,21 +16,32 @@
  */
 
 #include "Global.h"
+#include "Spu2replay.h"
 
-__forceinline s32 V_Core::RevbGetIndexer(s32 offset)
+#include <emmintrin.h>
+
+__forceinline void V_Core::RevbGetIndexers(u32 *addr, bool R)
 {
-    u32 pos = ReverbX + offset;
+    const s32 *taps = RevBuffers.Taps[R];
+
+    const __m128i x = _mm_set1_epi32(ReverbX);
+    const __m128i end = _mm_set1_epi32(EffectsEndA);
+    const __m128i size = _mm_set1_epi32(EffectsEndA + 1 - EffectsStartA);
 
     // Fast and simple single step wrapping, made possible by the preparation of the
-    // effects buffer addresses.
+    // effects buffer addresses.  Everything stays well below 2^31, so the signed compare
+    // works for the addresses.
 
-    if (pos > EffectsEndA) {
-        pos -= EffectsEndA + 1;
-        pos += EffectsStartA;
+    for (int i = 0; i < RevbTap_Padded; i += 4) {
+        __m128i pos = _mm_add_epi32(_mm_loadu_si128((const __m128i *)&taps[i]), x);
+        pos = _mm_sub_epi32(pos, _mm_and_si128(_mm_cmpgt_epi32(pos, end), size));
+        _mm_store_si128((__m128i *)&addr[i], pos);
     }
 
-    assert(pos >= EffectsStartA && pos <= EffectsEndA);
-    return pos;
+#ifndef NDEBUG
+    for (int i = 0; i < RevbTap_Padded; i++)
+        assert(addr[i] >= EffectsStartA && addr[i] <= EffectsEndA);
+#endif
 }
 
 void V_Core::Reverb_AdvanceBuffer()
@@ -57,23 +68,8 @@ StereoOut32 V_Core::DoReverb(const StereoOut32 &Input)
 
     // Calculate the read/write addresses we'll be needing for this session of reverb.
 
-    const u32 same_src = RevbGetIndexer(R ? RevBuffers.SAME_R_SRC : RevBuffers.SAME_L_SRC);
-    const u32 same_dst = RevbGetIndexer(R ? RevBuffers.SAME_R_DST : RevBuffers.SAME_L_DST);
-    const u32 same_prv = RevbGetIndexer(R ? RevBuffers.SAME_R_PRV : RevBuffers.SAME_L_PRV);
-
-    const u32 diff_src = RevbGetIndexer(R ? RevBuffers.DIFF_L_SRC : RevBuffers.DIFF_R_SRC);
-    const u32 diff_dst = RevbGetIndexer(R ? RevBuffers.DIFF_R_DST : RevBuffers.DIFF_L_DST);
-    const u32 diff_prv = RevbGetIndexer(R ? RevBuffers.DIFF_R_PRV : RevBuffers.DIFF_L_PRV);
-
-    const u32 comb1_src = RevbGetIndexer(R ? RevBuffers.COMB1_R_SRC : RevBuffers.COMB1_L_SRC);
-    const u32 comb2_src = RevbGetIndexer(R ? RevBuffers.COMB2_R_SRC : RevBuffers.COMB2_L_SRC);
-    const u32 comb3_src = RevbGetIndexer(R ? RevBuffers.COMB3_R_SRC : RevBuffers.COMB3_L_SRC);
-    const u32 comb4_src = RevbGetIndexer(R ? RevBuffers.COMB4_R_SRC : RevBuffers.COMB4_L_SRC);
-
-    const u32 apf1_src = RevbGetIndexer(R ? RevBuffers.APF1_R_SRC : RevBuffers.APF1_L_SRC);
-    const u32 apf1_dst = RevbGetIndexer(R ? RevBuffers.APF1_R_DST : RevBuffers.APF1_L_DST);
-    const u32 apf2_src = RevbGetIndexer(R ? RevBuffers.APF2_R_SRC : RevBuffers.APF2_L_SRC);
-    const u32 apf2_dst = RevbGetIndexer(R ? RevBuffers.APF2_R_DST : RevBuffers.APF2_L_DST);
+    __aligned16 u32 addr[RevbTap_Padded];
+    RevbGetIndexers(addr, R);
 
     // -----------------------------------------
     //          Optimized IRQ Testing !
@@ -86,15 +82,12 @@ StereoOut32 V_Core::DoReverb(const StereoOut32 &Input)
 
     for (int i = 0; i < 2; i++) {
         if (Cores[i].IRQEnable && ((Cores[i].IRQA >= EffectsStartA) && (Cores[i].IRQA <= EffectsEndA))) {
-            if ((Cores[i].IRQA == same_src) || (Cores[i].IRQA == diff_src) ||
-                (Cores[i].IRQA == same_dst) || (Cores[i].IRQA == diff_dst) ||
-                (Cores[i].IRQA == same_prv) || (Cores[i].IRQA == diff_prv) ||
+            const __m128i irqa = _mm_set1_epi32(Cores[i].IRQA);
+            __m128i hit = _mm_setzero_si128();
+            for (int j = 0; j < RevbTap_Padded; j += 4)
+                hit = _mm_or_si128(hit, _mm_cmpeq_epi32(irqa, _mm_load_si128((const __m128i *)&addr[j])));
 
-                (Cores[i].IRQA == comb1_src) || (Cores[i].IRQA == comb2_src) ||
-                (Cores[i].IRQA == comb3_src) || (Cores[i].IRQA == comb4_src) ||
-
-                (Cores[i].IRQA == apf1_dst) || (Cores[i].IRQA == apf1_src) ||
-                (Cores[i].IRQA == apf2_dst) || (Cores[i].IRQA == apf2_src)) {
+            if (_mm_movemask_epi8(hit)) {
                 //printf("Core %d IRQ Called (Reverb). IRQA = %x\n",i,addr);
                 SetIrqCall(i);
             }
@@ -104,11 +97,204 @@ StereoOut32 V_Core::DoReverb(const StereoOut32 &Input)
     // Reverb algorithm pretty much directly ripped from http://drhell.web.fc2.com/ps1/
     // minus the 35 step FIR which just seems to break things.
 
+    const s32 same_prv = _spu2mem[addr[RevbTap_SamePrv]];
+    const s32 diff_prv = _spu2mem[addr[RevbTap_DiffPrv]];
+    const s32 apf1_src = _spu2mem[addr[RevbTap_Apf1Src]];
+    const s32 apf2_src = _spu2mem[addr[RevbTap_Apf2Src]];
+
     s32 in, same, diff, apf1, apf2, out;
 
 #define MUL(x, y) ((x) * (y) >> 15)
     in = MUL(R ? Revb.IN_COEF_R : Revb.IN_COEF_L, R ? Input.Right : Input.Left);
 
+    same = MUL(Revb.IIR_VOL, in + MUL(Revb.WALL_VOL, _spu2mem[addr[RevbTap_SameSrc]]) - same_prv) + same_prv;
+    diff = MUL(Revb.IIR_VOL, in + MUL(Revb.WALL_VOL, _spu2mem[addr[RevbTap_DiffSrc]]) - diff_prv) + diff_prv;
+
+    out = MUL(Revb.COMB1_VOL, _spu2mem[addr[RevbTap_Comb1Src]]) + MUL(Revb.COMB2_VOL, _spu2mem[addr[RevbTap_Comb2Src]]) +
+          MUL(Revb.COMB3_VOL, _spu2mem[addr[RevbTap_Comb3Src]]) + MUL(Revb.COMB4_VOL, _spu2mem[addr[RevbTap_Comb4Src]]);
+
+    apf1 = out - MUL(Revb.APF1_VOL, apf1_src);
+    out = apf1_src + MUL(Revb.APF1_VOL, apf1);
+    apf2 = out - MUL(Revb.APF2_VOL, apf2_src);
+    out = apf2_src + MUL(Revb.APF2_VOL, apf2);
+
+    // According to no$psx the effects always run but don't always write back, see check in V_Core::Mix
+    if (FxEnable) {
+        _spu2mem[addr[RevbTap_SameDst]] = clamp_mix(same);
+        _spu2mem[addr[RevbTap_DiffDst]] = clamp_mix(diff);
+        _spu2mem[addr[RevbTap_Apf1Dst]] = clamp_mix(apf1);
+        _spu2mem[addr[RevbTap_Apf2Dst]] = clamp_mix(apf2);
+
+        pcm_InvalidateBlock(addr[RevbTap_SameDst]);
+        pcm_InvalidateBlock(addr[RevbTap_DiffDst]);
+        pcm_InvalidateBlock(addr[RevbTap_Apf1Dst]);
+        pcm_InvalidateBlock(addr[RevbTap_Apf2Dst]);
+    }
+
+    (R ? LastEffect.Right : LastEffect.Left) = -clamp_mix(out);
+
+    return LastEffect;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+// Reverb check of the headless replay (see s2r_replay_headless)
+//
+// This is the scalar reverb from before the SSE2 tap addressing, with its own named tap
+// offsets rebuilt along with the effects buffer and wrapped one at a time.  It runs ahead
+// of DoReverb on the same state, without side effects, and every address, IRQ test,
+// effects area write and output that DoReverb gets differently is reported.
+
+struct V_ReverbReference
+{
+    bool Valid;
+
+    s32 SAME_L_SRC;
+    s32 SAME_R_SRC;
+    s32 DIFF_R_SRC;
+    s32 DIFF_L_SRC;
+    s32 SAME_L_DST;
+    s32 SAME_R_DST;
+    s32 DIFF_L_DST;
+    s32 DIFF_R_DST;
+
+    s32 COMB1_L_SRC;
+    s32 COMB1_R_SRC;
+    s32 COMB2_L_SRC;
+    s32 COMB2_R_SRC;
+    s32 COMB3_L_SRC;
+    s32 COMB3_R_SRC;
+    s32 COMB4_L_SRC;
+    s32 COMB4_R_SRC;
+
+    s32 APF1_L_DST;
+    s32 APF1_R_DST;
+    s32 APF2_L_DST;
+    s32 APF2_R_DST;
+
+    s32 SAME_L_PRV;
+    s32 SAME_R_PRV;
+    s32 DIFF_L_PRV;
+    s32 DIFF_R_PRV;
+
+    s32 APF1_L_SRC;
+    s32 APF1_R_SRC;
+    s32 APF2_L_SRC;
+    s32 APF2_R_SRC;
+};
+
+// What the scalar reverb does for one sample
+struct V_ReverbReferenceSample
+{
+    u32 addr[RevbTap_Count];
+    bool irq[2];
+    s32 dst[4]; // same, diff, apf1, apf2, already clamped
+    s32 out;
+};
+
+static V_ReverbReference RevbRef[2];
+
+extern bool has_to_call_irq;
+
+static const char *const RevbTapNames[RevbTap_Count] = {
+    "same_src", "diff_src", "apf1_src", "apf2_src", "comb1_src", "comb2_src", "comb3_src", "comb4_src",
+    "same_prv", "diff_prv", "same_dst", "diff_dst", "apf1_dst", "apf2_dst",
+};
+
+void V_Core::Reverb_UpdateReference()
+{
+    V_ReverbReference &ref = RevbRef[Index];
+
+    ref.COMB1_L_SRC = EffectsBufferIndexer(Revb.COMB1_L_SRC);
+    ref.COMB1_R_SRC = EffectsBufferIndexer(Revb.COMB1_R_SRC);
+    ref.COMB2_L_SRC = EffectsBufferIndexer(Revb.COMB2_L_SRC);
+    ref.COMB2_R_SRC = EffectsBufferIndexer(Revb.COMB2_R_SRC);
+    ref.COMB3_L_SRC = EffectsBufferIndexer(Revb.COMB3_L_SRC);
+    ref.COMB3_R_SRC = EffectsBufferIndexer(Revb.COMB3_R_SRC);
+    ref.COMB4_L_SRC = EffectsBufferIndexer(Revb.COMB4_L_SRC);
+    ref.COMB4_R_SRC = EffectsBufferIndexer(Revb.COMB4_R_SRC);
+
+    ref.SAME_L_DST = EffectsBufferIndexer(Revb.SAME_L_DST);
+    ref.SAME_R_DST = EffectsBufferIndexer(Revb.SAME_R_DST);
+    ref.DIFF_L_DST = EffectsBufferIndexer(Revb.DIFF_L_DST);
+    ref.DIFF_R_DST = EffectsBufferIndexer(Revb.DIFF_R_DST);
+
+    ref.SAME_L_SRC = EffectsBufferIndexer(Revb.SAME_L_SRC);
+    ref.SAME_R_SRC = EffectsBufferIndexer(Revb.SAME_R_SRC);
+    ref.DIFF_L_SRC = EffectsBufferIndexer(Revb.DIFF_L_SRC);
+    ref.DIFF_R_SRC = EffectsBufferIndexer(Revb.DIFF_R_SRC);
+
+    ref.APF1_L_DST = EffectsBufferIndexer(Revb.APF1_L_DST);
+    ref.APF1_R_DST = EffectsBufferIndexer(Revb.APF1_R_DST);
+    ref.APF2_L_DST = EffectsBufferIndexer(Revb.APF2_L_DST);
+    ref.APF2_R_DST = EffectsBufferIndexer(Revb.APF2_R_DST);
+
+    ref.SAME_L_PRV = EffectsBufferIndexer(Revb.SAME_L_DST - 1);
+    ref.SAME_R_PRV = EffectsBufferIndexer(Revb.SAME_R_DST - 1);
+    ref.DIFF_L_PRV = EffectsBufferIndexer(Revb.DIFF_L_DST - 1);
+    ref.DIFF_R_PRV = EffectsBufferIndexer(Revb.DIFF_R_DST - 1);
+
+    ref.APF1_L_SRC = EffectsBufferIndexer(Revb.APF1_L_DST - Revb.APF1_SIZE);
+    ref.APF1_R_SRC = EffectsBufferIndexer(Revb.APF1_R_DST - Revb.APF1_SIZE);
+    ref.APF2_L_SRC = EffectsBufferIndexer(Revb.APF2_L_DST - Revb.APF2_SIZE);
+    ref.APF2_R_SRC = EffectsBufferIndexer(Revb.APF2_R_DST - Revb.APF2_SIZE);
+
+    ref.Valid = true;
+}
+
+static u32 RevbRefIndexer(const V_Core &core, s32 offset)
+{
+    u32 pos = core.ReverbX + offset;
+
+    if (pos > core.EffectsEndA) {
+        pos -= core.EffectsEndA + 1;
+        pos += core.EffectsStartA;
+    }
+
+    return pos;
+}
+
+static void DoReverbReference(const V_Core &core, const StereoOut32 &Input, V_ReverbReferenceSample &smp)
+{
+    const V_ReverbReference &ref = RevbRef[core.Index];
+    const V_Reverb &Revb = core.Revb;
+    bool R = Cycles & 1;
+
+    const u32 same_src = RevbRefIndexer(core, R ? ref.SAME_R_SRC : ref.SAME_L_SRC);
+    const u32 same_dst = RevbRefIndexer(core, R ? ref.SAME_R_DST : ref.SAME_L_DST);
+    const u32 same_prv = RevbRefIndexer(core, R ? ref.SAME_R_PRV : ref.SAME_L_PRV);
+
+    const u32 diff_src = RevbRefIndexer(core, R ? ref.DIFF_L_SRC : ref.DIFF_R_SRC);
+    const u32 diff_dst = RevbRefIndexer(core, R ? ref.DIFF_R_DST : ref.DIFF_L_DST);
+    const u32 diff_prv = RevbRefIndexer(core, R ? ref.DIFF_R_PRV : ref.DIFF_L_PRV);
+
+    const u32 comb1_src = RevbRefIndexer(core, R ? ref.COMB1_R_SRC : ref.COMB1_L_SRC);
+    const u32 comb2_src = RevbRefIndexer(core, R ? ref.COMB2_R_SRC : ref.COMB2_L_SRC);
+    const u32 comb3_src = RevbRefIndexer(core, R ? ref.COMB3_R_SRC : ref.COMB3_L_SRC);
+    const u32 comb4_src = RevbRefIndexer(core, R ? ref.COMB4_R_SRC : ref.COMB4_L_SRC);
+
+    const u32 apf1_src = RevbRefIndexer(core, R ? ref.APF1_R_SRC : ref.APF1_L_SRC);
+    const u32 apf1_dst = RevbRefIndexer(core, R ? ref.APF1_R_DST : ref.APF1_L_DST);
+    const u32 apf2_src = RevbRefIndexer(core, R ? ref.APF2_R_SRC : ref.APF2_L_SRC);
+    const u32 apf2_dst = RevbRefIndexer(core, R ? ref.APF2_R_DST : ref.APF2_L_DST);
+
+    const u32 addr[RevbTap_Count] = {
+        same_src, diff_src, apf1_src, apf2_src, comb1_src, comb2_src, comb3_src, comb4_src,
+        same_prv, diff_prv, same_dst, diff_dst, apf1_dst, apf2_dst,
+    };
+    memcpy(smp.addr, addr, sizeof(addr));
+
+    for (int i = 0; i < 2; i++) {
+        smp.irq[i] = false;
+        if (Cores[i].IRQEnable && ((Cores[i].IRQA >= core.EffectsStartA) && (Cores[i].IRQA <= core.EffectsEndA))) {
+            for (int j = 0; j < RevbTap_Count; j++)
+                smp.irq[i] |= (Cores[i].IRQA == addr[j]);
+        }
+    }
+
+    s32 in, same, diff, apf1, apf2, out;
+
+    in = MUL(R ? Revb.IN_COEF_R : Revb.IN_COEF_L, R ? Input.Right : Input.Left);
+
     same = MUL(Revb.IIR_VOL, in + MUL(Revb.WALL_VOL, _spu2mem[same_src]) - _spu2mem[same_prv]) + _spu2mem[same_prv];
     diff = MUL(Revb.IIR_VOL, in + MUL(Revb.WALL_VOL, _spu2mem[diff_src]) - _spu2mem[diff_prv]) + _spu2mem[diff_prv];
 
@@ -119,15 +305,75 @@ StereoOut32 V_Core::DoReverb(const StereoOut32 &Input)
     apf2 = out - MUL(Revb.APF2_VOL, _spu2mem[apf2_src]);
     out = _spu2mem[apf2_src] + MUL(Revb.APF2_VOL, apf2);
 
-    // According to no$psx the effects always run but don't always write back, see check in V_Core::Mix
+    smp.dst[0] = clamp_mix(same);
+    smp.dst[1] = clamp_mix(diff);
+    smp.dst[2] = clamp_mix(apf1);
+    smp.dst[3] = clamp_mix(apf2);
+    smp.out = -clamp_mix(out);
+}
+
+static bool RevbCheck(int core, const char *what, s32 expected, s32 actual)
+{
+    if (expected == actual)
+        return true;
+
+    s2r_reverbmismatch(core, what, expected, actual);
+    return false;
+}
+
+StereoOut32 V_Core::DoReverbChecked(const StereoOut32 &Input)
+{
+    if (EffectsBufferSize <= 0 || !RevbRef[Index].Valid)
+        return DoReverb(Input);
+
+    const bool R = Cycles & 1;
+
+    V_ReverbReferenceSample ref;
+    DoReverbReference(*this, Input, ref);
+
+    // The addresses DoReverb is about to use
+    __aligned16 u32 addr[RevbTap_Padded];
+    RevbGetIndexers(addr, R);
+
+    // SetIrqCall ignores a core whose IRQ is already pending, so clear those to see which
+    // IRQs DoReverb raises, then put back what SetIrqCall would have left.
+    const u16 info = Spdif.Info;
+    const bool call_irq = has_to_call_irq;
+    Spdif.Info &= ~(4 << 0 | 4 << 1);
+
+    const StereoOut32 result = DoReverb(Input);
+
+    bool irq[2];
+    bool new_irq = false;
+    for (int i = 0; i < 2; i++) {
+        irq[i] = (Spdif.Info & 4 << i) != 0;
+        new_irq |= irq[i] && !(info & 4 << i);
+    }
+    Spdif.Info |= info;
+    has_to_call_irq = call_irq || new_irq;
+
+    bool match = true;
+    for (int i = 0; i < RevbTap_Count; i++)
+        match &= RevbCheck(Index, RevbTapNames[i], ref.addr[i], addr[i]);
+
+    match &= RevbCheck(Index, "irq of core 0", ref.irq[0], irq[0]);
+    match &= RevbCheck(Index, "irq of core 1", ref.irq[1], irq[1]);
+
+    // Compared where the scalar code wrote, in its order, so aliased taps keep the last write
     if (FxEnable) {
-        _spu2mem[same_dst] = clamp_mix(same);
-        _spu2mem[diff_dst] = clamp_mix(diff);
-        _spu2mem[apf1_dst] = clamp_mix(apf1);
-        _spu2mem[apf2_dst] = clamp_mix(apf2);
+        static const int dsttaps[4] = {RevbTap_SameDst, RevbTap_DiffDst, RevbTap_Apf1Dst, RevbTap_Apf2Dst};
+        for (int i = 0; i < 4; i++) {
+            s32 expected = ref.dst[i];
+            for (int j = i + 1; j < 4; j++) {
+                if (ref.addr[dsttaps[j]] == ref.addr[dsttaps[i]])
+                    expected = ref.dst[j];
+            }
+            match &= RevbCheck(Index, RevbTapNames[dsttaps[i]], expected, _spu2mem[ref.addr[dsttaps[i]]]);
+        }
     }
 
-    (R ? LastEffect.Right : LastEffect.Left) = -clamp_mix(out);
+    match &= RevbCheck(Index, R ? "output right" : "output left", ref.out, R ? result.Right : result.Left);
 
-    return LastEffect;
+    s2r_reverbsample(match);
+    return result;
 }
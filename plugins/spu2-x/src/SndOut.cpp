@@ -16,6 +16,7 @@
  */
 
 #include "Global.h"
+#include "Spu2replay.h"
 
 
 StereoOut32 StereoOut32::Empty(0, 0);
@@ -429,6 +430,9 @@ void SndBuffer::Write(const StereoOut32 &Sample)
     if (WavRecordEnabled)
         RecordWrite(Sample.DownSample());
 
+    if (replay_mode)
+        s2r_output(Sample.DownSample());
+
     if (mods[OutputModule] == &NullOut) // null output doesn't need buffering or stretching! :p
         return;
 
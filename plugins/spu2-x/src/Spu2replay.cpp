@@ -18,6 +18,13 @@
 
 #include "Global.h"
 #include "PS2E-spu2.h"
+#include "Utilities/General.h"
+
+#ifdef __POSIX__
+#include "WavFile.h"
+#else
+#include "soundtouch/source/SoundStretch/WavFile.h"
+#endif
 
 #ifdef _MSC_VER
 #include "Windows.h"
@@ -113,6 +120,20 @@ double HighResScale;
 
 bool Running = false;
 
+void dummy1()
+{
+}
+
+void dummy4()
+{
+    SPU2interruptDMA4();
+}
+
+void dummy7()
+{
+    SPU2interruptDMA7();
+}
+
 #ifdef _MSC_VER
 
 int conprintf(const char *fmt, ...)
@@ -143,20 +164,6 @@ int conprintf(const char *fmt, ...)
 #endif
 }
 
-void dummy1()
-{
-}
-
-void dummy4()
-{
-    SPU2interruptDMA4();
-}
-
-void dummy7()
-{
-    SPU2interruptDMA7();
-}
-
 u64 HighResFrequency()
 {
     u64 freq;
@@ -319,3 +326,187 @@ Finish:
     replay_mode = false;
 }
 #endif
+
+///////////////////////////////////////////////////////////////
+// headless replay
+
+static bool s2r_headless = false;
+static u64 s2r_samples;
+static u64 s2r_checksum; // FNV-1a of the 16 bit output
+static WavOutFile *s2r_wav = NULL;
+
+bool s2r_reverbcheck = false;
+static u64 s2r_reverbsamples;
+static u64 s2r_reverbmismatches; // samples with at least one difference
+static u32 s2r_reverbreports;
+static const u32 MaxReverbReports = 20;
+
+void s2r_output(const StereoOut16 &sample)
+{
+    if (!s2r_headless)
+        return;
+
+    const s16 pcm[2] = {sample.Left, sample.Right};
+    const u8 *bytes = (const u8 *)pcm;
+    for (uint i = 0; i < sizeof(pcm); i++)
+        s2r_checksum = (s2r_checksum ^ bytes[i]) * 0x100000001b3ull;
+
+    s2r_samples++;
+
+    if (s2r_wav)
+        s2r_wav->write(pcm, 2);
+}
+
+void s2r_reverbmismatch(int core, const char *what, s32 expected, s32 actual)
+{
+    if (s2r_reverbreports++ < MaxReverbReports)
+        fprintf(stderr, "Reverb mismatch on core %d at sample %llu: %s is %d (0x%x), the scalar reverb has %d (0x%x)\n",
+                core, (unsigned long long)s2r_samples, what, actual, actual, expected, expected);
+}
+
+void s2r_reverbsample(bool match)
+{
+    s2r_reverbsamples++;
+    if (!match)
+        s2r_reverbmismatches++;
+}
+
+// Plays a .s2r file as fast as possible on the null output module, whatever the ini says,
+// then prints the mixing speed and a checksum of the mixed output, which only depends on
+// the file and on the mixing settings (interpolation, effects, volume).  The output is also
+// written to wavfile, unless it's NULL.
+//
+// With reverbcheck, every reverb sample is also computed by the scalar reverb and compared
+// with DoReverb (see V_Core::DoReverbChecked); any difference makes the replay fail.
+EXPORT_C_(s32)
+s2r_replay_headless(const char *filename, const char *wavfile, s32 reverbcheck)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Could not open the replay file %s.\n", filename);
+        return -1;
+    }
+
+    u32 startCycle;
+    if (fread(&startCycle, 4, 1, file) < 1) {
+        fprintf(stderr, "Error reading from %s.\n", filename);
+        fclose(file);
+        return -1;
+    }
+
+    replay_mode = true;
+
+    // Before SPU2init, which builds the reverb taps of both cores
+    s2r_reverbcheck = reverbcheck != 0;
+    s2r_reverbsamples = 0;
+    s2r_reverbmismatches = 0;
+    s2r_reverbreports = 0;
+
+    SPU2init();
+    OutputModule = FindOutputModuleById(L"nullout");
+    SPU2irqCallback(dummy1, dummy4, dummy7);
+    SPU2setClockPtr(&CurrentIOPCycle);
+    CurrentIOPCycle = 0;
+
+    if (SPU2open(NULL) != 0) {
+        SPU2shutdown();
+        fclose(file);
+        replay_mode = false;
+        s2r_reverbcheck = false;
+        return -1;
+    }
+
+    s2r_samples = 0;
+    s2r_checksum = 0xcbf29ce484222325ull;
+    if (wavfile) {
+        try {
+            s2r_wav = new WavOutFile(wavfile, 48000, 16, 2);
+        } catch (std::runtime_error &ex) {
+            fprintf(stderr, "Could not write %s: %s.\n", wavfile, ex.what());
+        }
+    }
+    s2r_headless = true;
+
+    int events = 0;
+    bool error = false;
+    const u64 start = GetCPUTicks();
+
+    SPU2async(0);
+
+    while (!error) {
+        u32 ccycle = 0;
+        u32 sval = 0;
+        u32 tval = 0;
+
+        if (fread(&ccycle, 4, 1, file) < 1 || fread(&sval, 4, 1, file) < 1)
+            break;
+
+        const u32 evid = sval >> 29;
+        sval &= 0x1FFFFFFF;
+
+        // Catch up in steps well below the TimeUpdate sanity check, which would skip ticks
+        const u32 TargetCycle = ccycle * 768;
+        while ((s32)(TargetCycle - CurrentIOPCycle) > 0) {
+            CurrentIOPCycle += std::min(TargetCycle - CurrentIOPCycle, IOPCiclesPerMS * 10);
+            SPU2async(0);
+        }
+
+        switch (evid) {
+            case 0:
+                SPU2read(sval);
+                break;
+            case 1:
+                error = fread(&tval, 2, 1, file) < 1;
+                if (!error)
+                    SPU2write(sval, tval);
+                break;
+            case 2:
+            case 3:
+                error = sval > ArraySize(dmabuffer) || fread(dmabuffer, 2, sval, file) < sval;
+                if (!error) {
+                    if (evid == 2)
+                        SPU2writeDMA4Mem(dmabuffer, sval);
+                    else
+                        SPU2writeDMA7Mem(dmabuffer, sval);
+                }
+                break;
+            default:
+                error = true;
+                break;
+        }
+        events++;
+    }
+
+    // Closing waits for the mixing thread, if enabled
+    SPU2close();
+    const u64 ticks = GetCPUTicks() - start;
+
+    s2r_headless = false;
+    safe_delete(s2r_wav);
+    SPU2shutdown();
+    fclose(file);
+    replay_mode = false;
+    s2r_reverbcheck = false;
+
+    if (error)
+        fprintf(stderr, "Error reading from %s after %d events.\n", filename, events);
+
+    const double seconds = (double)ticks / GetTickFrequency();
+    printf("SPU2-X replay of %s: %d events, %llu samples (%.2f s of audio) mixed in %.3f s\n",
+           filename, events, (unsigned long long)s2r_samples, s2r_samples / 48000.0, seconds);
+    printf("%.0f samples/s, %.1fx realtime\n",
+           s2r_samples / seconds, s2r_samples / 48000.0 / seconds);
+    printf("Output checksum: %016llx\n", (unsigned long long)s2r_checksum);
+    printf("ADPCM cache: %llu hits, %llu misses, %llu ignores\n",
+           (unsigned long long)g_counter_cache_hits, (unsigned long long)g_counter_cache_misses,
+           (unsigned long long)g_counter_cache_ignores);
+
+    if (reverbcheck) {
+        printf("Reverb check: %llu samples, %llu differ from the scalar reverb\n",
+               (unsigned long long)s2r_reverbsamples, (unsigned long long)s2r_reverbmismatches);
+        if (s2r_reverbmismatches)
+            error = true;
+    }
+
+    return error ? -1 : 0;
+}
@@ -29,3 +29,11 @@ void s2r_writedma7(u32 ticks, u16 *data, u32 len);
 void s2r_close();
 
 extern bool replay_mode;
+
+// output of a headless replay
+void s2r_output(const StereoOut16 &sample);
+
+// reverb check of a headless replay (see V_Core::DoReverbChecked)
+extern bool s2r_reverbcheck;
+void s2r_reverbmismatch(int core, const char *what, s32 expected, s32 actual);
+void s2r_reverbsample(bool match);
@@ -39,6 +39,7 @@ int Interpolation = 4;
 */
 
 bool EffectsDisabled = false;
+bool MixingThread = false;
 
 float FinalVolume; // Global
 bool AdvancedVolumeControl;
@@ -88,6 +89,7 @@ void ReadSettings()
     Interpolation = CfgReadInt(L"MIXING", L"Interpolation", 4);
 
     EffectsDisabled = CfgReadBool(L"MIXING", L"Disable_Effects", false);
+    MixingThread = CfgReadBool(L"MIXING", L"Mixing_Thread", false);
     postprocess_filter_dealias = CfgReadBool(L"MIXING", L"DealiasFilter", false);
     FinalVolume = ((float)CfgReadInt(L"MIXING", L"FinalVolume", 100)) / 100;
     if (FinalVolume > 1.0f)
@@ -167,6 +169,7 @@ void WriteSettings()
     CfgWriteInt(L"MIXING", L"Interpolation", Interpolation);
 
     CfgWriteBool(L"MIXING", L"Disable_Effects", EffectsDisabled);
+    CfgWriteBool(L"MIXING", L"Mixing_Thread", MixingThread);
     CfgWriteBool(L"MIXING", L"DealiasFilter", postprocess_filter_dealias);
     CfgWriteInt(L"MIXING", L"FinalVolume", (int)(FinalVolume * 100 + 0.5f));
 
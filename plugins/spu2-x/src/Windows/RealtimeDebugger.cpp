@@ -130,21 +130,20 @@ void UpdateDebugDialog()
                 FillRectangle(hdc, IX + 70, IY + 42 - peak, 4, peak);
 
                 if (vc.ADSR.Value > 0) {
-                    if (vc.SBuffer)
-                        for (int i = 0; i < 28; i++) {
-                            int val = ((int)vc.SBuffer[i] * 20) / 32768;
+                    for (int i = 0; i < 28; i++) {
+                        int val = ((int)vc.SBuffer[i] * 20) / 32768;
 
-                            int y = 0;
+                        int y = 0;
 
-                            if (val > 0) {
-                                y = val;
-                            } else
-                                val = -val;
+                        if (val > 0) {
+                            y = val;
+                        } else
+                            val = -val;
 
-                            if (val != 0) {
-                                FillRectangle(hdc, IX + 90 + i, IY + 24 - y, 1, val);
-                            }
+                        if (val != 0) {
+                            FillRectangle(hdc, IX + 90 + i, IY + 24 - y, 1, val);
                         }
+                    }
                 }
 
                 SetTextColor(hdc, RGB(0, 255, 0));
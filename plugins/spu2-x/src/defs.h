@@ -183,8 +183,8 @@ struct V_Voice
     s32 OutX;
     s32 NextCrest; // temp value for Crest calculation
 
-    // SBuffer now points directly to an ADPCM cache entry.
-    s16 *SBuffer;
+    // Decoded samples of the current block, copied from the ADPCM cache or decoded into.
+    s16 SBuffer[28];
 
     // sample position within the current decoded packet.
     s32 SCurrent;
@@ -267,40 +267,34 @@ struct V_Reverb
     u32 APF2_R_DST;
 };
 
+// Reverb taps, in the order of V_ReverbBuffers::Taps
+enum V_ReverbTap
+{
+    RevbTap_SameSrc,
+    RevbTap_DiffSrc,
+    RevbTap_Apf1Src,
+    RevbTap_Apf2Src,
+    RevbTap_Comb1Src,
+    RevbTap_Comb2Src,
+    RevbTap_Comb3Src,
+    RevbTap_Comb4Src,
+
+    RevbTap_SamePrv,
+    RevbTap_DiffPrv,
+    RevbTap_SameDst,
+    RevbTap_DiffDst,
+    RevbTap_Apf1Dst,
+    RevbTap_Apf2Dst,
+
+    RevbTap_Count,
+    RevbTap_Padded = 16 // a whole number of SSE vectors
+};
+
 struct V_ReverbBuffers
 {
-    s32 SAME_L_SRC;
-    s32 SAME_R_SRC;
-    s32 DIFF_R_SRC;
-    s32 DIFF_L_SRC;
-    s32 SAME_L_DST;
-    s32 SAME_R_DST;
-    s32 DIFF_L_DST;
-    s32 DIFF_R_DST;
-
-    s32 COMB1_L_SRC;
-    s32 COMB1_R_SRC;
-    s32 COMB2_L_SRC;
-    s32 COMB2_R_SRC;
-    s32 COMB3_L_SRC;
-    s32 COMB3_R_SRC;
-    s32 COMB4_L_SRC;
-    s32 COMB4_R_SRC;
-
-    s32 APF1_L_DST;
-    s32 APF1_R_DST;
-    s32 APF2_L_DST;
-    s32 APF2_R_DST;
-
-    s32 SAME_L_PRV;
-    s32 SAME_R_PRV;
-    s32 DIFF_L_PRV;
-    s32 DIFF_R_PRV;
-
-    s32 APF1_L_SRC;
-    s32 APF1_R_SRC;
-    s32 APF2_L_SRC;
-    s32 APF2_R_SRC;
+    // Effects area addresses of the taps when ReverbX is 0, for the left and the right
+    // samples.  The padding repeats the first tap.
+    s32 Taps[2][RevbTap_Padded];
 
     bool NeedsUpdated;
 };
@@ -481,7 +475,9 @@ struct V_Core
     StereoOut32 Mix(const VoiceMixSet &inVoices, const StereoOut32 &Input, const StereoOut32 &Ext);
     void Reverb_AdvanceBuffer();
     StereoOut32 DoReverb(const StereoOut32 &Input);
-    s32 RevbGetIndexer(s32 offset);
+    void RevbGetIndexers(u32 *addr, bool R);
+    StereoOut32 DoReverbChecked(const StereoOut32 &Input);
+    void Reverb_UpdateReference();
 
     StereoOut32 ReadInput();
     StereoOut32 ReadInput_HiFi();
@@ -567,23 +563,46 @@ extern s32 __fastcall SizeIt();
 // --------------------------------------------------------------------------------------
 
 // The SPU2 has a dynamic memory range which is used for several internal operations, such as
-// registers, CORE 1/2 mixing, AutoDMAs, and some other fancy stuff.  We exclude this range
-// from the cache here:
+// registers, CORE 1/2 mixing, AutoDMAs, and some other fancy stuff.  The mixer writes it on
+// every tick (see spu2M_WriteFast):
 static const s32 SPU2_DYN_MEMLINE = 0x2800;
 
 // 8 short words per encoded PCM block. (as stored in SPU2 ram)
 static const int pcm_WordsPerBlock = 8;
 
-// number of cachable ADPCM blocks (any blocks above the SPU2_DYN_MEMLINE)
+// number of ADPCM blocks in SPU2 ram
 static const int pcm_BlockCount = 0x100000 / pcm_WordsPerBlock;
 
 // 28 samples per decoded PCM block (as stored in our cache)
 static const int pcm_DecodedSamplesPerBlock = 28;
 
+// number of decoded blocks kept in the cache (64 bytes each, 512KB in all)
+static const int pcm_CacheEntries = 0x2000;
+
 struct PcmCacheEntry
 {
-    bool Validated;
+    u32 Block; // index of the cached block, or pcm_BlockCount if unused
+    u32 Gen;   // pcm_BlockGen of the block when it was decoded
     s16 Sampledata[pcm_DecodedSamplesPerBlock];
 };
 
 extern PcmCacheEntry *pcm_cache_data;
+
+// Write generation of every block of SPU2 ram.  Anything writing to SPU2 ram bumps the
+// generation of the blocks written, which invalidates their cached decode.
+extern u32 *pcm_BlockGen;
+
+extern u64 g_counter_cache_hits;
+extern u64 g_counter_cache_misses;
+extern u64 g_counter_cache_ignores;
+
+static __forceinline void pcm_InvalidateBlock(u32 addr)
+{
+    pcm_BlockGen[addr / pcm_WordsPerBlock]++;
+}
+
+// Invalidates the blocks from addr up to (not including) end, in words
+extern void pcm_InvalidateRange(u32 addr, u32 end);
+
+// Empties the cache, when all of SPU2 ram is replaced
+extern void pcm_ResetCache();
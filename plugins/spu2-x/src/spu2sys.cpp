@@ -24,6 +24,7 @@
 
 #include "Global.h"
 #include "Dma.h"
+#include "MixThread.h"
 
 #include "PS2E-spu2.h" // needed until I figure out a nice solution for irqcallback dependencies.
 
@@ -77,13 +78,7 @@ __forceinline void spu2M_Write(u32 addr, s16 value)
     // (note to self : addr address WORDs, not bytes)
 
     addr &= 0xfffff;
-    if (addr >= SPU2_DYN_MEMLINE) {
-        const int cacheIdx = addr / pcm_WordsPerBlock;
-        pcm_cache_data[cacheIdx].Validated = false;
-
-        if (MsgToConsole() && MsgCache())
-            ConLog("* SPU2-X: PcmCache Block Clear at 0x%x (cacheIdx=0x%x)\n", addr, cacheIdx);
-    }
+    pcm_InvalidateBlock(addr);
     *GetMemPtr(addr) = value;
 }
 
@@ -289,39 +284,31 @@ void V_Core::UpdateEffectsBufferSize()
         AnalyzeReverbPreset();
 
     // Rebuild buffer indexers.
-    RevBuffers.COMB1_L_SRC = EffectsBufferIndexer(Revb.COMB1_L_SRC);
-    RevBuffers.COMB1_R_SRC = EffectsBufferIndexer(Revb.COMB1_R_SRC);
-    RevBuffers.COMB2_L_SRC = EffectsBufferIndexer(Revb.COMB2_L_SRC);
-    RevBuffers.COMB2_R_SRC = EffectsBufferIndexer(Revb.COMB2_R_SRC);
-    RevBuffers.COMB3_L_SRC = EffectsBufferIndexer(Revb.COMB3_L_SRC);
-    RevBuffers.COMB3_R_SRC = EffectsBufferIndexer(Revb.COMB3_R_SRC);
-    RevBuffers.COMB4_L_SRC = EffectsBufferIndexer(Revb.COMB4_L_SRC);
-    RevBuffers.COMB4_R_SRC = EffectsBufferIndexer(Revb.COMB4_R_SRC);
-
-    RevBuffers.SAME_L_DST = EffectsBufferIndexer(Revb.SAME_L_DST);
-    RevBuffers.SAME_R_DST = EffectsBufferIndexer(Revb.SAME_R_DST);
-    RevBuffers.DIFF_L_DST = EffectsBufferIndexer(Revb.DIFF_L_DST);
-    RevBuffers.DIFF_R_DST = EffectsBufferIndexer(Revb.DIFF_R_DST);
-
-    RevBuffers.SAME_L_SRC = EffectsBufferIndexer(Revb.SAME_L_SRC);
-    RevBuffers.SAME_R_SRC = EffectsBufferIndexer(Revb.SAME_R_SRC);
-    RevBuffers.DIFF_L_SRC = EffectsBufferIndexer(Revb.DIFF_L_SRC);
-    RevBuffers.DIFF_R_SRC = EffectsBufferIndexer(Revb.DIFF_R_SRC);
-
-    RevBuffers.APF1_L_DST = EffectsBufferIndexer(Revb.APF1_L_DST);
-    RevBuffers.APF1_R_DST = EffectsBufferIndexer(Revb.APF1_R_DST);
-    RevBuffers.APF2_L_DST = EffectsBufferIndexer(Revb.APF2_L_DST);
-    RevBuffers.APF2_R_DST = EffectsBufferIndexer(Revb.APF2_R_DST);
-
-    RevBuffers.SAME_L_PRV = EffectsBufferIndexer(Revb.SAME_L_DST - 1);
-    RevBuffers.SAME_R_PRV = EffectsBufferIndexer(Revb.SAME_R_DST - 1);
-    RevBuffers.DIFF_L_PRV = EffectsBufferIndexer(Revb.DIFF_L_DST - 1);
-    RevBuffers.DIFF_R_PRV = EffectsBufferIndexer(Revb.DIFF_R_DST - 1);
-
-    RevBuffers.APF1_L_SRC = EffectsBufferIndexer(Revb.APF1_L_DST - Revb.APF1_SIZE);
-    RevBuffers.APF1_R_SRC = EffectsBufferIndexer(Revb.APF1_R_DST - Revb.APF1_SIZE);
-    RevBuffers.APF2_L_SRC = EffectsBufferIndexer(Revb.APF2_L_DST - Revb.APF2_SIZE);
-    RevBuffers.APF2_R_SRC = EffectsBufferIndexer(Revb.APF2_R_DST - Revb.APF2_SIZE);
+    for (int R = 0; R < 2; R++) {
+        s32 *taps = RevBuffers.Taps[R];
+
+        taps[RevbTap_SameSrc] = EffectsBufferIndexer(R ? Revb.SAME_R_SRC : Revb.SAME_L_SRC);
+        taps[RevbTap_DiffSrc] = EffectsBufferIndexer(R ? Revb.DIFF_L_SRC : Revb.DIFF_R_SRC);
+        taps[RevbTap_Apf1Src] = EffectsBufferIndexer((R ? Revb.APF1_R_DST : Revb.APF1_L_DST) - Revb.APF1_SIZE);
+        taps[RevbTap_Apf2Src] = EffectsBufferIndexer((R ? Revb.APF2_R_DST : Revb.APF2_L_DST) - Revb.APF2_SIZE);
+        taps[RevbTap_Comb1Src] = EffectsBufferIndexer(R ? Revb.COMB1_R_SRC : Revb.COMB1_L_SRC);
+        taps[RevbTap_Comb2Src] = EffectsBufferIndexer(R ? Revb.COMB2_R_SRC : Revb.COMB2_L_SRC);
+        taps[RevbTap_Comb3Src] = EffectsBufferIndexer(R ? Revb.COMB3_R_SRC : Revb.COMB3_L_SRC);
+        taps[RevbTap_Comb4Src] = EffectsBufferIndexer(R ? Revb.COMB4_R_SRC : Revb.COMB4_L_SRC);
+
+        taps[RevbTap_SamePrv] = EffectsBufferIndexer((R ? Revb.SAME_R_DST : Revb.SAME_L_DST) - 1);
+        taps[RevbTap_DiffPrv] = EffectsBufferIndexer((R ? Revb.DIFF_R_DST : Revb.DIFF_L_DST) - 1);
+        taps[RevbTap_SameDst] = EffectsBufferIndexer(R ? Revb.SAME_R_DST : Revb.SAME_L_DST);
+        taps[RevbTap_DiffDst] = EffectsBufferIndexer(R ? Revb.DIFF_R_DST : Revb.DIFF_L_DST);
+        taps[RevbTap_Apf1Dst] = EffectsBufferIndexer(R ? Revb.APF1_R_DST : Revb.APF1_L_DST);
+        taps[RevbTap_Apf2Dst] = EffectsBufferIndexer(R ? Revb.APF2_R_DST : Revb.APF2_L_DST);
+
+        for (int i = RevbTap_Count; i < RevbTap_Padded; i++)
+            taps[i] = taps[0];
+    }
+
+    if (s2r_reverbcheck)
+        Reverb_UpdateReference();
 }
 
 void V_Voice::QueueStart()
@@ -366,6 +353,24 @@ void V_Voice::Stop()
     ADSR.Phase = 0;
 }
 
+// Mixes one tick, on the emulation thread or the mixing thread (see MixThread.h)
+void MixTick()
+{
+    Cycles++;
+
+    for (int i = 0; i < 2; i++)
+        if (Cores[i].KeyOn)
+            for (int j = 0; j < 24; j++)
+                if (Cores[i].KeyOn >> j & 1)
+                    if (Cores[i].Voices[j].Start())
+                        Cores[i].KeyOn &= ~(1 << j);
+
+    // Note: IOP does not use MMX regs, so no need to save them.
+    //SaveMMXRegs();
+    Mix();
+    //RestoreMMXRegs();
+}
+
 uint TickInterval = 768;
 static const int SanityInterval = 4800;
 extern void UpdateDebugDialog();
@@ -441,19 +446,9 @@ __forceinline void TimeUpdate(u32 cClocks)
 
         dClocks -= TickInterval;
         lClocks += TickInterval;
-        Cycles++;
-
-        for (int i = 0; i < 2; i++)
-            if (Cores[i].KeyOn)
-                for (int j = 0; j < 24; j++)
-                    if (Cores[i].KeyOn >> j & 1)
-                        if (Cores[i].Voices[j].Start())
-                            Cores[i].KeyOn &= ~(1 << j);
-
-        // Note: IOP does not use MMX regs, so no need to save them.
-        //SaveMMXRegs();
-        Mix();
-        //RestoreMMXRegs();
+
+        if (!MixThread::Tick())
+            MixTick();
     }
 }
 
@@ -46,10 +46,12 @@ Dialog::Dialog()
 
     effect_check = new wxCheckBox(this, wxID_ANY, "Disable Effects Processing (Speedup)");
     dealias_check = new wxCheckBox(this, wxID_ANY, "Use the de-alias filter (Overemphasizes the highs)");
+    thread_check = new wxCheckBox(this, wxID_ANY, "Mix on a separate thread (Speedup)");
 
     m_mix_box->Add(m_inter_select, wxSizerFlags().Centre());
     m_mix_box->Add(effect_check, wxSizerFlags().Centre());
     m_mix_box->Add(dealias_check, wxSizerFlags().Centre());
+    m_mix_box->Add(thread_check, wxSizerFlags().Centre());
 
     // Debug Settings
     debug_check = new wxCheckBox(this, wxID_ANY, "Enable Debug Options");
@@ -233,6 +235,7 @@ void Dialog::ResetToValues()
 
     effect_check->SetValue(EffectsDisabled);
     dealias_check->SetValue(postprocess_filter_dealias);
+    thread_check->SetValue(MixingThread);
     debug_check->SetValue(DebugEnabled);
 
     m_volume_slider->SetValue(FinalVolume * 100);
@@ -254,6 +257,7 @@ void Dialog::SaveValues()
 
     EffectsDisabled = effect_check->GetValue();
     postprocess_filter_dealias = dealias_check->GetValue();
+    MixingThread = thread_check->GetValue();
     DebugEnabled = debug_check->GetValue();
 
     FinalVolume = m_volume_slider->GetValue() / 100.0;
@@ -76,7 +76,7 @@ class Dialog : public wxDialog
     wxChoice *m_inter_select, *m_module_select, *m_portaudio_select, *m_sdl_select, *m_sync_select, *m_audio_select;
     wxStaticText *m_portaudio_text, *m_sdl_text;
 
-    wxCheckBox *effect_check, *dealias_check, *debug_check;
+    wxCheckBox *effect_check, *dealias_check, *thread_check, *debug_check;
     wxSlider *m_latency_slider, *m_volume_slider;
     wxButton *launch_debug_dialog, *launch_adv_dialog;
 